@@ -30,9 +30,14 @@ struct PageFaultInfo
 {
     uptr addr;
 
-    PageFaultInfo(uptr address)
+    // Instruction pointer of the faulting thread, or NULL when the platform doesn't provide
+    // it.  Listeners may change it to resume execution somewhere else.
+    uptr *pc;
+
+    PageFaultInfo(uptr address, uptr *context_pc = NULL)
     {
         addr = address;
+        pc = context_pc;
     }
 };
 
@@ -177,6 +177,15 @@ extern void DisableHiresScheduler();
 // sleeps the current thread for the given number of milliseconds.
 extern void Sleep(int ms);
 
+// Names the calling thread for debuggers and system tools (up to 15 characters on Linux).
+// Used for threads which aren't managed by pxThread.
+extern void SetNameOfCurrentThread(const char *name);
+
+// Restricts the calling thread to the given host cpu, or lets it run on any cpu again when
+// cpu is negative.  Only a hint: returns false when the platform doesn't support it or the
+// cpu doesn't exist.
+extern bool SetCurrentThreadAffinity(int cpu);
+
 // pthread Cond is an evil api that is not suited for Pcsx2 needs.
 // Let's not use it. Use mutexes and semaphores instead to create waits. (Air)
 #if 0
@@ -44,6 +44,12 @@ __forceinline void Threading::SpinWait()
     __asm__("pause");
 }
 
+bool Threading::SetCurrentThreadAffinity(int cpu)
+{
+    // OSX only has affinity tags (threads sharing a L2), there is no way to pin a thread.
+    return false;
+}
+
 __forceinline void Threading::EnableHiresScheduler()
 {
     // Darwin has customizable schedulers, see xnu/osfmk/man. Not
@@ -126,7 +132,7 @@ void Threading::pxThread::_platform_specific_OnCleanupInThread()
 }
 
 // name can be up to 16 bytes
-void Threading::pxThread::_DoSetThreadName(const char *name)
+void Threading::SetNameOfCurrentThread(const char *name)
 {
     pthread_setname_np(name);
 }
@@ -21,6 +21,7 @@
 
 #include <sys/mman.h>
 #include <signal.h>
+#include <ucontext.h>
 #include <errno.h>
 #include <unistd.h>
 
@@ -34,8 +35,20 @@ extern void SignalExit(int sig);
 
 static const uptr m_pagemask = getpagesize() - 1;
 
+// Instruction pointer saved in the signal context, which is where execution resumes.
+static uptr *GetContextPc(void *context)
+{
+#if defined(__linux__) && defined(__M_X86_64)
+    return (uptr *)&((ucontext_t *)context)->uc_mcontext.gregs[REG_RIP];
+#elif defined(__linux__)
+    return (uptr *)&((ucontext_t *)context)->uc_mcontext.gregs[REG_EIP];
+#else
+    return NULL;
+#endif
+}
+
 // Linux implementation of SIGSEGV handler.  Bind it using sigaction().
-static void SysPageFaultSignalFilter(int signal, siginfo_t *siginfo, void *)
+static void SysPageFaultSignalFilter(int signal, siginfo_t *siginfo, void *context)
 {
     // [TODO] : Add a thread ID filter to the Linux Signal handler here.
     // Rationale: On windows, the __try/__except model allows per-thread specific behavior
@@ -59,7 +72,7 @@ static void SysPageFaultSignalFilter(int signal, siginfo_t *siginfo, void *)
     // so for now we lock this exception code unless someone can fix this better...
     Threading::ScopedLock lock(PageFault_Mutex);
 
-    Source_PageFault->Dispatch(PageFaultInfo((uptr)siginfo->si_addr & ~m_pagemask));
+    Source_PageFault->Dispatch(PageFaultInfo((uptr)siginfo->si_addr & ~m_pagemask, GetContextPc(context)));
 
     // resumes execution right where we left off (re-executes instruction that
     // caused the SIGSEGV).
@@ -19,6 +19,7 @@
 #include <unistd.h>
 #if defined(__linux__)
 #include <sys/prctl.h>
+#include <sched.h>
 #elif defined(__unix__)
 #include <pthread_np.h>
 #endif
@@ -51,6 +52,28 @@ __forceinline void Threading::SpinWait()
     __asm__("pause");
 }
 
+bool Threading::SetCurrentThreadAffinity(int cpu)
+{
+#if defined(__linux__)
+    const int count = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpu >= count || cpu >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu < 0) {
+        for (int i = 0; i < count && i < CPU_SETSIZE; i++)
+            CPU_SET(i, &set);
+    } else {
+        CPU_SET(cpu, &set);
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
 __forceinline void Threading::EnableHiresScheduler()
 {
     // Don't know if linux has a customizable scheduler resolution like Windows (doubtful)
@@ -118,7 +141,7 @@ void Threading::pxThread::_platform_specific_OnCleanupInThread()
     // Cleanup handles here, which were opened above.
 }
 
-void Threading::pxThread::_DoSetThreadName(const char *name)
+void Threading::SetNameOfCurrentThread(const char *name)
 {
 #if defined(__linux__)
     // Extract of manpage: "The name can be up to 16 bytes long, and should be
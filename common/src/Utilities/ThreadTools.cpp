@@ -707,6 +707,11 @@ void Threading::pxThread::_DoSetThreadName(const wxString &name)
     _DoSetThreadName(static_cast<const char *>(name.ToUTF8()));
 }
 
+void Threading::pxThread::_DoSetThreadName(const char *name)
+{
+    SetNameOfCurrentThread(name);
+}
+
 // --------------------------------------------------------------------------------------
 //  pthread Cond is an evil api that is not suited for Pcsx2 needs.
 //  Let's not use it. (Air)
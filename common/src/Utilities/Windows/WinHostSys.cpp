@@ -28,7 +28,12 @@ static int DoSysPageFaultExceptionFilter(EXCEPTION_POINTERS *eps)
     // Source_PageFault is a global variable with its own state information
     // so for now we lock this exception code unless someone can fix this better...
     Threading::ScopedLock lock(PageFault_Mutex);
-    Source_PageFault->Dispatch(PageFaultInfo((uptr)eps->ExceptionRecord->ExceptionInformation[1]));
+    #ifdef __M_X86_64
+    uptr *pc = (uptr *)&eps->ContextRecord->Rip;
+#else
+    uptr *pc = (uptr *)&eps->ContextRecord->Eip;
+#endif
+    Source_PageFault->Dispatch(PageFaultInfo((uptr)eps->ExceptionRecord->ExceptionInformation[1], pc));
     return Source_PageFault->WasHandled() ? EXCEPTION_CONTINUE_EXECUTION : EXCEPTION_CONTINUE_SEARCH;
 }
 
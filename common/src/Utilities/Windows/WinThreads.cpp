@@ -36,6 +36,24 @@ __fi void Threading::SpinWait()
     _mm_pause();
 }
 
+bool Threading::SetCurrentThreadAffinity(int cpu)
+{
+    DWORD_PTR process, system;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system))
+        return false;
+
+    DWORD_PTR mask = process;
+    if (cpu >= 0) {
+        if (cpu >= (int)(sizeof(DWORD_PTR) * 8))
+            return false;
+        mask = (DWORD_PTR)1 << cpu;
+        if (!(mask & process))
+            return false;
+    }
+
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
 __fi void Threading::EnableHiresScheduler()
 {
     // This improves accuracy of Sleep() by some amount, and only adds a negligible amount of
@@ -103,7 +121,7 @@ void Threading::pxThread::_platform_specific_OnCleanupInThread()
     CloseHandle((HANDLE)m_native_handle);
 }
 
-void Threading::pxThread::_DoSetThreadName(const char *name)
+void Threading::SetNameOfCurrentThread(const char *name)
 {
 // This feature needs Windows headers and MSVC's SEH support:
 
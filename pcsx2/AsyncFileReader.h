@@ -65,6 +65,15 @@ class FlatFileReader : public AsyncFileReader
 {
 	DeclareNoncopyableObject( FlatFileReader );
 
+public:
+	enum Backend
+	{
+		Backend_Default,	// io_uring when the kernel supports it, the platform API otherwise
+		Backend_Platform,	// libaio on Linux, overlapped IO on Windows, POSIX AIO elsewhere
+		Backend_IoUring,
+	};
+
+private:
 #ifdef _WIN32
 	HANDLE hOverlappedFile;
 
@@ -76,6 +85,9 @@ class FlatFileReader : public AsyncFileReader
 #elif defined(__linux__)
 	int m_fd; // FIXME don't know if overlap as an equivalent on linux
 	io_context_t m_aio_context;
+
+	// io_uring backend, see LnxFlatFileReader.cpp.  NULL when libaio is used.
+	class IoUringQueue* m_uring;
 #elif defined(__POSIX__)
 	int m_fd; // TODO OSX don't know if overlap as an equivalent on OSX
 	struct aiocb m_aiocb;
@@ -83,11 +95,16 @@ class FlatFileReader : public AsyncFileReader
 #endif
 
 	bool shareWrite;
+	Backend m_backend;
 
 public:
 	FlatFileReader(bool shareWrite = false);
 	virtual ~FlatFileReader(void);
 
+	// Must be called before Open().  Used by the read trace benchmark to compare backends.
+	void SetBackend(Backend backend) { m_backend = backend; }
+	const char* GetBackendName() const;
+
 	virtual bool Open(const wxString& fileName);
 
 	virtual int ReadSync(void* pBuffer, uint sector, uint count);
@@ -104,6 +121,10 @@ public:
 	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
 };
 
+// Replays a CDVD read trace against every FlatFileReader backend and logs the timings.
+// See ReadTraceBenchmark.cpp for the trace format.
+extern bool RunReadTraceBenchmark(const wxString& isoFile, const wxString& traceFile);
+
 class MultipartFileReader : public AsyncFileReader
 {
 	DeclareNoncopyableObject( MultipartFileReader );
@@ -16,37 +16,174 @@
 #include "PrecompiledHeader.h"
 #include "ChunksCache.h"
 
+// Buffer headers take 16 bytes to keep the data 16 bytes aligned.
+static const int CACHE_BUFFER_HEADER_SIZE = 16;
+// Size of one slab of granule buffers.
+static const int CACHE_SLAB_SIZE = 4 * 1024 * 1024;
+
+ChunksCache::ChunksCache(uint initialLimitMb, uint granularity) :
+	m_mru(0),
+	m_lru(0),
+	m_granularity(granularity),
+	m_freeBuffers(0),
+	m_size(0),
+	m_limit((PX_off_t)initialLimitMb * 1024 * 1024) {
+	memzero(m_stats);
+}
+
 void ChunksCache::SetLimit(uint megabytes) {
 	m_limit = (PX_off_t)megabytes * 1024 * 1024;
 	MatchLimit();
 }
 
+void ChunksCache::Clear() {
+	if (m_stats.hits || m_stats.misses)
+		DevCon.WriteLn(Color_Gray, "ChunksCache: %llu hits, %llu misses, %llu evictions, %lld MB cached",
+		               (unsigned long long)m_stats.hits, (unsigned long long)m_stats.misses,
+		               (unsigned long long)m_stats.evictions, (long long)(m_size / 1024 / 1024));
+
+	MatchLimit(true);
+
+	for (u8* slab : m_slabs)
+		free(slab);
+	m_slabs.clear();
+	m_freeBuffers = 0;
+
+	memzero(m_stats);
+}
+
+void* ChunksCache::AllocBuffer(int size) {
+	if (size <= 0)
+		return 0;
+
+	BufferHeader* header;
+	if (size <= m_granularity) {
+		if (!m_freeBuffers) {
+			const int stride = CACHE_BUFFER_HEADER_SIZE + m_granularity;
+			const int count = std::max(1, CACHE_SLAB_SIZE / stride);
+			u8* slab = (u8*)malloc((size_t)stride * count);
+			if (!slab)
+				return 0;
+			m_slabs.push_back(slab);
+
+			for (int i = 0; i < count; i++) {
+				BufferHeader* block = (BufferHeader*)(slab + (size_t)stride * i);
+				block->fromSlab = true;
+				block->nextFree = m_freeBuffers;
+				m_freeBuffers = block;
+			}
+		}
+		header = m_freeBuffers;
+		m_freeBuffers = header->nextFree;
+	} else {
+		header = (BufferHeader*)malloc(CACHE_BUFFER_HEADER_SIZE + size);
+		if (!header)
+			return 0;
+		header->fromSlab = false;
+	}
+
+	return (u8*)header + CACHE_BUFFER_HEADER_SIZE;
+}
+
+void ChunksCache::ReleaseBuffer(void* pBuffer) {
+	if (!pBuffer)
+		return;
+
+	BufferHeader* header = (BufferHeader*)((u8*)pBuffer - CACHE_BUFFER_HEADER_SIZE);
+	if (header->fromSlab) {
+		header->nextFree = m_freeBuffers;
+		m_freeBuffers = header;
+	} else {
+		free(header);
+	}
+}
+
+void ChunksCache::LinkFront(CacheEntry* e) {
+	e->prev = 0;
+	e->next = m_mru;
+	if (m_mru)
+		m_mru->prev = e;
+	m_mru = e;
+	if (!m_lru)
+		m_lru = e;
+}
+
+void ChunksCache::Unlink(CacheEntry* e) {
+	if (e->prev)
+		e->prev->next = e->next;
+	else
+		m_mru = e->next;
+
+	if (e->next)
+		e->next->prev = e->prev;
+	else
+		m_lru = e->prev;
+}
+
+void ChunksCache::Evict(CacheEntry* e) {
+	Unlink(e);
+
+	// Other entries may still cover some of the granules, only drop this one.
+	const PX_off_t last = GranuleOf(e->offset + std::max(e->coverage, 1) - 1);
+	for (PX_off_t g = GranuleOf(e->offset); g <= last; g++) {
+		auto it = m_index.find(g);
+		if (it == m_index.end())
+			continue;
+
+		std::vector<CacheEntry*>& entries = it->second;
+		entries.erase(std::remove(entries.begin(), entries.end(), e), entries.end());
+		if (entries.empty())
+			m_index.erase(it);
+	}
+
+	m_size -= e->size;
+	ReleaseBuffer(e->data);
+	delete e;
+}
+
 void ChunksCache::MatchLimit(bool removeAll) {
-	std::list<CacheEntry*>::reverse_iterator rit;
-	while (!m_entries.empty() && (removeAll || m_size > m_limit)) {
-		rit = m_entries.rbegin();
-		m_size -= (*rit)->size;
-		delete(*rit);
-		m_entries.pop_back();
+	while (m_lru && (removeAll || m_size > m_limit)) {
+		if (!removeAll)
+			m_stats.evictions++;
+		Evict(m_lru);
 	}
 }
 
-void ChunksCache::Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage) {
-	m_entries.push_front(new CacheEntry(pMallocedSrc, offset, length, coverage));
+void ChunksCache::Take(void* pSrc, PX_off_t offset, int length, int coverage) {
+	CacheEntry* e = new CacheEntry;
+	e->data = pSrc;
+	e->offset = offset;
+	e->coverage = coverage;
+	e->size = length;
+	LinkFront(e);
+
+	const PX_off_t last = GranuleOf(offset + std::max(coverage, 1) - 1);
+	for (PX_off_t g = GranuleOf(offset); g <= last; g++)
+		m_index[g].push_back(e);
+
 	m_size += length;
 	MatchLimit();
 }
 
 // By design, succeed only if the entire request is in a single cached chunk
 int ChunksCache::Read(void* pDest, PX_off_t offset, int length) {
-	for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
-		CacheEntry* e = *it;
-		if (e && offset >= e->offset && (offset + length) <= (e->offset + e->coverage)) {
-			if (it != m_entries.begin())
-				m_entries.splice(m_entries.begin(), m_entries, it); // Move to top (MRU)
-			return CopyAvailable(e->data, e->offset, e->size, pDest, offset, length);
+	auto it = m_index.find(GranuleOf(offset));
+	if (it != m_index.end()) {
+		// Most recently added first, a newer chunk of the same data wins
+		const std::vector<CacheEntry*>& entries = it->second;
+		for (auto i = entries.rbegin(); i != entries.rend(); ++i) {
+			CacheEntry* e = *i;
+			if (offset >= e->offset && (offset + length) <= (e->offset + e->coverage)) {
+				if (e != m_mru) { // Move to top (MRU)
+					Unlink(e);
+					LinkFront(e);
+				}
+				m_stats.hits++;
+				return CopyAvailable(e->data, e->offset, e->size, pDest, offset, length);
+			}
 		}
 	}
+
+	m_stats.misses++;
 	return -1;
 }
-
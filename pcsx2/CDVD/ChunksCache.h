@@ -15,20 +15,42 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
 #include "zlib_indexed.h"
 
 #define CLAMP(val, minval, maxval) (std::min(maxval, std::max(minval, val)))
 
+// Cache of extracted data chunks.
+//
+// Entries are indexed by the granule (granularity sized, 0-based aligned piece of the
+// file) they cover, so a lookup is a single hash probe and a check of the few entries
+// overlapping that granule instead of a walk of the whole cache.  Eviction
+// order is kept in an intrusive LRU list, and buffers of up to one granule are recycled
+// from slabs instead of going through malloc/free for every chunk.
 class ChunksCache {
 public:
-	ChunksCache(uint initialLimitMb) : m_entries(0), m_size(0), m_limit(initialLimitMb * 1024 * 1024) {};
+	struct Stats {
+		u64 hits;
+		u64 misses;
+		u64 evictions;
+	};
+
+	ChunksCache(uint initialLimitMb, uint granularity);
 	~ChunksCache() { Clear(); };
 	void SetLimit(uint megabytes);
-	void Clear() { MatchLimit(true); };
+	void Clear();
 
-	void Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage);
+	// Buffers passed to Take() must come from AllocBuffer().  A buffer which ends up not
+	// being given to the cache must be returned with ReleaseBuffer().
+	void* AllocBuffer(int size);
+	void  ReleaseBuffer(void* pBuffer);
+
+	void Take(void* pSrc,         PX_off_t offset, int length, int coverage);
 	int  Read(void* pDest,        PX_off_t offset, int length);
 
+	const Stats& GetStats() const { return m_stats; };
+
 	static int CopyAvailable(void* pSrc, PX_off_t srcOffset, int srcSize,
 							 void* pDst, PX_off_t dstOffset, int maxCopySize) {
 		int available = CLAMP(maxCopySize, 0, (int)(srcOffset + srcSize - dstOffset));
@@ -37,27 +59,42 @@ public:
 	};
 
 private:
-	class CacheEntry {
-	public:
-		CacheEntry(void* pMallocedSrc, PX_off_t offset, int length, int coverage) :
-			data(pMallocedSrc),
-			offset(offset),
-			coverage(coverage),
-			size(length)
-		{};
-
-		~CacheEntry() { if (data) free(data); };
-
+	struct CacheEntry {
 		void* data;
 		PX_off_t offset;
 		int coverage;
 		int size;
+
+		// LRU links, m_mru is the most recently used entry.
+		CacheEntry* prev;
+		CacheEntry* next;
 	};
 
-	std::list<CacheEntry*> m_entries;
+	// Prepended to every buffer handed out by AllocBuffer().
+	struct BufferHeader {
+		BufferHeader* nextFree;
+		bool fromSlab;
+	};
+
+	PX_off_t GranuleOf(PX_off_t offset) const { return offset / m_granularity; };
+
+	void LinkFront(CacheEntry* e);
+	void Unlink(CacheEntry* e);
+	void Evict(CacheEntry* e);
 	void MatchLimit(bool removeAll = false);
+
+	// Entries overlapping each granule, oldest first.
+	std::unordered_map<PX_off_t, std::vector<CacheEntry*>> m_index;
+	CacheEntry* m_mru;
+	CacheEntry* m_lru;
+
+	int m_granularity;
+	BufferHeader* m_freeBuffers;
+	std::vector<u8*> m_slabs;
+
 	PX_off_t m_size;
 	PX_off_t m_limit;
+	Stats m_stats;
 };
 
 #undef CLAMP
@@ -0,0 +1,185 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "CompressedReadAhead.h"
+#include "Utilities/Threading.h"
+
+// Number of consecutive block transitions (n -> n+1) before the access pattern is
+// considered a stream and read-ahead kicks in.
+static const uint READAHEAD_MIN_STREAK = 2;
+
+uint CompressedReadAhead::DefaultThreads() {
+	// Leave room for the EE, GS and VU threads, decompression isn't worth fighting them for.
+	uint cores = std::thread::hardware_concurrency();
+	return std::max(1u, std::min(4u, cores > 3 ? cores - 3 : 1u));
+}
+
+void CompressedReadAhead::Start(uint blockSize, u64 blockCount, uint threads, uint depth, const Decoder& decoder) {
+	Stop();
+
+	m_blockSize = blockSize;
+	m_blockCount = blockCount;
+	m_depth = depth;
+	m_decoder = decoder;
+	m_lastBlock = ~0ULL;
+	m_streak = 0;
+	m_scheduled = 0;
+	m_exit = false;
+
+	// One extra slot per worker so that the block being read can stay around while the
+	// whole window is in flight.
+	m_slots.resize(depth + threads + 1);
+	for (Slot& slot : m_slots) {
+		slot.block = 0;
+		slot.state = SLOT_FREE;
+		slot.size = 0;
+		slot.data = new u8[blockSize];
+	}
+
+	for (uint i = 0; i < threads; i++)
+		m_workers.emplace_back(&CompressedReadAhead::WorkerThread, this, i);
+}
+
+void CompressedReadAhead::Stop() {
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_exit = true;
+	}
+	m_workerCond.notify_all();
+
+	for (std::thread& worker : m_workers)
+		worker.join();
+	m_workers.clear();
+
+	for (Slot& slot : m_slots)
+		delete[] slot.data;
+	m_slots.clear();
+
+	m_decoder = nullptr;
+}
+
+CompressedReadAhead::Slot* CompressedReadAhead::FindSlot(u64 block) {
+	for (Slot& slot : m_slots) {
+		if (slot.state != SLOT_FREE && slot.block == block)
+			return &slot;
+	}
+	return NULL;
+}
+
+int CompressedReadAhead::Read(u64 block, void* dest, uint offset, uint length) {
+	if (!IsRunning())
+		return -1;
+
+	std::unique_lock<std::mutex> lock(m_lock);
+
+	if (block == m_lastBlock + 1) {
+		m_streak++;
+	} else if (block != m_lastBlock) {
+		m_streak = 0;
+		m_scheduled = 0;
+	}
+	m_lastBlock = block;
+
+	int copied = -1;
+	Slot* slot = FindSlot(block);
+	if (slot) {
+		// Only the reader thread (re)assigns slots, so the slot stays ours while we wait.
+		while (slot->state != SLOT_READY)
+			m_readyCond.wait(lock);
+
+		if (slot->size >= 0) {
+			copied = std::max(0, std::min((int)length, slot->size - (int)offset));
+			memcpy(dest, slot->data + offset, copied);
+		} else {
+			// Decode error, let the caller retry (and report) on its own path.
+			slot->state = SLOT_FREE;
+		}
+	}
+
+	if (m_streak >= READAHEAD_MIN_STREAK)
+		Schedule(block);
+
+	return copied;
+}
+
+// Queues [block + 1, block + depth].  Slots outside of that window (behind the stream
+// or left over from a previous stream) are recycled, unless a worker is on them.
+//
+// While streaming the window only moves forward, and the blocks up to the end of the
+// previous window are already queued, so only the new ones are looked at.  This keeps
+// the cost per read independent of the depth.  A seek (Read) starts over from block + 1.
+void CompressedReadAhead::Schedule(u64 block) {
+	const u64 end = std::min(block + m_depth + 1, m_blockCount);
+	bool queued = false;
+
+	u64 next = std::max(block + 1, m_scheduled);
+	for (; next < end; next++) {
+		if (FindSlot(next))
+			continue;
+
+		Slot* victim = NULL;
+		for (Slot& slot : m_slots) {
+			if (slot.state == SLOT_FREE || (slot.state != SLOT_BUSY && (slot.block < block || slot.block >= end))) {
+				victim = &slot;
+				break;
+			}
+		}
+		if (!victim)
+			break;
+
+		victim->block = next;
+		victim->state = SLOT_QUEUED;
+		victim->size = 0;
+		queued = true;
+	}
+
+	m_scheduled = next;
+
+	if (queued)
+		m_workerCond.notify_all();
+}
+
+void CompressedReadAhead::WorkerThread(uint worker) {
+	Threading::SetNameOfCurrentThread("CDVD reader");
+
+	std::unique_lock<std::mutex> lock(m_lock);
+
+	while (!m_exit) {
+		// Always decode the closest block first, it's the one the reader needs next.
+		Slot* next = NULL;
+		for (Slot& slot : m_slots) {
+			if (slot.state == SLOT_QUEUED && (!next || slot.block < next->block))
+				next = &slot;
+		}
+
+		if (!next) {
+			m_workerCond.wait(lock);
+			continue;
+		}
+
+		next->state = SLOT_BUSY;
+		const u64 block = next->block;
+		u8* data = next->data;
+
+		lock.unlock();
+		const int size = m_decoder(worker, block, data);
+		lock.lock();
+
+		next->size = size;
+		next->state = SLOT_READY;
+		m_readyCond.notify_all();
+	}
+}
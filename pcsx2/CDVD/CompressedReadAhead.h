@@ -0,0 +1,89 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Read-ahead for compressed images (CSO frames, GZ chunks).
+//
+// The owner reports every block it is about to read through Read().  Once a few
+// consecutive blocks were requested (FMV/audio streaming), the next blocks are
+// decompressed on a small set of worker threads, so that by the time the reader
+// gets there the data is ready and no decompression happens on the reader thread.
+//
+// Random access is left alone: Read() returns -1 and the owner uses its regular path.
+class CompressedReadAhead {
+public:
+	// Decompresses a whole block into dest (blockSize bytes).  Called on worker thread
+	// 'worker' (0 .. threads-1), so it must only touch per-worker state and read-only
+	// data of the owner.  Returns the number of bytes decoded, or < 0 on failure.
+	typedef std::function<int(uint worker, u64 block, u8* dest)> Decoder;
+
+	CompressedReadAhead() : m_blockSize(0), m_blockCount(0), m_depth(0),
+		m_lastBlock(~0ULL), m_streak(0), m_scheduled(0), m_exit(false) {};
+	~CompressedReadAhead() { Stop(); };
+
+	static uint DefaultThreads();
+
+	void Start(uint blockSize, u64 blockCount, uint threads, uint depth, const Decoder& decoder);
+	void Stop();
+	bool IsRunning() const { return !m_workers.empty(); };
+
+	// Copies [offset, offset + length) of the block into dest if it was read ahead, waiting
+	// for it if it's still being decoded. Returns the number of bytes copied, or -1 if the
+	// block isn't available (the caller must decode it itself).
+	int Read(u64 block, void* dest, uint offset, uint length);
+
+private:
+	enum SlotState {
+		SLOT_FREE,
+		SLOT_QUEUED,
+		SLOT_BUSY,
+		SLOT_READY,
+	};
+
+	struct Slot {
+		u64 block;
+		SlotState state;
+		int size;
+		u8* data;
+	};
+
+	Slot* FindSlot(u64 block);
+	void Schedule(u64 block);
+	void WorkerThread(uint worker);
+
+	uint m_blockSize;
+	u64 m_blockCount;
+	uint m_depth;
+	Decoder m_decoder;
+
+	// Sequential stream detection
+	u64 m_lastBlock;
+	uint m_streak;
+	u64 m_scheduled; // end of the window queued by the last Schedule()
+
+	std::vector<Slot> m_slots;
+	std::vector<std::thread> m_workers;
+	std::mutex m_lock;
+	std::condition_variable m_workerCond; // slots were queued, or m_exit
+	std::condition_variable m_readyCond;  // a slot became ready
+	bool m_exit;
+};
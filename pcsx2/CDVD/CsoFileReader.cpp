@@ -89,6 +89,8 @@ bool CsoFileReader::Open(const wxString& fileName) {
 		Close();
 		return false;
 	}
+
+	InitializeReadAhead();
 	return true;
 }
 
@@ -154,7 +156,86 @@ bool CsoFileReader::InitializeBuffers() {
 	return true;
 }
 
+void CsoFileReader::InitializeReadAhead() {
+	const uint threads = CompressedReadAhead::DefaultThreads();
+	for (uint i = 0; i < threads; i++) {
+		ReadAheadWorker worker = {};
+		worker.src = PX_fopen_rb(m_filename);
+		if (!worker.src)
+			break;
+
+		worker.zstream = new z_stream;
+		worker.zstream->zalloc = Z_NULL;
+		worker.zstream->zfree = Z_NULL;
+		worker.zstream->opaque = Z_NULL;
+		if (inflateInit2(worker.zstream, -15) != Z_OK) {
+			delete worker.zstream;
+			fclose(worker.src);
+			break;
+		}
+
+		worker.readBuffer = new u8[m_frameSize + (1 << m_indexShift)];
+		m_readAheadWorkers.push_back(worker);
+	}
+
+	if (m_readAheadWorkers.empty()) {
+		Console.Warning("CSO read-ahead disabled, could not set up the worker file handles.");
+		return;
+	}
+
+	const u32 numFrames = (u32)((m_totalSize + m_frameSize - 1) / m_frameSize);
+	// About CSO_READAHEAD_SIZE ahead whatever the frame size, a few frames for huge frames
+	const uint depth = std::max(4u, CSO_READAHEAD_SIZE / m_frameSize);
+	m_readAhead.Start(m_frameSize, numFrames, m_readAheadWorkers.size(), depth,
+		[this](uint worker, u64 block, u8* dest) { return ReadAheadFrame(worker, (u32)block, dest); });
+}
+
+void CsoFileReader::CloseReadAhead() {
+	m_readAhead.Stop();
+
+	for (ReadAheadWorker& worker : m_readAheadWorkers) {
+		inflateEnd(worker.zstream);
+		delete worker.zstream;
+		delete[] worker.readBuffer;
+		fclose(worker.src);
+	}
+	m_readAheadWorkers.clear();
+}
+
+// Decodes a whole frame on a read-ahead worker.  Only touches the worker's own state and
+// the (read-only after Open) index.
+int CsoFileReader::ReadAheadFrame(uint worker, u32 frame, u8* dest) {
+	ReadAheadWorker& ctx = m_readAheadWorkers[worker];
+
+	const bool compressed = (m_index[frame + 0] & 0x80000000) == 0;
+	const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
+	const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
+	const u64 frameRawPos = (u64)index0 << m_indexShift;
+	const u64 frameRawSize = (u64)(index1 - index0) << m_indexShift;
+
+	if (PX_fseeko(ctx.src, m_dataoffset + frameRawPos, SEEK_SET) != 0)
+		return -1;
+
+	if (!compressed)
+		return fread(dest, 1, std::min<u64>(frameRawSize, m_frameSize), ctx.src);
+
+	const u32 readRawBytes = fread(ctx.readBuffer, 1, frameRawSize, ctx.src);
+
+	ctx.zstream->next_in = ctx.readBuffer;
+	ctx.zstream->avail_in = readRawBytes;
+	ctx.zstream->next_out = dest;
+	ctx.zstream->avail_out = m_frameSize;
+
+	const int status = inflate(ctx.zstream, Z_FINISH);
+	const bool success = status == Z_STREAM_END && ctx.zstream->total_out == m_frameSize;
+	inflateReset(ctx.zstream);
+
+	return success ? (int)m_frameSize : -1;
+}
+
 void CsoFileReader::Close() {
+	CloseReadAhead();
+
 	m_filename.Empty();
 #if CSO_USE_CHUNKSCACHE
 	m_cache.Clear();
@@ -215,7 +296,7 @@ int CsoFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
 
 #if CSO_USE_CHUNKSCACHE
 			// Add the bytes into the cache.  We need to allocate a buffer for it.
-			void *cached = malloc(readBytes);
+			void *cached = m_cache.AllocBuffer(readBytes);
 			memcpy(cached, dest + bytes, readBytes);
 			m_cache.Take(cached, pos + bytes, readBytes, readBytes);
 #endif
@@ -240,6 +321,12 @@ int CsoFileReader::ReadFromFrame(u8 *dest, u64 pos, int maxBytes) {
 	const u32 bytes = (u32)(std::min(m_blocksize, static_cast<uint>(m_frameSize - offset)));
 
 	// Grab the index data for the frame we're about to read.
+	// Streaming reads are normally already decompressed by the read-ahead workers.
+	const int readAheadBytes = m_readAhead.Read(frame, dest, offset, bytes);
+	if (readAheadBytes >= 0) {
+		return readAheadBytes;
+	}
+
 	const bool compressed = (m_index[frame + 0] & 0x80000000) == 0;
 	const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
 	const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
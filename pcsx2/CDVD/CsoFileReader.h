@@ -26,11 +26,14 @@
 
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "CompressedReadAhead.h"
 
 struct CsoHeader;
 typedef struct z_stream_s z_stream;
 
 static const uint CSO_CHUNKCACHE_SIZE_MB = 200;
+// Amount of data decompressed ahead of the reader while streaming.
+static const uint CSO_READAHEAD_SIZE = 1024 * 1024;
 
 class CsoFileReader : public AsyncFileReader
 {
@@ -48,7 +51,7 @@ public:
 		m_src(0),
 		m_z_stream(0),
 #if CSO_USE_CHUNKSCACHE
-		m_cache(CSO_CHUNKCACHE_SIZE_MB),
+		m_cache(CSO_CHUNKCACHE_SIZE_MB, 2048),
 #endif
 		m_bytesRead(0) {
 		m_blocksize = 2048;
@@ -80,6 +83,9 @@ private:
 	bool InitializeBuffers();
 	int ReadFromFrame(u8 *dest, u64 pos, int maxBytes);
 	bool DecompressFrame(u32 frame, u32 readBufferSize);
+	void InitializeReadAhead();
+	void CloseReadAhead();
+	int ReadAheadFrame(uint worker, u32 frame, u8* dest);
 
 	u32 m_frameSize;
 	u8 m_frameShift;
@@ -97,6 +103,15 @@ private:
 	ChunksCache m_cache;
 #endif
 
+	// Each read-ahead worker gets its own file handle and zlib state.
+	struct ReadAheadWorker {
+		FILE* src;
+		z_stream* zstream;
+		u8* readBuffer;
+	};
+	std::vector<ReadAheadWorker> m_readAheadWorkers;
+	CompressedReadAhead m_readAhead;
+
 	// The result of a read is stored here between BeginRead() and FinishRead().
 	int m_bytesRead;
 };
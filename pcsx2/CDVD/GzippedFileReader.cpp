@@ -182,7 +182,8 @@ GzippedFileReader::GzippedFileReader(void) :
 	m_pIndex(0),
 	m_zstates(0),
 	m_src(0),
-	m_cache(GZFILE_CACHE_SIZE_MB) {
+	m_cache(GZFILE_CACHE_SIZE_MB, GZFILE_READ_CHUNK_SIZE),
+	m_readAheadSrc(0) {
 	m_blocksize = 2048;
 	AsyncPrefetchReset();
 };
@@ -335,9 +336,34 @@ bool GzippedFileReader::Open(const wxString& fileName) {
 	};
 
 	AsyncPrefetchOpen();
+	ReadAheadOpen();
 	return true;
 };
 
+void GzippedFileReader::ReadAheadOpen() {
+	if (!(m_readAheadSrc = PX_fopen_rb(m_filename))) {
+		Console.Warning(L"gzip read-ahead disabled, could not open a second handle for '%s'", WX_STR(m_filename));
+		return;
+	}
+
+	u64 chunks = (m_pIndex->uncompressed_size + GZFILE_READ_CHUNK_SIZE - 1) / GZFILE_READ_CHUNK_SIZE;
+	m_readAhead.Start(GZFILE_READ_CHUNK_SIZE, chunks, 1, GZFILE_READAHEAD_CHUNKS,
+		[this](uint worker, u64 block, u8* dest) {
+			return extract(m_readAheadSrc, m_pIndex, (PX_off_t)block * GZFILE_READ_CHUNK_SIZE,
+			               dest, GZFILE_READ_CHUNK_SIZE, &m_readAheadState.state);
+		});
+}
+
+void GzippedFileReader::ReadAheadClose() {
+	m_readAhead.Stop();
+	m_readAheadState.Kill();
+
+	if (m_readAheadSrc) {
+		fclose(m_readAheadSrc);
+		m_readAheadSrc = 0;
+	}
+}
+
 void GzippedFileReader::BeginRead(void* pBuffer, uint sector, uint count) {
 	// No a-sync support yet, implement as sync
 	mBytesRead = ReadSync(pBuffer, sector, count);
@@ -401,7 +427,12 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 
 	// From here onwards it's guarenteed that the request is inside a single GZFILE_READ_CHUNK_SIZE boundaries
 
-	int res = m_cache.Read(pBuffer, offset, bytesToRead);
+	// Streaming reads are normally already extracted by the read-ahead worker
+	int res = m_readAhead.Read(offset / GZFILE_READ_CHUNK_SIZE, pBuffer, offset % GZFILE_READ_CHUNK_SIZE, bytesToRead);
+	if (res >= 0)
+		return res;
+
+	res = m_cache.Read(pBuffer, offset, bytesToRead);
 	if (res >= 0)
 		return res;
 
@@ -410,14 +441,14 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 	PTT s = NOW();
 	PX_off_t extractOffset = GetOptimalExtractionStart(offset); // guaranteed in GZFILE_READ_CHUNK_SIZE boundaries
 	int size = offset + maxInChunk - extractOffset;
-	unsigned char* extracted = (unsigned char*)malloc(size);
+	unsigned char* extracted = (unsigned char*)m_cache.AllocBuffer(size);
 
 	int span = m_pIndex->span;
 	int spanix = extractOffset / span;
 	AsyncPrefetchCancel();
 	res = extract(m_src, m_pIndex, extractOffset, extracted, size, &(m_zstates[spanix].state));
 	if (res < 0) {
-		free(extracted);
+		m_cache.ReleaseBuffer(extracted);
 		return res;
 	}
 	AsyncPrefetchChunk(getInOffset(&(m_zstates[spanix].state)));
@@ -443,12 +474,12 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 	else { // split into cacheable chunks
 		for (int i = 0; i < size; i += GZFILE_READ_CHUNK_SIZE) {
 			int available = CLAMP(res - i, 0, GZFILE_READ_CHUNK_SIZE);
-			void* chunk = available ? malloc(available) : 0;
+			void* chunk = m_cache.AllocBuffer(available);
 			if (available)
 				memcpy(chunk, extracted + i, available);
 			m_cache.Take(chunk, extractOffset + i, available, std::min(size - i, GZFILE_READ_CHUNK_SIZE));
 		}
-		free(extracted);
+		m_cache.ReleaseBuffer(extracted);
 	}
 
 	int duration = NOW() - s;
@@ -463,6 +494,7 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 }
 
 void GzippedFileReader::Close() {
+	ReadAheadClose(); // uses the index, stop it first
 	m_filename.Empty();
 	if (m_pIndex) {
 		free_index((Access*)m_pIndex);
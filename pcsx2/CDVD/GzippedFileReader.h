@@ -19,11 +19,13 @@ typedef struct zstate Zstate;
 
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "CompressedReadAhead.h"
 #include "zlib_indexed.h"
 
 #define GZFILE_SPAN_DEFAULT (1048576L * 4)   /* distance between direct access points when creating a new index */
 #define GZFILE_READ_CHUNK_SIZE (256 * 1024)  /* zlib extraction chunks size (at 0-based boundaries) */
 #define GZFILE_CACHE_SIZE_MB 200             /* cache size for extracted data. must be at least GZFILE_READ_CHUNK_SIZE (in MB)*/
+#define GZFILE_READAHEAD_CHUNKS 8            /* chunks extracted ahead of the reader while streaming */
 
 class GzippedFileReader : public AsyncFileReader
 {
@@ -69,6 +71,8 @@ private:
 	PX_off_t GetOptimalExtractionStart(PX_off_t offset);
 	int     _ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRead);
 	void	InitZstates();
+	void	ReadAheadOpen();
+	void	ReadAheadClose();
 
 	int		mBytesRead; // Temp sync read result when simulating async read
 	Access* m_pIndex;   // Quick access index
@@ -77,6 +81,12 @@ private:
 
 	ChunksCache m_cache;
 
+	// A deflate stream can only be continued serially between index points, so read-ahead
+	// uses a single worker, with its own file handle and zstate following the stream.
+	CompressedReadAhead m_readAhead;
+	FILE*	m_readAheadSrc;
+	Czstate m_readAheadState;
+
 #ifdef _WIN32
 	// Used by async prefetch
 	HANDLE hOverlappedFile;
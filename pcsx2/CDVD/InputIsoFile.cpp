@@ -76,6 +76,9 @@ void InputIsoFile::BeginRead2(uint lsn)
 		m_read_count = std::min(ReadUnit, m_blocks - m_read_lsn);
 	}
 
+	// Replayable with --readtrace, see ReadTraceBenchmark.cpp
+	CDVD_LOG("IsoRead lsn=%u count=%u blocksize=%u", m_read_lsn, m_read_count, m_blocksize);
+
 	m_reader->BeginRead(m_readbuffer, m_read_lsn, m_read_count);
 	m_read_inprogress = true;
 }
@@ -0,0 +1,202 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2014  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "AsyncFileReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+// Replays a CDVD sector access trace against each FlatFileReader backend.
+//
+// A trace is a text file with one read per line, either "lsn count [blocksize]" or
+// the "IsoRead lsn=.. count=.. blocksize=.." lines written by the IOP CDVD trace log,
+// so an emulog of a real game session can be used as is.
+
+struct TraceRead
+{
+	uint lsn;
+	uint count;
+};
+
+static bool LoadReadTrace(const wxString& traceFile, std::vector<TraceRead>& reads, uint& blocksize)
+{
+	std::ifstream in(PX_wfilename(traceFile));
+	if (!in)
+		return false;
+
+	std::string line;
+	while (std::getline(in, line))
+	{
+		TraceRead read;
+		uint bs = 0;
+		const size_t tag = line.find("IsoRead ");
+		if (tag != std::string::npos)
+		{
+			if (sscanf(line.c_str() + tag, "IsoRead lsn=%u count=%u blocksize=%u", &read.lsn, &read.count, &bs) < 2)
+				continue;
+		}
+		else if (sscanf(line.c_str(), "%u %u %u", &read.lsn, &read.count, &bs) < 2)
+			continue;
+
+		if (bs)
+			blocksize = bs;
+		if (read.count)
+			reads.push_back(read);
+	}
+
+	return true;
+}
+
+// Drops the ISO from the page cache so that every backend starts cold.
+static void EvictFromPageCache(const wxString& isoFile)
+{
+#ifdef __linux__
+	int fd = wxOpen(isoFile, O_RDONLY, 0);
+	if (fd != -1)
+	{
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+#endif
+}
+
+// Returns false if the backend can't be used.  hash gets an FNV-1a hash of the data
+// returned by every read, which must be the same for all backends.
+static bool ReplayReadTrace(const wxString& isoFile, FlatFileReader::Backend backend,
+	const std::vector<TraceRead>& reads, uint blocksize, bool cold, u64& hash)
+{
+	FlatFileReader reader;
+	reader.SetBackend(backend);
+	reader.SetBlockSize(blocksize);
+
+	if (cold)
+		EvictFromPageCache(isoFile);
+
+	if (!reader.Open(isoFile))
+	{
+		Console.Warning("ReadTrace: backend %d can't open the image, skipped.", (int)backend);
+		return false;
+	}
+
+	uint maxCount = 0;
+	for (const TraceRead& read : reads)
+		maxCount = std::max(maxCount, read.count);
+	std::vector<u8> buffer((size_t)maxCount * blocksize);
+
+	std::vector<double> latency;
+	latency.reserve(reads.size());
+	u64 bytes = 0;
+	uint errors = 0;
+
+	hash = 0xcbf29ce484222325ULL;
+	double total = 0;
+
+	for (const TraceRead& read : reads)
+	{
+		const size_t size = (size_t)read.count * blocksize;
+
+		// Short reads (past the end of the image) hash the same on every backend.
+		memset(buffer.data(), 0, size);
+
+		const auto t0 = std::chrono::steady_clock::now();
+		reader.BeginRead(buffer.data(), read.lsn, read.count);
+		if (reader.FinishRead() < 0)
+			errors++;
+		const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+		latency.push_back(us);
+		total += us / 1e6;
+		bytes += size;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= buffer[i];
+			hash *= 0x100000001b3ULL;
+		}
+	}
+
+	std::sort(latency.begin(), latency.end());
+	const double mean = std::accumulate(latency.begin(), latency.end(), 0.0) / latency.size();
+	const double p99 = latency[std::min(latency.size() - 1, latency.size() * 99 / 100)];
+
+	Console.WriteLn(Color_StrongGreen, "ReadTrace: %-9s %s  %.3f s  %7.1f MB/s  mean %7.1f us  p99 %8.1f us  max %8.1f us  %u errors  data %016llx",
+		reader.GetBackendName(), cold ? "cold" : "warm", total, bytes / total / (1024 * 1024),
+		mean, p99, latency.back(), errors, (unsigned long long)hash);
+
+	reader.Close();
+	return true;
+}
+
+bool RunReadTraceBenchmark(const wxString& isoFile, const wxString& traceFile)
+{
+	std::vector<TraceRead> reads;
+	uint blocksize = 2048;
+
+	if (!LoadReadTrace(traceFile, reads, blocksize))
+	{
+		Console.Error(L"ReadTrace: can't open trace '%s'", WX_STR(traceFile));
+		return false;
+	}
+	if (reads.empty())
+	{
+		Console.Error(L"ReadTrace: no reads found in '%s'", WX_STR(traceFile));
+		return false;
+	}
+
+	Console.WriteLn(L"ReadTrace: replaying %u reads (blocksize %u) against '%s'", (uint)reads.size(), blocksize, WX_STR(isoFile));
+
+	bool first = true;
+	bool mismatch = false;
+	u64 reference = 0;
+
+	const FlatFileReader::Backend backends[] = { FlatFileReader::Backend_Platform, FlatFileReader::Backend_IoUring };
+	for (FlatFileReader::Backend backend : backends)
+	{
+#ifndef __linux__
+		if (backend == FlatFileReader::Backend_IoUring)
+			continue;
+#endif
+		for (int cold = 1; cold >= 0; cold--)
+		{
+			u64 hash;
+			if (!ReplayReadTrace(isoFile, backend, reads, blocksize, cold != 0, hash))
+				break;
+
+			if (first)
+				reference = hash;
+			first = false;
+
+			if (hash != reference)
+			{
+				Console.Error("ReadTrace: backend %d returned different data (%016llx, expected %016llx)!",
+					(int)backend, (unsigned long long)hash, (unsigned long long)reference);
+				mismatch = true;
+			}
+		}
+	}
+
+	// Not a single backend could replay the trace (missing or unreadable IsoFile)
+	if (first)
+		return false;
+
+	return !mismatch;
+}
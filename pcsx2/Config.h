@@ -247,6 +247,10 @@ struct Pcsx2Config
 				PreBlockCheckIOP:1;
 			bool
 				EnableEECache   :1;
+			bool
+				EnableEEBlockCache :1;
+			bool
+				EnableFastmem	:1;
 		BITFIELD_END
 
 		RecompilerOptions();
@@ -296,6 +300,10 @@ struct Pcsx2Config
 		// style.  Useful for debugging potential bugs in the MTGS pipeline.
 		bool	SynchronousMTGS;
 
+		// MTGS thread spins on the ring before sleeping, and the EE only wakes it when it
+		// has actually gone to sleep.  Trades some idle CPU time for fewer wakeup syscalls.
+		bool	SpinWaitMTGS;
+
 		int		VsyncQueueSize;
 
 		bool		FrameLimitEnable;
@@ -318,6 +326,7 @@ struct Pcsx2Config
 		{
 			return
 				OpEqu( SynchronousMTGS )		&&
+				OpEqu( SpinWaitMTGS )			&&
 				OpEqu( VsyncQueueSize )			&&
 				
 				OpEqu( FrameSkipEnable )		&&
@@ -395,19 +404,24 @@ struct Pcsx2Config
 				IntcStat		:1,		// tells Pcsx2 to fast-forward through intc_stat waits.
 				WaitLoop		:1,		// enables constant loop detection and fast-forwarding
 				vuFlagHack		:1,		// microVU specific flag hack
-				vuThread        :1;		// Enable Threaded VU1
+				vuThread        :1,		// Enable Threaded VU1
+				ipuThread       :1;		// Decode IPU commands ahead on a worker thread
 		BITFIELD_END
 
 		s8	EECycleRate;		// EE cycle rate selector (1.0, 1.5, 2.0)
 		u8	EECycleSkip;		// EE Cycle skip factor (0, 1, 2, or 3)
 
+		int	vuThreadSpin;		// MTVU: max iterations spent spinning on the ring before sleeping (0 = never spin)
+		int	vuThreadCpu;		// MTVU: host cpu the thread is pinned to (-1 = let the OS decide)
+
 		SpeedhackOptions();
 		void LoadSave( IniInterface& conf );
 		SpeedhackOptions& DisableAll();
 
 		bool operator ==( const SpeedhackOptions& right ) const
 		{
-			return OpEqu( bitset ) && OpEqu( EECycleRate ) && OpEqu( EECycleSkip );
+			return OpEqu( bitset ) && OpEqu( EECycleRate ) && OpEqu( EECycleSkip )
+				&& OpEqu( vuThreadSpin ) && OpEqu( vuThreadCpu );
 		}
 
 		bool operator !=( const SpeedhackOptions& right ) const
@@ -468,7 +482,10 @@ struct Pcsx2Config
 			MultitapPort1_Enabled:1,
 
 			ConsoleToStdio		:1,
-			HostFs				:1;
+			HostFs				:1,
+
+		// pins the emulator threads to distinct physical cores (Linux only)
+			PinThreads			:1;
 	BITFIELD_END
 
 	CpuOptions			Cpu;
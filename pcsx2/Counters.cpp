@@ -27,6 +27,7 @@
 
 #include "GS.h"
 #include "VUmicro.h"
+#include "MTVU.h"
 
 #include "ps2/HwInternal.h"
 
@@ -453,6 +454,7 @@ static __fi void VSyncStart(u32 sCycle)
 
 	CpuVU0->Vsync();
 	CpuVU1->Vsync();
+	vu1Thread.PostVsync();
 
 	if (!CSRreg.VSINT)
 	{
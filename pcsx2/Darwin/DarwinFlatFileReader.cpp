@@ -28,7 +28,7 @@
 #warning AIO has been disabled.
 #endif
 
-FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite)
+FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite), m_backend(Backend_Default)
 {
 	m_blocksize = 2048;
 	m_fd = -1;
@@ -40,6 +40,15 @@ FlatFileReader::~FlatFileReader(void)
 	Close();
 }
 
+const char* FlatFileReader::GetBackendName() const
+{
+#ifdef DISABLE_AIO
+	return "pread";
+#else
+	return "posix aio";
+#endif
+}
+
 bool FlatFileReader::Open(const wxString& fileName)
 {
     m_filename = fileName;
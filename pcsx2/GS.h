@@ -304,6 +304,15 @@ struct MTGS_FreezeData
 	s32			retval;		// value returned from the call, valid only after an mtgsWaitGS()
 };
 
+// Per-frame snapshot of the EE->GS handoff counters (see SysMtgsThread::PostVsyncStart).
+struct MTGS_RingStats
+{
+	u32		ProducerStalls;		// packets that had to wait for room in the ringbuffer
+	u32		ConsumerIdles;		// times the MTGS thread ran dry and parked itself
+	u32		ConsumerSpins;		// times the MTGS thread picked up new work while spinning (no wakeup needed)
+	u32		WakeSyscalls;		// semaphore posts issued to wake the MTGS thread
+};
+
 // --------------------------------------------------------------------------------------
 //  SysMtgsThread
 // --------------------------------------------------------------------------------------
@@ -318,6 +327,7 @@ public:
 	std::atomic<unsigned int> m_WritePos; // cur pos ee thread is writing to
 
 	std::atomic<bool>	m_RingBufferIsBusy;
+	std::atomic<bool>	m_RingBufferIsParked;	// MTGS is (about to be) asleep on m_sem_event; SpinWaitMTGS mode only
 	std::atomic<bool>	m_SignalRingEnable;
 	std::atomic<int>	m_SignalRingPosition;
 
@@ -338,6 +348,16 @@ public:
 	// has more than one command in it when the thread is kicked.
 	int				m_CopyDataTally;
 
+	// Number of SpinWait iterations the MTGS thread performs before parking itself
+	// (SpinWaitMTGS mode).  Adapts to how quickly the EE has been refilling the ring.
+	int				m_SpinBudget;
+
+	std::atomic<u32>	m_stat_ProducerStalls;
+	std::atomic<u32>	m_stat_ConsumerIdles;
+	std::atomic<u32>	m_stat_ConsumerSpins;
+	std::atomic<u32>	m_stat_WakeSyscalls;
+	MTGS_RingStats		m_FrameStats;
+
 	Semaphore			m_sem_OpenDone;
 	std::atomic<bool>	m_PluginOpened;
 
@@ -377,6 +397,9 @@ public:
 
 	bool IsPluginOpened() const { return m_PluginOpened; }
 
+	// Returns the handoff counters gathered over the last complete frame.
+	MTGS_RingStats GetFrameStats() const { return m_FrameStats; }
+
 protected:
 	void OpenPlugin();
 	void ClosePlugin();
@@ -390,6 +413,8 @@ protected:
 	void OnCleanupInThread();
 
 	void GenericStall( uint size );
+	void WaitForRingWork();
+	void PostRingEvent();
 
 	// Used internally by SendSimplePacket type functions
 	void _FinishSimplePacket();
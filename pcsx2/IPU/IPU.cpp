@@ -18,6 +18,7 @@
 
 #include "IPU.h"
 #include "IPUdma.h"
+#include "IPUThread.h"
 #include "yuv2rgb.h"
 #include "mpeg2lib/Mpeg.h"
 
@@ -61,8 +62,19 @@ void tIPU_cmd::clear()
 
 __fi void IPUProcessInterrupt()
 {
+	if (ipuThread.IsActive())
+	{
+		ipuThread.Update();
+		if (ipuThread.IsActive()) return;
+	}
+
+	ipuThread.FlushBacklog();
+
 	if (ipuRegs.ctrl.BUSY) // && (g_BP.FP || g_BP.IFC || (ipu1ch.chcr.STR && ipu1ch.qwc > 0)))
+	{
+		if (ipuThread.Begin()) return;
 		IPUWorker();
+	}
 	if (ipuRegs.ctrl.BUSY && ipuRegs.cmd.BUSY && ipuRegs.cmd.DATA == 0x000001B7) {
 		// 0x000001B7 is the MPEG2 sequence end code, signalling the end of a video.
 		// At the end of a video BUSY values should be automatically set to 0. 
@@ -75,8 +87,51 @@ __fi void IPUProcessInterrupt()
 /////////////////////////////////////////////////////////
 // Register accesses (run on EE thread)
 
+IPUKernelSet ipuBestKernels()
+{
+	if (x86caps.hasAVX2) return IPUKernels_AVX2;
+	if (x86caps.hasStreamingSIMD4Extensions) return IPUKernels_SSE41;
+	return IPUKernels_SSE2;
+}
+
+void ipuSelectKernels(IPUKernelSet set)
+{
+	switch (set)
+	{
+		case IPUKernels_Reference:
+			mpeg2_idct = mpeg2_idct_c;
+			yuv2rgb = yuv2rgb_reference;
+			break;
+
+		case IPUKernels_SSE2:
+			mpeg2_idct = mpeg2_idct_c;
+			yuv2rgb = yuv2rgb_sse2;
+			break;
+
+		case IPUKernels_SSE41:
+			mpeg2_idct = mpeg2_idct_sse41;
+			yuv2rgb = yuv2rgb_sse2;
+			break;
+
+		case IPUKernels_AVX2:
+			mpeg2_idct = mpeg2_idct_avx2;
+			yuv2rgb = yuv2rgb_avx2;
+			break;
+
+		jNO_DEFAULT
+	}
+}
+
+const char* ipuKernelsName(IPUKernelSet set)
+{
+	static const char* const names[IPUKernels_Count] = { "Reference", "SSE2", "SSE4.1", "AVX2" };
+	return names[set];
+}
+
 void ipuReset()
 {
+	ipuThread.Reset();
+
 	memzero(ipuRegs);
 	memzero(g_BP);
 	memzero(decoder);
@@ -85,6 +140,9 @@ void ipuReset()
 
 	ipu_fifo.init();
 	ipu_cmd.clear();
+
+	ipuSelectKernels(ipuBestKernels());
+	ipuCaptureReset(true);
 }
 
 void ReportIPU()
@@ -107,6 +165,12 @@ void SaveStateBase::ipuFreeze()
 	// Get a report of the status of the ipu variables when saving and loading savestates.
 	//ReportIPU();
 	FreezeTag("IPU");
+
+	// The decode-ahead session was stopped before the hardware registers were saved, what
+	// is left of it is the input a fallback couldn't fit in the FIFO yet.
+	if (IsLoading()) ipuThread.Reset();
+	ipuThread.FreezeBacklog(*this);
+
 	Freeze(ipu_fifo);
 
 	Freeze(g_BP);
@@ -115,6 +179,9 @@ void SaveStateBase::ipuFreeze()
 	Freeze(coded_block_pattern);
 	Freeze(decoder);
 	Freeze(ipu_cmd);
+
+	// A capture can only be replayed from a reset.
+	if (IsLoading()) ipuCapturePause();
 }
 
 void tIPU_CMD_IDEC::log() const
@@ -202,6 +269,14 @@ __fi u32 ipuRead32(u32 mem)
 
 	IPUProcessInterrupt();
 
+	// Games poll IPU_CTRL while waiting for the IPU, keep decoding ahead.  Anything else
+	// needs the real decoder state.
+	if (ipuThread.IsActive())
+	{
+		if (mem == ipumsk(IPU_CTRL)) return ipuThread.ReadCtrl();
+		ipuThread.Stop();
+	}
+
 	switch (mem)
 	{
 		ipucase(IPU_CTRL): // IPU_CTRL
@@ -243,6 +318,7 @@ __fi u64 ipuRead64(u32 mem)
 	mem &= 0xff;	// ipu repeats every 0x100
 
 	IPUProcessInterrupt();
+	ipuThread.Stop();
 
 	switch (mem)
 	{
@@ -283,6 +359,9 @@ void ipuSoftReset()
 	ipuRegs.cmd.DATA = 0; // required for Enthusia - Professional Racing after fix, or will freeze at start of next video.
 
 	memzero(g_BP);
+
+	ipuThread.Reset();
+	ipuCaptureReset(false);
 }
 
 __fi bool ipuWrite32(u32 mem, u32 value)
@@ -297,6 +376,7 @@ __fi bool ipuWrite32(u32 mem, u32 value)
 	{
 		ipucase(IPU_CMD): // IPU_CMD
 			IPU_LOG("write32: IPU_CMD=0x%08X", value);
+			ipuThread.Stop();
 			IPUCMD_WRITE(value);
 			IPUProcessInterrupt();
 		return false;
@@ -304,6 +384,7 @@ __fi bool ipuWrite32(u32 mem, u32 value)
 		ipucase(IPU_CTRL): // IPU_CTRL
             // CTRL = the first 16 bits of ctrl [0x8000ffff], + value for the next 16 bits,
             // minus the reserved bits. (18-19; 27-29) [0x47f30000]
+			ipuThread.Stop();
 			ipuRegs.ctrl.write(value);
 			if (ipuRegs.ctrl.IDP == 3)
 			{
@@ -333,6 +414,7 @@ __fi bool ipuWrite64(u32 mem, u64 value)
 	{
 		ipucase(IPU_CMD):
 			IPU_LOG("write64: IPU_CMD=0x%08X", value);
+			ipuThread.Stop();
 			IPUCMD_WRITE((u32)value);
 			IPUProcessInterrupt();
 		return false;
@@ -348,6 +430,7 @@ __fi bool ipuWrite64(u32 mem, u64 value)
 static void ipuBCLR(u32 val)
 {
 	ipu_fifo.in.clear();
+	ipuThread.Reset();
 
 	memzero(g_BP);
 	g_BP.BP = val & 0x7F;
@@ -840,6 +923,9 @@ __fi void IPUCMD_WRITE(u32 val)
 	// don't process anything if currently busy
 	//if (ipuRegs.ctrl.BUSY) Console.WriteLn("IPU BUSY!"); // wait for thread
 
+	if (ipuCapturing) ipuCaptureCommand(val);
+	ipuThread.OnCommand();
+
 	ipuRegs.ctrl.ECD = 0;
 	ipuRegs.ctrl.SCD = 0;
 	ipu_cmd.clear();
@@ -910,7 +996,10 @@ __fi void IPUCMD_WRITE(u32 val)
 	//if(!ipu1ch.chcr.STR) hwIntcIrq(INTC_IPU);
 }
 
-__noinline void IPUWorker()
+// Runs the current command as far as the FIFOs allow, returns true once it's done.
+// Also runs IDEC, BDEC and CSC on the decode-ahead thread (IPUThread.cpp), so these must
+// not touch anything but the IPU state.
+bool ipuProcessCommand()
 {
 	pxAssert(ipuRegs.ctrl.BUSY);
 
@@ -922,7 +1011,7 @@ __noinline void IPUWorker()
 			//break;
 
 		case SCE_IPU_IDEC:
-			if (!mpeg2sliceIDEC()) return;
+			if (!mpeg2sliceIDEC()) return false;
 
 			//ipuRegs.ctrl.OFC = 0;
 			ipuRegs.topbusy = 0;
@@ -935,7 +1024,7 @@ __noinline void IPUWorker()
 			break;
 
 		case SCE_IPU_BDEC:
-			if (!mpeg2_slice()) return;
+			if (!mpeg2_slice()) return false;
 
 			ipuRegs.topbusy = 0;
 			ipuRegs.cmd.BUSY = 0;
@@ -944,33 +1033,33 @@ __noinline void IPUWorker()
 			break;
 
 		case SCE_IPU_VDEC:
-			if (!ipuVDEC(ipu_cmd.current)) return;
+			if (!ipuVDEC(ipu_cmd.current)) return false;
 
 			ipuRegs.topbusy = 0;
 			ipuRegs.cmd.BUSY = 0;
 			break;
 
 		case SCE_IPU_FDEC:
-			if (!ipuFDEC(ipu_cmd.current)) return;
+			if (!ipuFDEC(ipu_cmd.current)) return false;
 
 			ipuRegs.topbusy = 0;
 			ipuRegs.cmd.BUSY = 0;
 			break;
 
 		case SCE_IPU_SETIQ:
-			if (!ipuSETIQ(ipu_cmd.current)) return;
+			if (!ipuSETIQ(ipu_cmd.current)) return false;
 			break;
 
 		case SCE_IPU_SETVQ:
-			if (!ipuSETVQ(ipu_cmd.current)) return;
+			if (!ipuSETVQ(ipu_cmd.current)) return false;
 			break;
 
 		case SCE_IPU_CSC:
-			if (!ipuCSC(ipu_cmd.current)) return;
+			if (!ipuCSC(ipu_cmd.current)) return false;
 			break;
 
 		case SCE_IPU_PACK:
-			if (!ipuPACK(ipu_cmd.current)) return;
+			if (!ipuPACK(ipu_cmd.current)) return false;
 			break;
 
 		jNO_DEFAULT
@@ -979,5 +1068,11 @@ __noinline void IPUWorker()
 	// success
 	ipuRegs.ctrl.BUSY = 0;
 	ipu_cmd.current = 0xffffffff;
-	hwIntcIrq(INTC_IPU);
+	return true;
+}
+
+__noinline void IPUWorker()
+{
+	if (ipuProcessCommand())
+		hwIntcIrq(INTC_IPU);
 }
@@ -294,6 +294,7 @@ extern bool ipuWrite64(u32 mem,u64 value);
 extern void IPUCMD_WRITE(u32 val);
 extern void ipuSoftReset();
 extern void IPUProcessInterrupt();
+extern bool ipuProcessCommand();
 
 extern u8 getBits128(u8 *address, bool advance);
 extern u8 getBits64(u8 *address, bool advance);
@@ -301,3 +302,37 @@ extern u8 getBits32(u8 *address, bool advance);
 extern u8 getBits16(u8 *address, bool advance);
 extern u8 getBits8(u8 *address, bool advance);
 
+// --------------------------------------------------------------------------------------
+//  IPU kernels
+// --------------------------------------------------------------------------------------
+// The IDCT and the colour conversion have several versions which all give the same
+// output.  ipuReset picks the best one the cpu supports.
+enum IPUKernelSet
+{
+	IPUKernels_Reference,	// scalar IDCT and colour conversion
+	IPUKernels_SSE2,		// scalar IDCT, SSE2 colour conversion
+	IPUKernels_SSE41,		// SSE4.1 IDCT, SSE2 colour conversion
+	IPUKernels_AVX2,		// AVX2 IDCT and colour conversion
+
+	IPUKernels_Count
+};
+
+extern IPUKernelSet ipuBestKernels();
+extern void ipuSelectKernels(IPUKernelSet set);
+extern const char* ipuKernelsName(IPUKernelSet set);
+
+// --------------------------------------------------------------------------------------
+//  IPU capture / benchmark (IPUBenchmark.cpp)
+// --------------------------------------------------------------------------------------
+// A capture records the commands and the input FIFO data from the next IPU reset on, and
+// can be replayed without a running game to measure the decoder.
+extern bool ipuCapturing;
+
+extern bool ipuCaptureOpen(const wxString& file);
+extern void ipuCaptureReset(bool full);
+extern void ipuCapturePause();
+extern void ipuCaptureCommand(u32 cmd);
+extern void ipuCaptureData(const u32* data, int qwc);
+
+extern bool RunIpuBenchmark(const wxString& file);
+
@@ -0,0 +1,393 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+
+#include "IPU.h"
+#include "mpeg2lib/Mpeg.h"
+
+#include <chrono>
+#include <deque>
+#include <wx/ffile.h>
+
+// --------------------------------------------------------------------------------------
+//  IPU capture
+// --------------------------------------------------------------------------------------
+// Started with --ipucapture=<file>.  Recording begins at the next IPU reset (boot, or the
+// soft reset games do before playing a movie), so that the replay starts from a known
+// decoder state.  Loading a savestate pauses it until the next reset.
+//
+// The file is a header followed by records, each one optionally followed by the input
+// FIFO data it carries:
+//
+//   Capture_Reset    arg0 = 1 for a full reset, 0 for a soft reset (IPU_CTRL.RST)
+//   Capture_Command  arg0 = IPU_CMD, arg1 = IPU_CTRL when the command was written
+//   Capture_Data     arg0 = qwc, followed by the qwc quadwords accepted by the FIFO
+//
+// Only data the FIFO accepted is recorded, whether it came from IPU1 DMA or from EE
+// writes, so the replay doesn't need to know anything about the DMAC.
+
+static const char IpuCaptureMagic[8] = { 'P','S','2','I','P','U','C','A' };
+static const u32 IpuCaptureVersion = 1;
+
+enum IpuCaptureType
+{
+	Capture_Reset,
+	Capture_Command,
+	Capture_Data,
+};
+
+#ifdef _MSC_VER
+#	pragma pack(1)
+#endif
+
+struct IpuCaptureHeader
+{
+	char	magic[8];
+	u32		version;
+} __packed;
+
+struct IpuCaptureRecord
+{
+	u32		type;
+	u32		arg0;
+	u32		arg1;
+} __packed;
+
+#ifdef _MSC_VER
+#	pragma pack()
+#endif
+
+bool ipuCapturing = false;
+
+static wxFFile s_capture;
+static u64 s_captureRecords = 0;
+
+static void CaptureWrite(const IpuCaptureRecord& rec, const void* data = NULL, size_t size = 0)
+{
+	if (s_capture.Write(&rec, sizeof(rec)) != sizeof(rec) || (size && s_capture.Write(data, size) != size))
+	{
+		Console.Error("IPU capture: write failed, capture stopped after %llu records.", (unsigned long long)s_captureRecords);
+		s_capture.Close();
+		ipuCapturing = false;
+		return;
+	}
+
+	s_captureRecords++;
+}
+
+bool ipuCaptureOpen(const wxString& file)
+{
+	if (!s_capture.Open(file, L"wb"))
+	{
+		Console.Error(L"IPU capture: can't create '%s'", WX_STR(file));
+		return false;
+	}
+
+	IpuCaptureHeader header;
+	memcpy(header.magic, IpuCaptureMagic, sizeof(header.magic));
+	header.version = IpuCaptureVersion;
+	s_capture.Write(&header, sizeof(header));
+
+	Console.WriteLn(L"IPU capture: '%s' will be recorded from the next IPU reset.", WX_STR(file));
+	return true;
+}
+
+void ipuCaptureReset(bool full)
+{
+	if (!s_capture.IsOpened()) return;
+
+	if (!ipuCapturing)
+	{
+		Console.WriteLn(Color_StrongBlack, "IPU capture: recording (%s reset).", full ? "full" : "soft");
+		ipuCapturing = true;
+	}
+
+	IpuCaptureRecord rec = { Capture_Reset, full, 0 };
+	CaptureWrite(rec);
+	s_capture.Flush();
+}
+
+void ipuCapturePause()
+{
+	if (!ipuCapturing) return;
+
+	Console.WriteLn("IPU capture: paused until the next IPU reset.");
+	ipuCapturing = false;
+	s_capture.Flush();
+}
+
+void ipuCaptureCommand(u32 cmd)
+{
+	IpuCaptureRecord rec = { Capture_Command, cmd, ipuRegs.ctrl._u32 };
+	CaptureWrite(rec);
+}
+
+void ipuCaptureData(const u32* data, int qwc)
+{
+	IpuCaptureRecord rec = { Capture_Data, (u32)qwc, 0 };
+	CaptureWrite(rec, data, qwc * 16);
+}
+
+// --------------------------------------------------------------------------------------
+//  IPU benchmark
+// --------------------------------------------------------------------------------------
+// --ipubench=<file> replays a capture with each kernel set the cpu supports and reports
+// the decoding speed.  The output FIFO contents are hashed, so a kernel set which doesn't
+// give the same output as the reference one is reported as well.
+//
+// The IPU runs as fast as it can: input is pushed as soon as the FIFO has room, and the
+// output FIFO is drained after every step.  That only changes when things happen, not
+// what gets decoded.
+
+struct IpuReplay
+{
+	struct Pending
+	{
+		const u8* data;
+		uint qwc;
+	};
+
+	std::deque<Pending> pending;	// recorded data the input FIFO has no room for yet
+	u32 cmd;						// last command written
+	u64 hash;
+	u64 output_qwc;
+	double macroblocks;
+	uint commands;
+	uint dropped_qwc;
+};
+
+// Output quadwords per macroblock of a command, 0 if it doesn't output macroblocks.
+static uint MacroblockQwc(u32 cmd)
+{
+	const bool ofm = (cmd >> 27) & 1;
+
+	switch (cmd >> 28)
+	{
+		case SCE_IPU_IDEC:
+		case SCE_IPU_CSC:	return ofm ? 32 : 64;
+		case SCE_IPU_BDEC:	return 48;
+		case SCE_IPU_PACK:	return ofm ? 32 : 8;
+	}
+	return 0;
+}
+
+static void DrainOutput(IpuReplay& replay)
+{
+	const uint qwc = ipuRegs.ctrl.OFC;
+	u128 buffer[8];
+	ipu_fifo.out.read(buffer, qwc);
+
+	// FNV-1a
+	const u32* words = (u32*)buffer;
+	for (uint i = 0; i < qwc * 4; i++)
+	{
+		replay.hash ^= words[i];
+		replay.hash *= 0x100000001b3ULL;
+	}
+
+	replay.output_qwc += qwc;
+	if (const uint mbqwc = MacroblockQwc(replay.cmd))
+		replay.macroblocks += (double)qwc / mbqwc;
+}
+
+// Runs the IPU until it has nothing left to do with the data it was given.
+static void Pump(IpuReplay& replay)
+{
+	bool progress;
+
+	do
+	{
+		progress = false;
+
+		while (!replay.pending.empty())
+		{
+			IpuReplay::Pending& p = replay.pending.front();
+			const int qwc = ipu_fifo.in.write((u32*)p.data, p.qwc);
+			if (qwc == 0) break;
+
+			p.data += qwc * 16;
+			p.qwc -= qwc;
+			if (!p.qwc) replay.pending.pop_front();
+			progress = true;
+		}
+
+		if (ipuRegs.ctrl.BUSY)
+		{
+			const tIPU_cmd cmd = ipu_cmd;
+			const tIPU_BP bp = g_BP;
+
+			IPUProcessInterrupt();
+
+			progress |= !ipuRegs.ctrl.BUSY
+				|| memcmp(&cmd, &ipu_cmd, sizeof(cmd))
+				|| memcmp(&bp, &g_BP, sizeof(bp));
+		}
+
+		if (ipuRegs.ctrl.OFC)
+		{
+			DrainOutput(replay);
+			progress = true;
+		}
+	} while (progress);
+}
+
+static void DropPending(IpuReplay& replay)
+{
+	for (const IpuReplay::Pending& p : replay.pending)
+		replay.dropped_qwc += p.qwc;
+	replay.pending.clear();
+}
+
+static void Replay(const std::vector<u8>& capture, IPUKernelSet set, IpuReplay& replay)
+{
+	replay.pending.clear();
+	replay.cmd = 0xffffffff;
+	replay.hash = 0xcbf29ce484222325ULL;
+	replay.output_qwc = 0;
+	replay.macroblocks = 0;
+	replay.commands = 0;
+	replay.dropped_qwc = 0;
+
+	ipuReset();
+	ipuSelectKernels(set);
+
+	size_t pos = sizeof(IpuCaptureHeader);
+	while (pos + sizeof(IpuCaptureRecord) <= capture.size())
+	{
+		IpuCaptureRecord rec;
+		memcpy(&rec, &capture[pos], sizeof(rec));
+		pos += sizeof(rec);
+
+		switch (rec.type)
+		{
+			case Capture_Reset:
+				// The game threw away whatever was still in flight.
+				Pump(replay);
+				DropPending(replay);
+				if (rec.arg0)
+				{
+					ipuReset();
+					ipuSelectKernels(set);
+				}
+				else
+					ipuSoftReset();
+				break;
+
+			case Capture_Command:
+				Pump(replay);
+				if ((rec.arg0 >> 28) == SCE_IPU_BCLR)
+					DropPending(replay);
+
+				// Only the decoding mode bits, the FIFO counters and BUSY are the replay's own.
+				ipuRegs.ctrl._u32 = (ipuRegs.ctrl._u32 & ~0x07f30000) | (rec.arg1 & 0x07f30000);
+				IPUCMD_WRITE(rec.arg0);
+				replay.cmd = rec.arg0;
+				replay.commands++;
+				Pump(replay);
+				break;
+
+			case Capture_Data:
+			{
+				if (pos + rec.arg0 * 16 > capture.size()) break;
+
+				IpuReplay::Pending p = { &capture[pos], rec.arg0 };
+				replay.pending.push_back(p);
+				pos += rec.arg0 * 16;
+				Pump(replay);
+				break;
+			}
+		}
+	}
+
+	Pump(replay);
+	DropPending(replay);
+}
+
+bool RunIpuBenchmark(const wxString& file)
+{
+	std::vector<u8> capture;
+	{
+		wxFFile in(file, L"rb");
+		if (!in.IsOpened())
+		{
+			Console.Error(L"IPU bench: can't open capture '%s'", WX_STR(file));
+			return false;
+		}
+
+		capture.resize(in.Length());
+		if (capture.empty() || in.Read(capture.data(), capture.size()) != capture.size())
+		{
+			Console.Error(L"IPU bench: can't read capture '%s'", WX_STR(file));
+			return false;
+		}
+	}
+
+	IpuCaptureHeader header;
+	memzero(header);
+	if (capture.size() >= sizeof(header))
+		memcpy(&header, capture.data(), sizeof(header));
+
+	if (memcmp(header.magic, IpuCaptureMagic, sizeof(header.magic)) || header.version != IpuCaptureVersion)
+	{
+		Console.Error(L"IPU bench: '%s' isn't an IPU capture.", WX_STR(file));
+		return false;
+	}
+
+	// Runs before the cpu is detected by the app.
+	x86caps.Identify();
+
+	IpuReplay replay;
+	u64 reference_hash = 0;
+	bool mismatch = false;
+
+	Console.WriteLn(L"IPU bench: replaying '%s' (%.1f MB)", WX_STR(file), capture.size() / (1024.0 * 1024.0));
+
+	for (int i = 0; i <= ipuBestKernels(); i++)
+	{
+		const IPUKernelSet set = (IPUKernelSet)i;
+
+		// Short captures are replayed until it takes a second, for stable numbers.
+		uint passes = 0;
+		double total = 0;
+		do
+		{
+			const auto start = std::chrono::steady_clock::now();
+			Replay(capture, set, replay);
+			total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			passes++;
+		} while (total < 1.0);
+
+		if (i == 0)
+		{
+			reference_hash = replay.hash;
+			Console.WriteLn("IPU bench: %u commands, %.0f macroblocks, %.1f MB output, %u input qwc dropped",
+				replay.commands, replay.macroblocks, replay.output_qwc / (64.0 * 1024.0), replay.dropped_qwc);
+		}
+
+		const double pass = total / passes;
+		const bool same = replay.hash == reference_hash;
+		mismatch |= !same;
+
+		Console.WriteLn(same ? Color_StrongGreen : Color_StrongRed,
+			"IPU bench: %-9s %8.3f ms/pass  %9.0f macroblocks/s  %7.1f MB/s  output %016llx%s",
+			ipuKernelsName(set), pass * 1000, replay.macroblocks / pass, replay.output_qwc / (64.0 * 1024.0) / pass,
+			(unsigned long long)replay.hash, same ? "" : " (differs from the reference!)");
+	}
+
+	ipuReset();
+	return !mismatch;
+}
@@ -0,0 +1,514 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+
+#include "IPUThread.h"
+#include "IPUdma.h"
+
+#include <thread>
+
+// --------------------------------------------------------------------------------------
+//  IPU decode-ahead
+// --------------------------------------------------------------------------------------
+// When an IDEC, BDEC or CSC command is running and IPU1 DMA is sending data, the rest of
+// the current DMA transfer is copied (mirrored) and the worker decodes it with the normal
+// decoder, straight into an output queue much deeper than the 8 qword output FIFO.  The
+// worker only stops when it runs out of mirrored data or the queue is full.
+//
+// The EE side keeps running IPU1 and IPU0 DMA as usual, with these rules:
+//
+//  * Data sent by IPU1 DMA is compared with the mirror.  The input FIFO takes what the
+//    inline FIFO would (the worker counts how far the decoder has read).
+//  * An output qword can only be read by IPU0 DMA once all the input the decoder had read
+//    when making it has been sent, so no output is based on data the DMA hasn't sent yet.
+//  * The command completes (BUSY clears, IPU interrupt) when the worker is done with the
+//    input sent so far, and no more than a FIFO worth of output is left.
+//
+// At that point the worker state is one the inline decoder could have reached, and is
+// kept as is.  The same goes for Stop() as long as the worker hasn't read past the data
+// sent so far.  Otherwise (the game changed the data after it was mirrored, or wants to
+// look at the decoder state) the state is restored from the checkpoint taken when the
+// session started, and the data sent so far is decoded again on the EE thread.
+//
+// Only the timing of the output differs from the inline decoder: the DMAs see the output
+// earlier, like if the IPU was faster.
+
+__aligned16 IPU_Thread ipuThread;
+
+// Iterations the EE spins while waiting for the worker before yielding its timeslice
+static const int IPU_SpinCount = 1024;
+
+IPU_Thread::IPU_Thread()
+{
+	m_name = L"IPU decode";
+
+	m_ato_kick = 0;
+	m_ato_idle = 0;
+	m_parked = false;
+	m_ato_abort = false;
+
+	m_active = false;
+	Reset();
+}
+
+IPU_Thread::~IPU_Thread()
+{
+	try {
+		pxThread::Cancel();
+	}
+	DESTRUCTOR_CATCHALL
+}
+
+void IPU_Thread::Reset()
+{
+	if (m_active)
+	{
+		Abort();
+		m_active = false;
+	}
+
+	m_hold = false;
+	m_backlog_pos = 0;
+	m_backlog_end = 0;
+}
+
+// --------------------------------------------------------------------------------------
+//  Worker
+// --------------------------------------------------------------------------------------
+
+// Same handshake as MTVU: only the side that clears the parked flag posts the semaphore.
+void IPU_Thread::ExecuteTaskInThread()
+{
+	u32 kick = 0;
+
+	for (;;)
+	{
+		m_parked.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_ato_kick.load(std::memory_order_relaxed) == kick || !m_parked.exchange(false))
+			semaEvent.WaitWithoutYield();
+
+		kick = m_ato_kick.load(std::memory_order_acquire);
+		Run();
+		m_ato_idle.store(kick, std::memory_order_release);
+	}
+}
+
+// Decodes until the mirrored data or the room in the queue runs out.
+void IPU_Thread::Run()
+{
+	if (!m_active) return;
+
+	bool progress;
+	do
+	{
+		if (m_ato_abort.load(std::memory_order_relaxed)) return;
+		progress = false;
+
+		const uint len = m_ato_stream_len.load(std::memory_order_acquire);
+		if (m_fed < len)
+		{
+			const int qwc = ipu_fifo.in.write((u32*)&m_stream[m_fed], len - m_fed);
+			m_fed += qwc;
+			progress |= qwc > 0;
+		}
+
+		bool completed = false;
+		if (ipuRegs.ctrl.BUSY)
+		{
+			const tIPU_cmd cmd = ipu_cmd;
+			const tIPU_BP bp = g_BP;
+
+			completed = ipuProcessCommand();
+
+			progress |= completed
+				|| memcmp(&cmd, &ipu_cmd, sizeof(cmd))
+				|| memcmp(&bp, &g_BP, sizeof(bp));
+		}
+
+		const uint consumed = m_fed - g_BP.IFC;
+		m_ato_consumed.store(consumed, std::memory_order_release);
+		if (completed) m_done_tag = consumed;
+
+		const uint drained = m_ato_drained.load(std::memory_order_acquire);
+		while (ipuRegs.ctrl.OFC && m_produced - drained < queue_size)
+		{
+			const uint slot = m_produced & (queue_size - 1);
+			const uint qwc = std::min({ (uint)ipuRegs.ctrl.OFC, queue_size - (m_produced - drained), queue_size - slot });
+
+			ipu_fifo.out.read(&m_queue[slot], qwc);
+			for (uint i = 0; i < qwc; i++)
+				m_tags[slot + i] = consumed;
+
+			m_produced += qwc;
+			progress = true;
+		}
+
+		m_ato_produced.store(m_produced, std::memory_order_release);
+		if (completed) m_ato_done.store(true, std::memory_order_release);
+	} while (progress);
+}
+
+// --------------------------------------------------------------------------------------
+//  EE side
+// --------------------------------------------------------------------------------------
+
+void IPU_Thread::Kick()
+{
+	m_ato_kick.fetch_add(1, std::memory_order_release);
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_parked.load(std::memory_order_relaxed) && m_parked.exchange(false))
+		semaEvent.Post();
+}
+
+bool IPU_Thread::IsIdle() const
+{
+	return m_ato_idle.load(std::memory_order_acquire) == m_ato_kick.load(std::memory_order_relaxed);
+}
+
+void IPU_Thread::WaitIdle()
+{
+	for (int spins = 0; !IsIdle(); spins++)
+	{
+		if (spins < IPU_SpinCount) SpinWait();
+		else std::this_thread::yield();
+	}
+}
+
+void IPU_Thread::Abort()
+{
+	m_ato_abort.store(true, std::memory_order_relaxed);
+	Kick();
+	WaitIdle();
+}
+
+// Input FIFO count: data sent by IPU1 DMA which the decoder hasn't read yet.
+uint IPU_Thread::GetIFC() const
+{
+	const uint consumed = m_ato_consumed.load(std::memory_order_acquire);
+	return consumed < m_delivered ? std::min(m_delivered - consumed, 8u) : 0;
+}
+
+void IPU_Thread::UpdateReleased()
+{
+	const uint produced = m_ato_produced.load(std::memory_order_acquire);
+
+	while (m_released < produced && m_tags[m_released & (queue_size - 1)] <= m_delivered)
+		m_released++;
+}
+
+bool IPU_Thread::Begin()
+{
+	if (!EmuConfig.Speedhacks.ipuThread || m_hold || ipuCapturing || HasBacklog()) return false;
+
+	switch (ipu_cmd.CMD)
+	{
+		case SCE_IPU_IDEC:
+		case SCE_IPU_BDEC:
+		case SCE_IPU_CSC:
+			break;
+
+		default:
+			return false;
+	}
+
+	// Nothing to decode ahead unless IPU1 DMA is in the middle of a transfer.
+	if (!ipu1ch.chcr.STR || ipu1ch.qwc == 0) return false;
+
+	const u128* src = (u128*)dmaGetAddr(ipu1ch.madr, false);
+	if (!src) return false;
+
+	if (!IsRunning()) Start();
+
+	m_checkpoint.bp = g_BP;
+	m_checkpoint.decoder = decoder;
+	m_checkpoint.cmd = ipu_cmd;
+	m_checkpoint.fifo = ipu_fifo;
+	memcpy(&m_checkpoint.regs, &ipuRegs, sizeof(IPUregisters));
+	m_checkpoint.coded_block_pattern = coded_block_pattern;
+	m_checkpoint.mbaCount = mbaCount;
+
+	// The stream starts with the data already in the input FIFO, which stays there.
+	uint len = 0;
+	for (uint i = 0; i < g_BP.IFC; i++)
+		CopyQWC(&m_stream[len++], &ipu_fifo.in.data[(ipu_fifo.in.readpos + i * 4) & 31]);
+
+	const uint qwc = std::min<uint>(ipu1ch.qwc, stream_size - len);
+	memcpy(&m_stream[len], src, qwc * 16);
+	len += qwc;
+
+	m_fed = g_BP.IFC;
+	m_delivered = g_BP.IFC;
+
+	// And the output queue starts with the output FIFO.
+	m_produced = ipuRegs.ctrl.OFC;
+	if (m_produced)
+	{
+		ipu_fifo.out.read(m_queue, m_produced);
+		for (uint i = 0; i < m_produced; i++)
+			m_tags[i] = 0;
+	}
+
+	m_drained = 0;
+	m_released = m_produced;
+	m_done_tag = 0;
+	m_ctrl = ipuRegs.ctrl._u32;
+
+	m_ato_stream_len.store(len, std::memory_order_relaxed);
+	m_ato_drained.store(0, std::memory_order_relaxed);
+	m_ato_consumed.store(0, std::memory_order_relaxed);
+	m_ato_produced.store(m_produced, std::memory_order_relaxed);
+	m_ato_done.store(false, std::memory_order_relaxed);
+	m_ato_abort.store(false, std::memory_order_relaxed);
+
+	IPU_LOG("IPU decode-ahead: command %08x, %u qwords mirrored", ipu_cmd.current, len);
+
+	m_active = true;
+	Kick();
+	return true;
+}
+
+void IPU_Thread::Update()
+{
+	// Where the inline decoder would have filled the output FIFO, or run out of input
+	// (the worker has read past the data sent), so has the worker.  Otherwise wait for it.
+	for (int spins = 0;; spins++)
+	{
+		const bool idle = IsIdle();
+		UpdateReleased();
+
+		if (idle || m_released - m_drained >= 8 || m_ato_consumed.load(std::memory_order_acquire) > m_delivered)
+			break;
+
+		if (spins < IPU_SpinCount) SpinWait();
+		else std::this_thread::yield();
+	}
+
+	if (m_ato_done.load(std::memory_order_acquire) && m_done_tag <= m_delivered)
+	{
+		// The worker may still be moving the last output into the queue.
+		WaitIdle();
+		if (CanAdopt())
+		{
+			Adopt();
+			return;
+		}
+	}
+
+	// The inline FIFO read restarts a waiting IPU1 DMA once the FIFO runs low.
+	if (cpuRegs.eCycle[4] == 0x9999 && GetIFC() < 3)
+		CPU_INT(DMAC_TO_IPU, 32);
+}
+
+int IPU_Thread::Deliver(const u32* data, int qwc)
+{
+	// The input FIFO takes what the inline one would, wait if the worker is behind.
+	for (int spins = 0; GetIFC() == 8 && !IsIdle(); spins++)
+	{
+		if (spins < IPU_SpinCount) SpinWait();
+		else std::this_thread::yield();
+	}
+
+	const uint room = 8 - GetIFC();
+	uint len = m_ato_stream_len.load(std::memory_order_relaxed);
+
+	// A new transfer (DMA tag): mirror it for the worker.
+	if (m_delivered + qwc > len && len < stream_size)
+	{
+		const uint count = std::min<uint>(m_delivered + qwc, stream_size) - len;
+		memcpy(&m_stream[len], (const u128*)data + (len - m_delivered), count * 16);
+		len += count;
+
+		m_ato_stream_len.store(len, std::memory_order_release);
+		Kick();
+	}
+
+	const uint sent = std::min({ (uint)qwc, room, len - m_delivered });
+
+	if (!sent && room)
+	{
+		// The mirror is full, continue inline.
+		Stop();
+		return FlushBacklog() ? ipu_fifo.in.write((u32*)data, qwc) : 0;
+	}
+
+	if (memcmp(&m_stream[m_delivered], data, sent * 16))
+	{
+		// The data was changed after it was mirrored.
+		Abort();
+		memcpy(&m_stream[m_delivered], data, sent * 16);
+		m_delivered += sent;
+		Replay();
+		return sent;
+	}
+
+	m_delivered += sent;
+	return sent;
+}
+
+void IPU_Thread::ReadOutput(void* dest, uint qwc)
+{
+	pxAssert(qwc <= GetOFC());
+
+	for (uint i = 0; i < qwc; i++)
+		CopyQWC((u128*)dest + i, &m_queue[(m_drained + i) & (queue_size - 1)]);
+
+	m_drained += qwc;
+	m_ato_drained.store(m_drained, std::memory_order_release);
+	Kick();
+}
+
+u32 IPU_Thread::ReadCtrl() const
+{
+	tIPU_CTRL ctrl(m_ctrl);
+	ctrl.IFC = GetIFC();
+	ctrl.OFC = GetOFC();
+	ctrl.CBP = m_checkpoint.coded_block_pattern;
+	ctrl.BUSY = 1;
+	return ctrl._u32;
+}
+
+bool IPU_Thread::FlushBacklog()
+{
+	if (!HasBacklog()) return true;
+
+	m_backlog_pos += ipu_fifo.in.write((u32*)&m_stream[m_backlog_pos], m_backlog_end - m_backlog_pos);
+	return !HasBacklog();
+}
+
+void IPU_Thread::FreezeBacklog(SaveStateBase& state)
+{
+	u32 qwc = m_backlog_end - m_backlog_pos;
+	state.Freeze(qwc);
+
+	if (state.IsLoading())
+	{
+		if (qwc > stream_size)
+			throw Exception::SaveStateLoadError().SetDiagMsg(L"IPU decode-ahead: invalid input backlog size");
+
+		m_backlog_pos = 0;
+		m_backlog_end = qwc;
+	}
+
+	if (qwc) state.FreezeMem(&m_stream[m_backlog_pos], qwc * 16);
+}
+
+void IPU_Thread::Stop()
+{
+	if (!m_active) return;
+
+	Abort();
+	if (CanAdopt()) Adopt();
+	else Replay();
+}
+
+// Worker idle: is its state one the inline decoder could have with the data sent so far?
+bool IPU_Thread::CanAdopt() const
+{
+	return m_ato_consumed.load(std::memory_order_relaxed) <= m_delivered
+		&& m_produced - m_drained + ipuRegs.ctrl.OFC <= 8;
+}
+
+void IPU_Thread::Adopt()
+{
+	// The input FIFO of the worker may hold mirrored data which hasn't been sent yet.
+	const uint consumed = m_ato_consumed.load(std::memory_order_relaxed);
+	ipu_fifo.in.clear();
+	ipu_fifo.in.write((u32*)&m_stream[consumed], m_delivered - consumed);
+
+	// What's left of the queue, then what the worker hadn't moved out of its FIFO.
+	__aligned16 u128 pending[8];
+	const uint ofc = ipuRegs.ctrl.OFC;
+	ipu_fifo.out.read(pending, ofc);
+	ipu_fifo.out.clear();
+
+	for (uint i = m_drained; i < m_produced; i++)
+		ipu_fifo.out.write((u32*)&m_queue[i & (queue_size - 1)], 1);
+	if (ofc) ipu_fifo.out.write((u32*)pending, ofc);
+
+	m_active = false;
+
+	if (m_ato_done.load(std::memory_order_relaxed))
+		hwIntcIrq(INTC_IPU);
+}
+
+// Falls back to the inline decoder: decodes the data sent since the checkpoint again,
+// without the output IPU0 DMA already has.
+void IPU_Thread::Replay()
+{
+	IPU_LOG("IPU decode-ahead: falling back to inline decoding, %u qwords sent, %u read", m_delivered, m_drained);
+
+	m_active = false;
+	m_hold = true;
+
+	g_BP = m_checkpoint.bp;
+	decoder = m_checkpoint.decoder;
+	ipu_cmd = m_checkpoint.cmd;
+	ipu_fifo = m_checkpoint.fifo;
+	memcpy(&ipuRegs, &m_checkpoint.regs, sizeof(IPUregisters));
+	coded_block_pattern = m_checkpoint.coded_block_pattern;
+	mbaCount = m_checkpoint.mbaCount;
+
+	uint fed = m_checkpoint.bp.IFC;
+	uint skip = m_drained;
+	bool completed = false;
+	bool progress;
+
+	do
+	{
+		progress = false;
+
+		if (fed < m_delivered)
+		{
+			const int qwc = ipu_fifo.in.write((u32*)&m_stream[fed], m_delivered - fed);
+			fed += qwc;
+			progress |= qwc > 0;
+		}
+
+		if (ipuRegs.ctrl.BUSY)
+		{
+			const tIPU_cmd cmd = ipu_cmd;
+			const tIPU_BP bp = g_BP;
+
+			completed |= ipuProcessCommand();
+
+			progress |= !ipuRegs.ctrl.BUSY
+				|| memcmp(&cmd, &ipu_cmd, sizeof(cmd))
+				|| memcmp(&bp, &g_BP, sizeof(bp));
+		}
+
+		if (skip && ipuRegs.ctrl.OFC)
+		{
+			__aligned16 u128 discard[8];
+			const uint qwc = std::min<uint>(skip, ipuRegs.ctrl.OFC);
+			ipu_fifo.out.read(discard, qwc);
+			skip -= qwc;
+			progress = true;
+		}
+	} while (progress);
+
+	if (skip)
+		DevCon.Warning("IPU decode-ahead: inline decoding gave %u qwords less output than the worker", skip);
+
+	// Data the FIFO had no room for yet.  Only happens when the output is stalled, and
+	// sent before any new IPU1 DMA data.
+	m_backlog_pos = fed;
+	m_backlog_end = m_delivered;
+
+	if (completed) hwIntcIrq(INTC_IPU);
+}
@@ -0,0 +1,145 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utilities/PersistentThread.h"
+#include "IPU.h"
+#include "mpeg2lib/Mpeg.h"
+
+// --------------------------------------------------------------------------------------
+//  IPU_Thread  (IPU decode-ahead, Speedhacks.ipuThread)
+// --------------------------------------------------------------------------------------
+// Runs IDEC, BDEC and CSC commands on a worker thread, ahead of the EE.  See IPUThread.cpp
+// for how the EE side keeps the IPU state the game sees consistent.
+//
+// While a command is decoded ahead (IsActive) the worker owns the IPU decoder state:
+// g_BP, decoder, ipu_cmd, ipu_fifo and the IPU registers.  The EE must go through this
+// class for anything touching them, and call Stop() before anything else.
+//
+// All the public functions are for the EE thread (or with the EE thread suspended).
+class IPU_Thread : public pxThread
+{
+	// Input stream mirrored since the start of the session (the input FIFO contents,
+	// then the IPU1 DMA transfers), in qwords.
+	static const uint stream_size = _1mb / 16;
+	// Decoded output waiting to be read by IPU0 DMA, in qwords (power of 2)
+	static const uint queue_size  = _64kb / 16;
+
+	// IPU state when the session started, for the fallback to the inline decoder
+	struct Checkpoint
+	{
+		tIPU_BP		bp;
+		decoder_t	decoder;
+		tIPU_cmd	cmd;
+		IPU_Fifo	fifo;
+		IPUregisters regs;
+		int			coded_block_pattern;
+		int			mbaCount;
+	};
+
+	__aligned16 u128 m_stream[stream_size];
+	__aligned16 u128 m_queue[queue_size];
+	u32 m_tags[queue_size];		// stream position the decoder had read up to when each output qword was made
+
+	__aligned16 Checkpoint m_checkpoint;
+
+	// Note: keep atomics on separate cache lines to avoid cpu conflicts
+	__aligned(64) std::atomic<uint> m_ato_stream_len;	// Only modified by the EE thread
+	__aligned(64) std::atomic<uint> m_ato_drained;		// Only modified by the EE thread
+	__aligned(64) std::atomic<uint> m_ato_consumed;		// Only modified by the worker
+	__aligned(64) std::atomic<uint> m_ato_produced;		// Only modified by the worker
+	__aligned(64) std::atomic<bool> m_ato_done;			// Only modified by the worker
+	__aligned(64) std::atomic<bool> m_ato_abort;
+	__aligned(64) std::atomic<u32>  m_ato_kick;			// bumped whenever the worker has something new to look at
+	__aligned(64) std::atomic<u32>  m_ato_idle;			// last kick the worker has fully processed
+	__aligned(64) std::atomic<bool> m_parked;			// worker is (about to be) asleep on semaEvent
+	Semaphore semaEvent;
+
+	// Worker side (set up by the EE thread while the worker is idle)
+	uint m_fed;			// stream qwords written into the input FIFO
+	uint m_produced;	// output qwords written to the queue
+	uint m_done_tag;	// stream position the decoder had read up to when the command finished
+
+	// EE side
+	bool m_active;
+	bool m_hold;		// no decode-ahead until the next command (the last one fell back)
+	uint m_delivered;	// stream qwords sent by IPU1 DMA (and checked against the mirror)
+	uint m_drained;		// output qwords read by IPU0 DMA
+	uint m_released;	// output qwords IPU0 DMA is allowed to read
+	u32  m_ctrl;		// IPU_CTRL when the session started
+
+	// Input left over by a fallback (m_stream range), fed to the FIFO before any new data
+	uint m_backlog_pos;
+	uint m_backlog_end;
+
+public:
+	IPU_Thread();
+	virtual ~IPU_Thread();
+
+	// Drops the session without touching the IPU state (resets, savestate loads)
+	void Reset();
+
+	bool IsActive() const { return m_active; }
+
+	// Starts decoding the current command ahead if possible, returns false if the EE
+	// should decode it inline.
+	bool Begin();
+
+	// Brings the IPU state in line with what the inline decoder would have, and stops the
+	// session.  Used before the EE accesses the IPU state directly.
+	void Stop();
+
+	// Called where the inline decoder would run (IPUProcessInterrupt), waits for the
+	// worker to catch up and ends the session once the command has completed.
+	void Update();
+
+	// IPU1 DMA data, returns the number of qwords the input FIFO takes.
+	int Deliver(const u32* data, int qwc);
+
+	// Output FIFO count as seen by IPU0 DMA, and the read of that output.
+	uint GetOFC() const { return std::min(m_released - m_drained, 8u); }
+	void ReadOutput(void* dest, uint qwc);
+
+	// IPU_CTRL as the game sees it during a session
+	u32 ReadCtrl() const;
+
+	// Moves the fallback leftovers into the input FIFO, returns true once there is none.
+	bool FlushBacklog();
+	void OnCommand() { m_hold = false; }
+	bool HasBacklog() const { return m_backlog_pos != m_backlog_end; }
+
+	// The fallback leftovers were already sent by IPU1 DMA, so they're part of the state.
+	void FreezeBacklog(SaveStateBase& state);
+
+protected:
+	void ExecuteTaskInThread();
+
+private:
+	void Run();
+	void Kick();
+	bool IsIdle() const;
+	void WaitIdle();
+	void Abort();
+
+	uint GetIFC() const;
+	void UpdateReleased();
+
+	bool CanAdopt() const;
+	void Adopt();
+	void Replay();
+};
+
+extern __aligned16 IPU_Thread ipuThread;
@@ -18,6 +18,7 @@
 #include "IPU.h"
 #include "IPU/IPUdma.h"
 #include "mpeg2lib/Mpeg.h"
+#include "IPUThread.h"
 
 __aligned16 IPU_Fifo ipu_fifo;
 
@@ -69,6 +70,8 @@ int IPU_Fifo_Input::write(u32* pMem, int size)
 	int transsize;
 	int firsttrans = std::min(size, 8 - (int)g_BP.IFC);
 
+	if (ipuCapturing && firsttrans > 0) ipuCaptureData(pMem, firsttrans);
+
 	g_BP.IFC += firsttrans;
 	transsize = firsttrans;
 
@@ -88,7 +91,8 @@ int IPU_Fifo_Input::read(void *value)
 	if (g_BP.IFC < 3)
 	{
 		// IPU FIFO is empty and DMA is waiting so lets tell the DMA we are ready to put data in the FIFO
-		if(cpuRegs.eCycle[4] == 0x9999)
+		// (the decode-ahead thread leaves that to IPU_Thread::Update, on the EE thread)
+		if(!ipuThread.IsActive() && cpuRegs.eCycle[4] == 0x9999)
 		{
 			CPU_INT( DMAC_TO_IPU, 32 );
 		}
@@ -151,6 +155,7 @@ void IPU_Fifo_Output::read(void *value, uint size)
 
 void __fastcall ReadFIFO_IPUout(mem128_t* out)
 {
+	ipuThread.Stop();
 	if (!pxAssertDev( ipuRegs.ctrl.OFC > 0, "Attempted read from IPUout's FIFO, but the FIFO is empty!" )) return;
 	ipu_fifo.out.read(out, 1);
 
@@ -162,8 +167,10 @@ void __fastcall WriteFIFO_IPUin(const mem128_t* value)
 {
 	IPU_LOG( "WriteFIFO/IPUin <- %ls", WX_STR(value->ToString()) );
 
+	ipuThread.Stop();
+
 	//committing every 16 bytes
-	if( ipu_fifo.in.write((u32*)value, 1) == 0 )
+	if( !ipuThread.FlushBacklog() || ipu_fifo.in.write((u32*)value, 1) == 0 )
 	{
 		IPUProcessInterrupt();
 	}
@@ -18,6 +18,7 @@
 #include "IPU.h"
 #include "IPU/IPUdma.h"
 #include "mpeg2lib/Mpeg.h"
+#include "IPUThread.h"
 
 #include "Vif.h"
 #include "Gif.h"
@@ -90,8 +91,11 @@ static __fi int IPU1chain() {
 			return totalqwc;
 		}
 
-		//Write our data to the fifo
-		qwc = ipu_fifo.in.write(pMem, qwc);
+		//Write our data to the fifo (or hand it to the decode-ahead thread)
+		if (ipuThread.IsActive())
+			qwc = ipuThread.Deliver(pMem, qwc);
+		else
+			qwc = ipuThread.FlushBacklog() ? ipu_fifo.in.write(pMem, qwc) : 0;
 		ipu1ch.madr += qwc << 4;
 		ipu1ch.qwc -= qwc;
 		totalqwc += qwc;
@@ -194,7 +198,11 @@ int IPU1dma()
 
 void IPU0dma()
 {
-	if(!ipuRegs.ctrl.OFC) 
+	if (ipuThread.IsActive()) ipuThread.Update();
+
+	const uint ofc = ipuThread.IsActive() ? ipuThread.GetOFC() : ipuRegs.ctrl.OFC;
+
+	if(!ofc) 
 	{
 		IPU_INT_FROM( 64 );
 		IPUProcessInterrupt();
@@ -219,8 +227,11 @@ void IPU0dma()
 
 	pMem = dmaGetAddr(ipu0ch.madr, true);
 
-	readsize = std::min(ipu0ch.qwc, (u16)ipuRegs.ctrl.OFC);
-	ipu_fifo.out.read(pMem, readsize);
+	readsize = std::min(ipu0ch.qwc, (u16)ofc);
+	if (ipuThread.IsActive())
+		ipuThread.ReadOutput(pMem, readsize);
+	else
+		ipu_fifo.out.read(pMem, readsize);
 
 	ipu0ch.madr += readsize << 4;
 	ipu0ch.qwc -= readsize; // note: qwc is u16
@@ -253,7 +264,7 @@ void IPU0dma()
 		//Note that interrupting based on totalsize is just guessing..
 	
 	IPU_INT_FROM( readsize * BIAS );
-	if(ipuRegs.ctrl.IFC > 0) IPUProcessInterrupt();
+	if(ipuThread.IsActive() || ipuRegs.ctrl.IFC > 0) IPUProcessInterrupt();
 
 	//return readsize;
 }
@@ -22,9 +22,9 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-// [TODO] : There are modern SSE versions of idct (idct_mmx.c) in the mpeg2 libs that we
-// should probably upgrade to.  They use their own raw-style intrinsics and not the intel
-// compiler-integrated ones.
+// The row/column passes below are the reference.  Idct_sse4.cpp and Idct_avx2.cpp do the
+// same arithmetic on vectors, mpeg2_idct points to the one picked for the host cpu (see
+// ipuSelectKernels).
 
 #include "PrecompiledHeader.h"
 
@@ -39,16 +39,6 @@
 #define W6 1108 /* 2048*sqrt (2)*cos (6*pi/16) */
 #define W7 565  /* 2048*sqrt (2)*cos (7*pi/16) */
 
-/*
- * In legal streams, the IDCT output should be between -384 and +384.
- * In corrupted streams, it is possible to force the IDCT output to go
- * to +-3826 - this is the worst case for a column IDCT where the
- * column inputs are 16-bit values.
- */
-static __aligned16 u8 clip_lut[1024];
-
-#define CLIP(i) ((clip_lut+384)[(i)])
-
 static __fi void BUTTERFLY(int& t0, int& t1, int w0, int w1, int d0, int d1)
 {
 #if 0
@@ -155,7 +145,7 @@ static __fi void idct_col (s16 * const block)
     block[8*7] = (a0 - b0) >> 17;
 }
 
-__ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
+void mpeg2_idct_c(s16 * block)
 {
     int i;
 
@@ -163,23 +153,31 @@ __ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
 		idct_row (block + 8 * i);
     for (i = 0; i < 8; i++)
 		idct_col (block + i);
+}
 
-	__m128 zero = _mm_setzero_ps();
-    do {
-		dest[0] = CLIP (block[0]);
-		dest[1] = CLIP (block[1]);
-		dest[2] = CLIP (block[2]);
-		dest[3] = CLIP (block[3]);
-		dest[4] = CLIP (block[4]);
-		dest[5] = CLIP (block[5]);
-		dest[6] = CLIP (block[6]);
-		dest[7] = CLIP (block[7]);
+mpeg2_idct_t* mpeg2_idct = mpeg2_idct_c;
 
-		_mm_store_ps((float*)block, zero);
+/*
+ * In legal streams, the IDCT output should be between -384 and +384.
+ * In corrupted streams, it is possible to force the IDCT output to go
+ * to +-3826 - this is the worst case for a column IDCT where the
+ * column inputs are 16-bit values.  packuswb clamps the whole 16-bit
+ * range to 0-255, which is what the old clip table did for its range.
+ */
+__ri void mpeg2_idct_copy(s16 * block, u8 * dest, const int stride)
+{
+	mpeg2_idct(block);
+
+	__m128i zero = _mm_setzero_si128();
+	for (int i = 0; i < 8; i++)
+	{
+		__m128i row = _mm_load_si128((__m128i*)block);
+		_mm_storel_epi64((__m128i*)dest, _mm_packus_epi16(row, row));
+		_mm_store_si128((__m128i*)block, zero);
 
 		dest += stride;
 		block += 8;
-    } while (--i);
+	}
 }
 
 
@@ -190,11 +188,8 @@ __ri void mpeg2_idct_add (const int last, s16 * block, s16 * dest, const int str
 
     if (last != 129 || (block[0] & 7) == 4)
     {
-		int i;
-		for (i = 0; i < 8; i++)
-			idct_row (block + 8 * i);
-		for (i = 0; i < 8; i++)
-			idct_col (block + i);
+		int i = 8;
+		mpeg2_idct(block);
 
 		__m128 zero = _mm_setzero_ps();
 		do {
@@ -237,9 +232,6 @@ mpeg2_scan_pack::mpeg2_scan_pack()
 		53, 61, 22, 30,  7, 15, 23, 31, 38, 46, 54, 62, 39, 47, 55, 63
 	};
 
-	for (int i = -384; i < 640; i++)
-		clip_lut[i+384] = (i < 0) ? 0 : ((i > 255) ? 255 : i);
-
 	for (int i = 0; i < 64; i++) {
 		int j = mpeg2_scan_norm[i];
 		norm[i] = ((j & 0x36) >> 1) | ((j & 0x09) << 2);
@@ -0,0 +1,165 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// SSE4.1 version of the IDCT in Idct.cpp, four rows (or columns) at a time.
+//
+// This file is built with SSE4.1 enabled and is only called when the cpu has it, so it
+// must not include anything that defines inline functions shared with other files (the
+// linker could pick the SSE4.1 copy for everyone).  Hence no PrecompiledHeader.h.
+//
+// The arithmetic is the one of idct_row/idct_col done on 32-bit lanes (pmulld), with the
+// results truncated to 16 bits like the scalar stores, so the output is bit-exact.
+
+#include "Pcsx2Defs.h"
+
+#define W1 2841
+#define W2 2676
+#define W3 2408
+#define W5 1609
+#define W6 1108
+#define W7 565
+
+static __fi __m128i mul(__m128i a, int w)
+{
+	return _mm_mullo_epi32(a, _mm_set1_epi32(w));
+}
+
+// x[k] holds coefficient k of four rows (row pass) or four columns (column pass).
+template< bool col >
+static __fi void idct_pass(__m128i (&x)[8])
+{
+	const __m128i d0 = _mm_add_epi32(_mm_slli_epi32(x[0], 11), _mm_set1_epi32(col ? 65536 : 128));
+	const __m128i d2 = _mm_slli_epi32(x[2], 11);
+
+	__m128i t0 = _mm_add_epi32(d0, d2);
+	__m128i t1 = _mm_sub_epi32(d0, d2);
+
+	__m128i tmp = mul(_mm_add_epi32(x[3], x[1]), W6);
+	__m128i t2 = _mm_add_epi32(tmp, mul(x[1], W2 - W6));
+	__m128i t3 = _mm_sub_epi32(tmp, mul(x[3], W2 + W6));
+
+	const __m128i a0 = _mm_add_epi32(t0, t2);
+	const __m128i a1 = _mm_add_epi32(t1, t3);
+	const __m128i a2 = _mm_sub_epi32(t1, t3);
+	const __m128i a3 = _mm_sub_epi32(t0, t2);
+
+	tmp = mul(_mm_add_epi32(x[7], x[4]), W7);
+	t0 = _mm_add_epi32(tmp, mul(x[4], W1 - W7));
+	t1 = _mm_sub_epi32(tmp, mul(x[7], W1 + W7));
+
+	tmp = mul(_mm_add_epi32(x[5], x[6]), W3);
+	t2 = _mm_add_epi32(tmp, mul(x[6], W5 - W3));
+	t3 = _mm_sub_epi32(tmp, mul(x[5], W5 + W3));
+
+	const __m128i b0 = _mm_add_epi32(t0, t2);
+	const __m128i b3 = _mm_add_epi32(t1, t3);
+	__m128i b1, b2;
+
+	t0 = _mm_sub_epi32(t0, t2);
+	t1 = _mm_sub_epi32(t1, t3);
+
+	if (col)
+	{
+		t0 = _mm_srai_epi32(t0, 8);
+		t1 = _mm_srai_epi32(t1, 8);
+		b1 = mul(_mm_add_epi32(t0, t1), 181);
+		b2 = mul(_mm_sub_epi32(t0, t1), 181);
+	}
+	else
+	{
+		b1 = _mm_srai_epi32(mul(_mm_add_epi32(t0, t1), 181), 8);
+		b2 = _mm_srai_epi32(mul(_mm_sub_epi32(t0, t1), 181), 8);
+	}
+
+	const int shift = col ? 17 : 8;
+
+	x[0] = _mm_srai_epi32(_mm_add_epi32(a0, b0), shift);
+	x[1] = _mm_srai_epi32(_mm_add_epi32(a1, b1), shift);
+	x[2] = _mm_srai_epi32(_mm_add_epi32(a2, b2), shift);
+	x[3] = _mm_srai_epi32(_mm_add_epi32(a3, b3), shift);
+	x[4] = _mm_srai_epi32(_mm_sub_epi32(a3, b3), shift);
+	x[5] = _mm_srai_epi32(_mm_sub_epi32(a2, b2), shift);
+	x[6] = _mm_srai_epi32(_mm_sub_epi32(a1, b1), shift);
+	x[7] = _mm_srai_epi32(_mm_sub_epi32(a0, b0), shift);
+}
+
+static __fi void transpose(__m128i (&r)[8])
+{
+	const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+	const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+	const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+	const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+	const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+	const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+	const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+	const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	r[0] = _mm_unpacklo_epi64(b0, b4);
+	r[1] = _mm_unpackhi_epi64(b0, b4);
+	r[2] = _mm_unpacklo_epi64(b1, b5);
+	r[3] = _mm_unpackhi_epi64(b1, b5);
+	r[4] = _mm_unpacklo_epi64(b2, b6);
+	r[5] = _mm_unpackhi_epi64(b2, b6);
+	r[6] = _mm_unpacklo_epi64(b3, b7);
+	r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+// Runs one pass over the 8 vectors of v (lanes 0-3, then lanes 4-7) and keeps the low
+// 16 bits of each result.
+template< bool col >
+static __fi void idct_8x8(__m128i (&v)[8])
+{
+	const __m128i mask = _mm_set1_epi32(0xffff);
+	__m128i lo[8], hi[8];
+
+	for (int i = 0; i < 8; i++)
+	{
+		lo[i] = _mm_cvtepi16_epi32(v[i]);
+		hi[i] = _mm_cvtepi16_epi32(_mm_srli_si128(v[i], 8));
+	}
+
+	idct_pass<col>(lo);
+	idct_pass<col>(hi);
+
+	for (int i = 0; i < 8; i++)
+		v[i] = _mm_packus_epi32(_mm_and_si128(lo[i], mask), _mm_and_si128(hi[i], mask));
+}
+
+void mpeg2_idct_sse41(s16* block)
+{
+	__m128i v[8];
+
+	for (int i = 0; i < 8; i++)
+		v[i] = _mm_load_si128((__m128i*)block + i);
+
+	// Rows first: with the block transposed each vector holds one coefficient of all the
+	// rows.  Transposing back gives the layout the column pass wants.
+	transpose(v);
+	idct_8x8<false>(v);
+	transpose(v);
+	idct_8x8<true>(v);
+
+	for (int i = 0; i < 8; i++)
+		_mm_store_si128((__m128i*)block + i, v[i]);
+}
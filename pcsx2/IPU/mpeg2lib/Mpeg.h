@@ -195,6 +195,13 @@ extern s32 SBITS(uint bits);
 extern void mpeg2_idct_copy(s16 * block, u8* dest, int stride);
 extern void mpeg2_idct_add(int last, s16 * block, s16* dest, int stride);
 
+// In-place IDCT of an 8x8 coefficient block, all versions give the same output.
+typedef void mpeg2_idct_t(s16* block);
+extern mpeg2_idct_t* mpeg2_idct;
+extern void mpeg2_idct_c(s16* block);
+extern void mpeg2_idct_sse41(s16* block);	// Idct_sse4.cpp
+extern void mpeg2_idct_avx2(s16* block);	// Idct_avx2.cpp
+
 extern bool mpeg2sliceIDEC();
 extern bool mpeg2_slice();
 extern int get_macroblock_address_increment();
@@ -229,4 +236,5 @@ extern const int non_linear_quantizer_scale[];
 
 extern __aligned16 tIPU_BP g_BP;
 extern __aligned16 decoder_t decoder;
+extern int mbaCount;
 
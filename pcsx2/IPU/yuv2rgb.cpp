@@ -62,7 +62,9 @@ void yuv2rgb_reference(void)
 // An AVX2 version is only slightly faster than an SSE2 version (+2-3fps)
 // (or I'm a poor optimiser), though it might be worth attempting again
 // once we've ported to 64 bits (the extra registers should help).
-__ri void yuv2rgb_sse2()
+// yuv2rgb_avx2.cpp has one that does two rows per iteration, use --ipubench
+// to compare them.
+void yuv2rgb_sse2()
 {
 	const __m128i c_bias = _mm_set1_epi8(s8(IPU_C_BIAS));
 	const __m128i y_bias = _mm_set1_epi8(IPU_Y_BIAS);
@@ -149,3 +151,10 @@ __ri void yuv2rgb_sse2()
 		}
 	}
 }
+
+void yuv2rgb_avx2()
+{
+	yuv2rgb_avx2_mb(&decoder.mb8.Y[0][0], (u32*)&decoder.rgb32);
+}
+
+void (*yuv2rgb)() = yuv2rgb_sse2;
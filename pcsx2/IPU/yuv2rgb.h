@@ -15,7 +15,12 @@
 
 #pragma once
 
-extern void yuv2rgb_reference();
+// Converts decoder.mb8 into decoder.rgb32, all versions give the same output.
+extern void (*yuv2rgb)();
 
-#define yuv2rgb yuv2rgb_sse2
+extern void yuv2rgb_reference();
 extern void yuv2rgb_sse2();
+extern void yuv2rgb_avx2();
+
+// yuv2rgb_avx2.cpp, takes a macroblock_8 and writes a macroblock_rgb32.
+extern void yuv2rgb_avx2_mb(const u8* mb8, u32* rgb32);
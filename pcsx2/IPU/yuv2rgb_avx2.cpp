@@ -0,0 +1,106 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2016  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// AVX2 version of yuv2rgb_sse2.  The two luma rows sharing a chroma row are converted
+// together, one per 128-bit lane, so every instruction does what the SSE2 version does
+// for a single row and the output is identical.
+//
+// Built with AVX2 enabled, so like the AVX2 IDCT it only includes the basic definitions
+// and gets the macroblocks as plain pointers (macroblock_8 in, macroblock_rgb32 out).
+
+#include "Pcsx2Defs.h"
+
+#define IPU_Y_BIAS    16
+#define IPU_C_BIAS    128
+#define IPU_Y_COEFF   0x95	//  1.1640625
+#define IPU_GCR_COEFF (-0x68)	// -0.8125
+#define IPU_GCB_COEFF (-0x32)	// -0.390625
+#define IPU_RCR_COEFF 0xcc	//  1.59375
+#define IPU_BCB_COEFF 0x102	//  2.015625
+
+void yuv2rgb_avx2_mb(const u8* mb8, u32* rgb32)
+{
+	const u8* Y = mb8;				// [16][16]
+	const u8* Cb = mb8 + 16 * 16;	// [8][8]
+	const u8* Cr = Cb + 8 * 8;		// [8][8]
+
+	const __m128i c_bias = _mm_set1_epi8(s8(IPU_C_BIAS));
+	const __m256i y_bias = _mm256_set1_epi8(IPU_Y_BIAS);
+	const __m256i y_mask = _mm256_set1_epi16(s16(0xFF00));
+	const __m256i round_1bit = _mm256_set1_epi16(0x0001);
+
+	const __m256i y_coefficient = _mm256_set1_epi16(s16(IPU_Y_COEFF << 2));
+	const __m128i gcr_coefficient = _mm_set1_epi16(s16(u16(IPU_GCR_COEFF) << 2));
+	const __m128i gcb_coefficient = _mm_set1_epi16(s16(u16(IPU_GCB_COEFF) << 2));
+	const __m128i rcr_coefficient = _mm_set1_epi16(s16(IPU_RCR_COEFF << 2));
+	const __m128i bcb_coefficient = _mm_set1_epi16(s16(IPU_BCB_COEFF << 2));
+
+	const __m256i alpha = _mm256_set1_epi8(s8(IPU_C_BIAS));
+
+	for (int n = 0; n < 8; ++n)
+	{
+		__m128i cb = _mm_loadl_epi64((const __m128i*)(Cb + n * 8));
+		__m128i cr = _mm_loadl_epi64((const __m128i*)(Cr + n * 8));
+
+		// (Cb - 128) << 8, (Cr - 128) << 8
+		cb = _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_xor_si128(cb, c_bias));
+		cr = _mm_unpacklo_epi8(_mm_setzero_si128(), _mm_xor_si128(cr, c_bias));
+
+		const __m256i rc = _mm256_broadcastsi128_si256(_mm_mulhi_epi16(cr, rcr_coefficient));
+		const __m256i gc = _mm256_broadcastsi128_si256(_mm_adds_epi16(_mm_mulhi_epi16(cr, gcr_coefficient), _mm_mulhi_epi16(cb, gcb_coefficient)));
+		const __m256i bc = _mm256_broadcastsi128_si256(_mm_mulhi_epi16(cb, bcb_coefficient));
+
+		// Rows 2n and 2n+1
+		__m256i y = _mm256_loadu_si256((const __m256i*)(Y + n * 32));
+		y = _mm256_subs_epu8(y, y_bias);
+
+		__m256i y_even = _mm256_mulhi_epu16(_mm256_slli_epi16(y, 8), y_coefficient);
+		__m256i y_odd  = _mm256_mulhi_epu16(_mm256_and_si256(y, y_mask), y_coefficient);
+
+		__m256i r_even = _mm256_srai_epi16(_mm256_add_epi16(_mm256_adds_epi16(rc, y_even), round_1bit), 1);
+		__m256i r_odd  = _mm256_srai_epi16(_mm256_add_epi16(_mm256_adds_epi16(rc, y_odd),  round_1bit), 1);
+		__m256i g_even = _mm256_srai_epi16(_mm256_add_epi16(_mm256_adds_epi16(gc, y_even), round_1bit), 1);
+		__m256i g_odd  = _mm256_srai_epi16(_mm256_add_epi16(_mm256_adds_epi16(gc, y_odd),  round_1bit), 1);
+		__m256i b_even = _mm256_srai_epi16(_mm256_add_epi16(_mm256_adds_epi16(bc, y_even), round_1bit), 1);
+		__m256i b_odd  = _mm256_srai_epi16(_mm256_add_epi16(_mm256_adds_epi16(bc, y_odd),  round_1bit), 1);
+
+		// combine even and odd bytes in original order (within each lane)
+		__m256i r = _mm256_packus_epi16(r_even, r_odd);
+		__m256i g = _mm256_packus_epi16(g_even, g_odd);
+		__m256i b = _mm256_packus_epi16(b_even, b_odd);
+
+		r = _mm256_unpacklo_epi8(r, _mm256_shuffle_epi32(r, _MM_SHUFFLE(3, 2, 3, 2)));
+		g = _mm256_unpacklo_epi8(g, _mm256_shuffle_epi32(g, _MM_SHUFFLE(3, 2, 3, 2)));
+		b = _mm256_unpacklo_epi8(b, _mm256_shuffle_epi32(b, _MM_SHUFFLE(3, 2, 3, 2)));
+
+		const __m256i rg_l = _mm256_unpacklo_epi8(r, g);
+		const __m256i ba_l = _mm256_unpacklo_epi8(b, alpha);
+		const __m256i rgba_ll = _mm256_unpacklo_epi16(rg_l, ba_l);	// pixels 0-3
+		const __m256i rgba_lh = _mm256_unpackhi_epi16(rg_l, ba_l);	// pixels 4-7
+
+		const __m256i rg_h = _mm256_unpackhi_epi8(r, g);
+		const __m256i ba_h = _mm256_unpackhi_epi8(b, alpha);
+		const __m256i rgba_hl = _mm256_unpacklo_epi16(rg_h, ba_h);	// pixels 8-11
+		const __m256i rgba_hh = _mm256_unpackhi_epi16(rg_h, ba_h);	// pixels 12-15
+
+		// Low lanes go to row 2n, high lanes to row 2n+1
+		u32* row = rgb32 + n * 32;
+
+		_mm256_storeu_si256((__m256i*)(row +  0), _mm256_permute2x128_si256(rgba_ll, rgba_lh, 0x20));
+		_mm256_storeu_si256((__m256i*)(row +  8), _mm256_permute2x128_si256(rgba_hl, rgba_hh, 0x20));
+		_mm256_storeu_si256((__m256i*)(row + 16), _mm256_permute2x128_si256(rgba_ll, rgba_lh, 0x31));
+		_mm256_storeu_si256((__m256i*)(row + 24), _mm256_permute2x128_si256(rgba_hl, rgba_hh, 0x31));
+	}
+}
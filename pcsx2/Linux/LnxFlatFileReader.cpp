@@ -16,11 +16,361 @@
 #include "PrecompiledHeader.h"
 #include "AsyncFileReader.h"
 
-FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite)
+#if defined(__has_include)
+#	if __has_include(<linux/io_uring.h>)
+#		include <linux/io_uring.h>
+#		include <sys/mman.h>
+#		include <sys/syscall.h>
+#		include <sys/uio.h>
+#		if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#			define HAVE_IO_URING 1
+#		endif
+#	endif
+#endif
+
+#ifdef HAVE_IO_URING
+
+// --------------------------------------------------------------------------------------
+//  IoUringQueue
+// --------------------------------------------------------------------------------------
+// libaio only does real asynchronous reads on O_DIRECT files, for the regular (page cached)
+// ISO file io_submit() blocks until the data is there.  io_uring doesn't have that problem,
+// and lets us keep a few reads of the upcoming sectors in flight while the disc is being
+// streamed, so that they are usually already in memory when the CDVD asks for them.
+//
+// The ring is driven with the raw syscalls to avoid depending on liburing.
+//
+class IoUringQueue
+{
+public:
+	IoUringQueue();
+	~IoUringQueue();
+
+	bool Open(int fd);
+
+	void BeginRead(void* pBuffer, u64 offset, u32 bytes);
+	int FinishRead();
+	void CancelRead();
+
+private:
+	enum
+	{
+		DirectSlot = 0,		// read straight into the caller's buffer
+		PrefetchDepth = 4,	// reads of the next sectors, into our own buffers
+		SlotCount = PrefetchDepth + 1,
+		RingEntries = 8,
+	};
+
+	// Big enough for InputIsoFile::MaxReadUnit raw sectors.
+	static const u32 PrefetchBufferSize = 128 * 2352;
+
+	struct Request
+	{
+		struct iovec iov;
+		u64 offset;
+		int result;
+		bool inflight;
+		bool valid;			// prefetch slot holds (or will hold) the data at offset
+	};
+
+	bool Submit(int slot, void* buffer, u64 offset, u32 bytes);
+	void Reap(bool wait);
+	void Wait(int slot);
+	int FindPrefetch(u64 offset, u32 bytes) const;
+	void Prefetch(u64 offset, u32 bytes);
+
+	int m_ring_fd;
+	int m_fd;
+
+	void* m_sq_ptr;
+	size_t m_sq_size;
+	void* m_cq_ptr;
+	size_t m_cq_size;
+	io_uring_sqe* m_sqes;
+	size_t m_sqes_size;
+
+	u32* m_sq_tail;
+	u32* m_sq_mask;
+	u32* m_sq_array;
+	u32* m_cq_head;
+	u32* m_cq_tail;
+	u32* m_cq_mask;
+	io_uring_cqe* m_cqes;
+
+	Request m_req[SlotCount];
+	u8* m_prefetch_buffers;
+
+	// Current BeginRead/FinishRead pair
+	void* m_dest;
+	u32 m_bytes;
+	u64 m_offset;
+	int m_slot;
+
+	u64 m_next_offset;		// end of the previous read, for stream detection
+};
+
+IoUringQueue::IoUringQueue()
+	: m_ring_fd(-1)
+	, m_fd(-1)
+	, m_sq_ptr(MAP_FAILED)
+	, m_sq_size(0)
+	, m_cq_ptr(MAP_FAILED)
+	, m_cq_size(0)
+	, m_sqes((io_uring_sqe*)MAP_FAILED)
+	, m_sqes_size(0)
+	, m_prefetch_buffers(NULL)
+	, m_dest(NULL)
+	, m_bytes(0)
+	, m_offset(0)
+	, m_slot(-1)
+	, m_next_offset(~0ULL)
+{
+	memzero(m_req);
+}
+
+IoUringQueue::~IoUringQueue()
+{
+	// The kernel may still be writing into our buffers.
+	if (m_ring_fd != -1)
+	{
+		for (int i = 0; i < SlotCount; i++)
+			Wait(i);
+	}
+
+	if (m_sqes != MAP_FAILED) munmap(m_sqes, m_sqes_size);
+	if (m_cq_ptr != MAP_FAILED && m_cq_ptr != m_sq_ptr) munmap(m_cq_ptr, m_cq_size);
+	if (m_sq_ptr != MAP_FAILED) munmap(m_sq_ptr, m_sq_size);
+	if (m_ring_fd != -1) close(m_ring_fd);
+
+	free(m_prefetch_buffers);
+}
+
+bool IoUringQueue::Open(int fd)
+{
+	m_fd = fd;
+
+	io_uring_params params;
+	memzero(params);
+
+	// Fails with ENOSYS on old kernels, and EPERM where io_uring is disabled (containers)
+	m_ring_fd = syscall(__NR_io_uring_setup, RingEntries, &params);
+	if (m_ring_fd < 0)
+		return false;
+
+	m_sq_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+	m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+
+	m_sq_ptr = mmap(NULL, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+	if (m_sq_ptr == MAP_FAILED)
+		return false;
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		m_cq_ptr = m_sq_ptr;
+	else
+		m_cq_ptr = mmap(NULL, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_CQ_RING);
+	if (m_cq_ptr == MAP_FAILED)
+		return false;
+
+	m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+	m_sqes = (io_uring_sqe*)mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES);
+	if (m_sqes == MAP_FAILED)
+		return false;
+
+	u8* sq = (u8*)m_sq_ptr;
+	m_sq_tail = (u32*)(sq + params.sq_off.tail);
+	m_sq_mask = (u32*)(sq + params.sq_off.ring_mask);
+	m_sq_array = (u32*)(sq + params.sq_off.array);
+
+	u8* cq = (u8*)m_cq_ptr;
+	m_cq_head = (u32*)(cq + params.cq_off.head);
+	m_cq_tail = (u32*)(cq + params.cq_off.tail);
+	m_cq_mask = (u32*)(cq + params.cq_off.ring_mask);
+	m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	m_prefetch_buffers = (u8*)malloc(PrefetchDepth * PrefetchBufferSize);
+	return m_prefetch_buffers != NULL;
+}
+
+bool IoUringQueue::Submit(int slot, void* buffer, u64 offset, u32 bytes)
+{
+	Request& req = m_req[slot];
+	req.iov.iov_base = buffer;
+	req.iov.iov_len = bytes;
+	req.offset = offset;
+	req.result = 0;
+
+	// We are the only producer, the kernel only moves the head.
+	const u32 tail = *m_sq_tail;
+	const u32 index = tail & *m_sq_mask;
+
+	io_uring_sqe& sqe = m_sqes[index];
+	memzero(sqe);
+	sqe.opcode = IORING_OP_READV;
+	sqe.fd = m_fd;
+	sqe.addr = (u64)(uptr)&req.iov;
+	sqe.len = 1;
+	sqe.off = offset;
+	sqe.user_data = slot;
+
+	m_sq_array[index] = index;
+	__atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	if (syscall(__NR_io_uring_enter, m_ring_fd, 1, 0, 0, NULL, 0) != 1)
+	{
+		// Not consumed, take it back.
+		__atomic_store_n(m_sq_tail, tail, __ATOMIC_RELEASE);
+		return false;
+	}
+
+	req.inflight = true;
+	return true;
+}
+
+void IoUringQueue::Reap(bool wait)
+{
+	u32 head = *m_cq_head;
+
+	if (wait && head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+	{
+		if (syscall(__NR_io_uring_enter, m_ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+		{
+			// The ring is broken, there is nothing else to wait for.
+			for (Request& req : m_req)
+			{
+				if (req.inflight)
+				{
+					req.inflight = false;
+					req.result = -errno;
+				}
+			}
+			return;
+		}
+	}
+
+	const u32 tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+	for (; head != tail; head++)
+	{
+		const io_uring_cqe& cqe = m_cqes[head & *m_cq_mask];
+		Request& req = m_req[cqe.user_data];
+		req.result = cqe.res;
+		req.inflight = false;
+	}
+	__atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+}
+
+void IoUringQueue::Wait(int slot)
+{
+	while (m_req[slot].inflight)
+		Reap(true);
+}
+
+int IoUringQueue::FindPrefetch(u64 offset, u32 bytes) const
+{
+	for (int i = DirectSlot + 1; i < SlotCount; i++)
+	{
+		const Request& req = m_req[i];
+		if (req.valid && req.offset == offset && req.iov.iov_len == bytes)
+			return i;
+	}
+	return -1;
+}
+
+// Queues reads of the blocks following [offset, offset + bytes) into the free prefetch slots.
+void IoUringQueue::Prefetch(u64 offset, u32 bytes)
+{
+	Reap(false);
+
+	const u64 window_end = offset + (u64)bytes * PrefetchDepth;
+
+	for (int ahead = 1; ahead <= PrefetchDepth; ahead++)
+	{
+		const u64 next = offset + (u64)bytes * ahead;
+		if (FindPrefetch(next, bytes) >= 0)
+			continue;
+
+		// Anything outside of the window is stale: behind the current read, or ahead of
+		// it after a backward seek.  The slot serving the current read (m_slot) isn't
+		// free until FinishRead has copied it out.
+		int slot = -1;
+		for (int i = DirectSlot + 1; i < SlotCount; i++)
+		{
+			const Request& req = m_req[i];
+			if (i != m_slot && !req.inflight && (!req.valid || req.offset < offset || req.offset > window_end))
+			{
+				slot = i;
+				break;
+			}
+		}
+		if (slot < 0)
+			return;
+
+		m_req[slot].valid = Submit(slot, m_prefetch_buffers + (slot - 1) * PrefetchBufferSize, next, bytes);
+		if (!m_req[slot].valid)
+			return;
+	}
+}
+
+void IoUringQueue::BeginRead(void* pBuffer, u64 offset, u32 bytes)
+{
+	const bool streaming = (offset == m_next_offset);
+	m_next_offset = offset + bytes;
+
+	m_dest = pBuffer;
+	m_bytes = bytes;
+	m_offset = offset;
+
+	m_slot = FindPrefetch(offset, bytes);
+	if (m_slot < 0)
+		m_slot = Submit(DirectSlot, pBuffer, offset, bytes) ? DirectSlot : -1;
+
+	if (streaming && bytes <= PrefetchBufferSize)
+		Prefetch(offset, bytes);
+}
+
+int IoUringQueue::FinishRead()
+{
+	int result = -1;
+
+	if (m_slot >= 0)
+	{
+		Wait(m_slot);
+
+		Request& req = m_req[m_slot];
+		result = req.result;
+		if (m_slot != DirectSlot)
+		{
+			req.valid = false;
+			if (result > 0)
+				memcpy(m_dest, req.iov.iov_base, result);
+		}
+	}
+
+	// Submission or prefetch failure, don't leave the CDVD without its data.
+	if (result < 0)
+		result = pread(m_fd, m_dest, m_bytes, m_offset);
+
+	m_slot = -1;
+	return result;
+}
+
+void IoUringQueue::CancelRead()
+{
+	// The caller's buffer is about to go away, the direct read must be done with it.
+	// Prefetches use our own buffers and can keep going.
+	Wait(DirectSlot);
+	m_slot = -1;
+}
+
+#endif
+
+FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite), m_backend(Backend_Default)
 {
 	m_blocksize = 2048;
 	m_fd = -1;
 	m_aio_context = 0;
+	m_uring = NULL;
 }
 
 FlatFileReader::~FlatFileReader(void)
@@ -28,16 +378,37 @@ FlatFileReader::~FlatFileReader(void)
 	Close();
 }
 
+const char* FlatFileReader::GetBackendName() const
+{
+	return m_uring ? "io_uring" : "libaio";
+}
+
 bool FlatFileReader::Open(const wxString& fileName)
 {
 	m_filename = fileName;
 
-	int err = io_setup(64, &m_aio_context);
-	if (err) return false;
-
     m_fd = wxOpen(fileName, O_RDONLY, 0);
+	if (m_fd == -1) return false;
+
+	if (m_backend != Backend_Platform)
+	{
+#ifdef HAVE_IO_URING
+		m_uring = new IoUringQueue;
+		if (m_uring->Open(m_fd))
+			return true;
+
+		delete m_uring;
+		m_uring = NULL;
+#endif
+		if (m_backend == Backend_IoUring)
+		{
+			Console.Warning("FlatFileReader: io_uring is not available.");
+			return false;
+		}
+	}
 
-	return (m_fd != -1);
+	int err = io_setup(64, &m_aio_context);
+	return (err == 0);
 }
 
 int FlatFileReader::ReadSync(void* pBuffer, uint sector, uint count)
@@ -53,6 +424,14 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 	u32 bytesToRead = count * m_blocksize;
 
+#ifdef HAVE_IO_URING
+	if (m_uring)
+	{
+		m_uring->BeginRead(pBuffer, offset, bytesToRead);
+		return;
+	}
+#endif
+
 	struct iocb iocb;
 	struct iocb* iocbs = &iocb;
 
@@ -62,6 +441,11 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 int FlatFileReader::FinishRead(void)
 {
+#ifdef HAVE_IO_URING
+	if (m_uring)
+		return m_uring->FinishRead();
+#endif
+
 	int min_nr = 1;
 	int max_nr = 1;
 	struct io_event events[max_nr];
@@ -76,6 +460,14 @@ int FlatFileReader::FinishRead(void)
 
 void FlatFileReader::CancelRead(void)
 {
+#ifdef HAVE_IO_URING
+	if (m_uring)
+	{
+		m_uring->CancelRead();
+		return;
+	}
+#endif
+
 	// Will be done when m_aio_context context is destroyed
 	// Note: io_cancel exists but need the iocb structure as parameter
 	// int io_cancel(aio_context_t ctx_id, struct iocb *iocb,
@@ -84,10 +476,15 @@ void FlatFileReader::CancelRead(void)
 
 void FlatFileReader::Close(void)
 {
+#ifdef HAVE_IO_URING
+	// Waits for the reads still in flight, must go before the file is closed.
+	delete m_uring;
+#endif
+	m_uring = NULL;
 
 	if (m_fd != -1) close(m_fd);
 
-	io_destroy(m_aio_context);
+	if (m_aio_context) io_destroy(m_aio_context);
 
 	m_fd = -1;
 	m_aio_context = 0;
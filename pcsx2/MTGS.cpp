@@ -44,6 +44,10 @@ __aligned(32) MTGS_BufferedData RingBuffer;
 extern bool renderswitch;
 
 
+// SpinWaitMTGS bounds for the number of SpinWait iterations before the MTGS parks.
+static const int MTGS_SpinBudgetMin = 64;
+static const int MTGS_SpinBudgetMax = 8192;
+
 #ifdef RINGBUF_DEBUG_STACK
 #include <list>
 std::list<uint> ringposStack;
@@ -67,6 +71,7 @@ void SysMtgsThread::OnStart()
 	m_ReadPos			= 0;
 	m_WritePos			= 0;
 	m_RingBufferIsBusy  = false;
+	m_RingBufferIsParked = false;
 	m_packet_size		= 0;
 	m_packet_writepos	= 0;
 
@@ -76,6 +81,13 @@ void SysMtgsThread::OnStart()
 	m_SignalRingPosition  = 0;
 
 	m_CopyDataTally		= 0;
+	m_SpinBudget		= MTGS_SpinBudgetMin;
+
+	m_stat_ProducerStalls	= 0;
+	m_stat_ConsumerIdles	= 0;
+	m_stat_ConsumerSpins	= 0;
+	m_stat_WakeSyscalls		= 0;
+	memzero(m_FrameStats);
 
 	_parent::OnStart();
 }
@@ -122,6 +134,13 @@ struct RingCmdPacket_Vsync
 
 void SysMtgsThread::PostVsyncStart()
 {
+	// Close the handoff counters for the frame that just ended.  The counters are bumped
+	// from both sides of the ring, so they are swapped out rather than cleared.
+	m_FrameStats.ProducerStalls	= m_stat_ProducerStalls.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.ConsumerIdles	= m_stat_ConsumerIdles.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.ConsumerSpins	= m_stat_ConsumerSpins.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.WakeSyscalls	= m_stat_WakeSyscalls.exchange(0, std::memory_order_relaxed);
+
 	// Optimization note: Typically regset1 isn't needed.  The regs in that area are typically
 	// changed infrequently, usually during video mode changes.  However, on modern systems the
 	// 256-byte copy is only a few dozen cycles -- executed 60 times a second -- so probably
@@ -162,7 +181,7 @@ void SysMtgsThread::PostVsyncStart()
 	// To avoid this potential deadlock, ring must be wake up after m_VsyncSignalListener
 	// Note: potentially we can also miss the previous wake up if we optimize away the post just before the release of busy signal of the ring
 	// So let's ensure the ring doesn't sleep
-	m_sem_event.Post();
+	PostRingEvent();
 
 	m_sem_Vsync.WaitNoCancel();
 }
@@ -289,7 +308,10 @@ void SysMtgsThread::ExecuteTaskInThread()
 		// is very optimized (only 1 instruction test in most cases), so no point in trying
 		// to avoid it.
 
-		m_sem_event.WaitWithoutYield();
+		if (EmuConfig.GS.SpinWaitMTGS)
+			WaitForRingWork();
+		else
+			m_sem_event.WaitWithoutYield();
 		StateCheckInThread();
 		busy.Acquire();
 
@@ -639,12 +661,61 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 // For use in loops that wait on the GS thread to do certain things.
 void SysMtgsThread::SetEvent()
 {
-	if(!m_RingBufferIsBusy.load(std::memory_order_relaxed))
-		m_sem_event.Post();
+	if (EmuConfig.GS.SpinWaitMTGS)
+	{
+		// Only the EE/MTVU side that flips the parked flag back posts the semaphore, so the
+		// MTGS thread costs us a syscall only when it has actually gone to sleep.  The fence
+		// pairs with the one in WaitForRingWork(): either we see the flag or it sees m_WritePos.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_RingBufferIsParked.load(std::memory_order_relaxed) && m_RingBufferIsParked.exchange(false))
+			PostRingEvent();
+	}
+	else if(!m_RingBufferIsBusy.load(std::memory_order_relaxed))
+		PostRingEvent();
 
 	m_CopyDataTally = 0;
 }
 
+void SysMtgsThread::PostRingEvent()
+{
+	m_stat_WakeSyscalls.fetch_add(1, std::memory_order_relaxed);
+	m_sem_event.Post();
+}
+
+// SpinWaitMTGS mode: waits for the EE to queue more work.  The MTGS thread spins on
+// m_WritePos for a while before parking on m_sem_event, and the spin length follows how
+// often spinning paid off lately.  Runs with the RingBufferLock released.
+void SysMtgsThread::WaitForRingWork()
+{
+	for (int i = 0; i < m_SpinBudget; ++i)
+	{
+		if (m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_acquire))
+		{
+			m_SpinBudget = std::min(m_SpinBudget * 2, MTGS_SpinBudgetMax);
+			m_stat_ConsumerSpins.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		SpinWait();
+	}
+
+	m_SpinBudget = std::max(m_SpinBudget / 2, MTGS_SpinBudgetMin);
+	m_stat_ConsumerIdles.fetch_add(1, std::memory_order_relaxed);
+
+	m_RingBufferIsParked.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// Re-check after publishing the flag: a packet may have landed while we were spinning.
+	// If the EE already claimed the flag it has posted (or is about to post) the semaphore,
+	// so the token must be consumed here to keep posts and waits balanced.
+	if (m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_acquire)
+		&& m_RingBufferIsParked.exchange(false))
+		return;
+
+	// Also woken by the SysThreadBase suspend/resume/cancel posts.
+	m_sem_event.WaitWithoutYield();
+	m_RingBufferIsParked.store(false, std::memory_order_relaxed);
+}
+
 u8* SysMtgsThread::GetDataPacketPtr() const
 {
 	return (u8*)&RingBuffer[m_packet_writepos & RingBufferMask];
@@ -706,6 +777,8 @@ void SysMtgsThread::GenericStall( uint size )
 
 	if (freeroom <= size)
 	{
+		m_stat_ProducerStalls.fetch_add(1, std::memory_order_relaxed);
+
 		// writepos will overlap readpos if we commit the data, so we need to wait until
 		// readpos is out past the end of the future write pos, or until it wraps around
 		// (in which case writepos will be >= readpos).
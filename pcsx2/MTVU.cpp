@@ -24,6 +24,10 @@ __aligned16 VU_Thread vu1Thread(CpuVU1, VU1);
 #define MTVU_ALWAYS_KICK 0
 #define MTVU_SYNC_MODE   0
 
+// Lower bound of the adaptive MTVU spin budget (see WaitForRingWork), the upper bound
+// is the vuThreadSpin setting.
+static const int MTVU_SpinBudgetMin = 64;
+
 // Rounds up a size in bytes for size in u32's
 static __fi u32 size_u32(u32 x) { return (x + 3) >> 2; }
 
@@ -64,6 +68,10 @@ VU_Thread::VU_Thread(BaseVUmicroCPU*& _vuCPU, VURegs& _vuRegs) :
 		vuCPU(_vuCPU), vuRegs(_vuRegs)
 {
 	m_name = L"MTVU";
+	// Owned by the thread itself, left alone by Reset() (MTVU may be asleep on semaEvent)
+	m_parked     = false;
+	m_SpinBudget = MTVU_SpinBudgetMin;
+	m_cpu        = -1;
 	Reset();
 }
 
@@ -80,11 +88,19 @@ void VU_Thread::Reset()
 	ScopedLock lock(mtxBusy);
 
 	vuCycleIdx   = 0;
-	isBusy       = false;
 	m_ato_write_pos = 0;
 	m_write_pos     = 0;
 	m_ato_read_pos  = 0;
 	m_read_pos      = 0;
+	m_batch_cmds    = 0;
+	m_stat_Packets   = 0;
+	m_stat_Commands  = 0;
+	m_stat_WakePosts = 0;
+	m_stat_Spins     = 0;
+	m_stat_Idles     = 0;
+	m_stat_EEStalls     = 0;
+	m_stat_EEStallTicks = 0;
+	memzero(m_FrameStats);
 	memzero(vif);
 	memzero(vifRegs);
 	for (size_t i = 0; i < 4; ++i)
@@ -101,8 +117,8 @@ void VU_Thread::ExecuteTaskInThread()
 void VU_Thread::ExecuteRingBuffer()
 {
 	for(;;) {
-		semaEvent.WaitWithoutYield();
-		ScopedLockBool lock(mtxBusy, isBusy);
+		WaitForRingWork();
+		ScopedLock lock(mtxBusy);
 		while (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos()) {
 			u32 tag = Read();
 			switch (tag) {
@@ -159,11 +175,61 @@ void VU_Thread::ExecuteRingBuffer()
 	}
 }
 
+// Waits for the EE to commit more work.  MTVU spins on the write position for a while
+// before going to sleep on semaEvent, and the spin length follows how often spinning
+// paid off lately.  The sleep itself is a plain semaphore wait, which is a futex wait
+// on Linux when nobody is contending for it.
+void VU_Thread::WaitForRingWork()
+{
+	UpdateAffinity();
+
+	const int spinMax = std::max(EmuConfig.Speedhacks.vuThreadSpin, 0);
+	m_SpinBudget = std::max(std::min(m_SpinBudget, spinMax), std::min(MTVU_SpinBudgetMin, spinMax));
+
+	for (int i = 0; i < m_SpinBudget; ++i) {
+		if (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos()) {
+			m_SpinBudget = std::min(m_SpinBudget * 2, spinMax);
+			m_stat_Spins.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		SpinWait();
+	}
+
+	m_SpinBudget = std::max(m_SpinBudget / 2, std::min(MTVU_SpinBudgetMin, spinMax));
+	m_stat_Idles.fetch_add(1, std::memory_order_relaxed);
+
+	m_parked.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// Re-check after publishing the flag: a batch may have landed while we were spinning.
+	// If the EE already claimed the flag it has posted (or is about to post) the semaphore,
+	// so the token must be consumed here to keep posts and waits balanced.
+	if (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos() && m_parked.exchange(false))
+		return;
+
+	semaEvent.WaitWithoutYield();
+	m_parked.store(false, std::memory_order_relaxed);
+}
+
+// Applies the vuThreadCpu setting (checked each time MTVU runs out of work)
+void VU_Thread::UpdateAffinity()
+{
+	const int cpu = EmuConfig.Speedhacks.vuThreadCpu;
+	if (cpu == m_cpu) return;
+
+	if (!Threading::SetCurrentThreadAffinity(cpu))
+		Console.Warning("MTVU: could not pin the thread to cpu %d", cpu);
+	else if (cpu >= 0)
+		DevCon.WriteLn("MTVU: pinned to cpu %d", cpu);
+
+	m_cpu = cpu;
+}
 
 // Should only be called by ReserveSpace()
 __ri void VU_Thread::WaitOnSize(s32 size)
 {
-	for(;;) {
+	u64 stallStart = 0;
+	for(int spins = 0;; spins++) {
 		s32 readPos  = GetReadPos();
 		if (readPos <= m_write_pos) break; // MTVU is reading in back of write_pos
 		// FIXME greg: there is a bug somewhere in the queue pointer
@@ -173,14 +239,20 @@ __ri void VU_Thread::WaitOnSize(s32 size)
 		// Note: a wait lock instead of a yield also helps to avoid the bug.
 		if (readPos >  m_write_pos + size + _4kb) break; // Enough free front space
 		{ // Let MTVU run to free up buffer space
-			KickStart();
+			if (!spins) {
+				stallStart = GetCPUTicks();
+				m_stat_EEStalls++;
+			}
+			FlushBatch();
 			// Locking might trigger a full flush of the ring buffer. Yield
 			// will be more aggressive, and only flush the minimal size.
 			// Performance will be smoother but it will consume extra CPU cycle
 			// on the EE thread (not an issue on 4 cores).
-			std::this_thread::yield();
+			if (spins < EmuConfig.Speedhacks.vuThreadSpin) SpinWait();
+			else std::this_thread::yield();
 		}
 	}
+	if (stallStart) m_stat_EEStallTicks += GetCPUTicks() - stallStart;
 }
 
 // Makes sure theres enough room in the ring buffer
@@ -224,6 +296,9 @@ __fi u32* VU_Thread::GetWritePtr()
 __fi void VU_Thread::CommitWritePos()
 {
 	m_ato_write_pos.store(m_write_pos, std::memory_order_release);
+	m_stat_Packets.fetch_add(1, std::memory_order_relaxed);
+	m_stat_Commands.fetch_add(m_batch_cmds, std::memory_order_relaxed);
+	m_batch_cmds = 0;
 
 	if (MTVU_ALWAYS_KICK) KickStart();
 	if (MTVU_SYNC_MODE)   WaitVU();
@@ -234,6 +309,18 @@ __fi void VU_Thread::CommitReadPos()
 	m_ato_read_pos.store(m_read_pos, std::memory_order_release);
 }
 
+// Unpacks and VU memory writes are only needed once the next microprogram runs, so they
+// are kept private to the EE thread and published together with the ExecuteVU command
+// (or on WaitVU).  That saves a release store and a possible semaphore post per command,
+// which adds up quickly with games that send many small unpacks.  A large batch is still
+// handed over early so that MTVU can start unpacking while the EE fills the rest.
+__fi void VU_Thread::EndCommand()
+{
+	m_batch_cmds++;
+	if (MTVU_ALWAYS_KICK || MTVU_SYNC_MODE
+	|| m_write_pos - m_ato_write_pos.load(std::memory_order_relaxed) >= batch_size) FlushBatch();
+}
+
 __fi u32 VU_Thread::Read()
 {
 	u32 ret = buffer[m_read_pos];
@@ -293,28 +380,66 @@ u32 VU_Thread::Get_vuCycles()
 			vuCycles[3].load(std::memory_order_acquire)) >> 2;
 }
 
+// Only the side that flips the parked flag back posts the semaphore, so waking MTVU costs
+// a syscall only when it has actually gone to sleep.  The fence pairs with the one in
+// WaitForRingWork(): either we see the flag or MTVU sees the new write position.
 void VU_Thread::KickStart(bool forceKick)
 {
-	if ((forceKick && !semaEvent.Count())
-	|| (!isBusy.load(std::memory_order_acquire) && GetReadPos() != m_ato_write_pos.load(std::memory_order_relaxed))) semaEvent.Post();
+	if (!forceKick && GetReadPos() == m_ato_write_pos.load(std::memory_order_relaxed)) return;
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_parked.load(std::memory_order_relaxed) && m_parked.exchange(false)) {
+		semaEvent.Post();
+		m_stat_WakePosts.fetch_add(1, std::memory_order_relaxed);
+	}
 }
 
+void VU_Thread::FlushBatch()
+{
+	if (m_write_pos != m_ato_write_pos.load(std::memory_order_relaxed)) CommitWritePos();
+	KickStart();
+}
+
+void VU_Thread::PostVsync()
+{
+	m_FrameStats.Packets   = m_stat_Packets.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.Commands  = m_stat_Commands.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.WakePosts = m_stat_WakePosts.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.Spins     = m_stat_Spins.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.Idles     = m_stat_Idles.exchange(0, std::memory_order_relaxed);
+	m_FrameStats.EEStalls  = m_stat_EEStalls;
+	m_FrameStats.EEStallUs = (u32)(m_stat_EEStallTicks * 1000000 / GetTickFrequency());
+	m_stat_EEStalls     = 0;
+	m_stat_EEStallTicks = 0;
+}
+
+// Also accounts for the writes of the pending batch
 bool VU_Thread::IsDone()
 {
-	return GetReadPos() == GetWritePos();
+	return GetReadPos() == m_write_pos;
 }
 
 void VU_Thread::WaitVU()
 {
 	MTVU_LOG("MTVU - WaitVU!");
-	for(;;) {
+	FlushBatch();
+	if (IsDone()) return;
+
+	const u64 stallStart = GetCPUTicks();
+	m_stat_EEStalls++;
+	for(int spins = 0;; spins++) {
 		if (IsDone()) break;
 		//DevCon.WriteLn("WaitVU()");
 		pxAssert(THREAD_VU1);
+		if (spins < EmuConfig.Speedhacks.vuThreadSpin) {
+			SpinWait(); // MTVU is likely about to finish, don't give up the timeslice yet
+			continue;
+		}
 		KickStart();
 		std::this_thread::yield(); // Give a chance to the MTVU thread to actually start
 		ScopedLock lock(mtxBusy);
 	}
+	m_stat_EEStallTicks += GetCPUTicks() - stallStart;
 }
 
 void VU_Thread::ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop)
@@ -325,7 +450,8 @@ void VU_Thread::ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop)
 	Write(vu_addr);
 	Write(vif_top);
 	Write(vif_itop);
-	CommitWritePos();
+	m_batch_cmds++;
+	CommitWritePos(); // Publishes the pending batch along with the execute command
 	gifUnit.TransferGSPacketData(GIF_TRANS_MTVU, NULL, 0);
 	KickStart();
 	u32 cycles = std::min(Get_vuCycles(), 3000u);
@@ -342,8 +468,7 @@ void VU_Thread::VifUnpack(vifStruct& _vif, VIFregisters& _vifRegs, u8* data, u32
 	WriteRegs(&_vifRegs);
 	Write(size);
 	Write(data, size);
-	CommitWritePos();
-	KickStart();
+	EndCommand();
 }
 
 void VU_Thread::WriteMicroMem(u32 vu_micro_addr, void* data, u32 size)
@@ -354,7 +479,7 @@ void VU_Thread::WriteMicroMem(u32 vu_micro_addr, void* data, u32 size)
 	Write(vu_micro_addr);
 	Write(size);
 	Write(data, size);
-	CommitWritePos();
+	EndCommand();
 }
 
 void VU_Thread::WriteDataMem(u32 vu_data_addr, void* data, u32 size)
@@ -365,7 +490,7 @@ void VU_Thread::WriteDataMem(u32 vu_data_addr, void* data, u32 size)
 	Write(vu_data_addr);
 	Write(size);
 	Write(data, size);
-	CommitWritePos();
+	EndCommand();
 }
 
 void VU_Thread::WriteCol(vifStruct& _vif)
@@ -374,7 +499,7 @@ void VU_Thread::WriteCol(vifStruct& _vif)
 	ReserveSpace(1 + size_u32(sizeof(_vif.MaskCol)));
 	Write(MTVU_VIF_WRITE_COL);
 	Write(&_vif.MaskCol, sizeof(_vif.MaskCol));
-	CommitWritePos();
+	EndCommand();
 }
 
 void VU_Thread::WriteRow(vifStruct& _vif)
@@ -383,5 +508,5 @@ void VU_Thread::WriteRow(vifStruct& _vif)
 	ReserveSpace(1 + size_u32(sizeof(_vif.MaskRow)));
 	Write(MTVU_VIF_WRITE_ROW);
 	Write(&_vif.MaskRow, sizeof(_vif.MaskRow));
-	CommitWritePos();
+	EndCommand();
 }
@@ -22,16 +22,30 @@
 #define MTVU_LOG(...) do{} while(0)
 //#define MTVU_LOG DevCon.WriteLn
 
+// Per-frame snapshot of the EE->VU1 handoff counters (see VU_Thread::PostVsync).
+struct MTVU_RingStats
+{
+	u32 Packets;   // batches published to the MTVU thread
+	u32 Commands;  // unpack/memory/col/row/execute commands carried by those batches
+	u32 WakePosts; // semaphore posts issued to wake the MTVU thread
+	u32 Spins;     // times MTVU picked up new work while spinning (no wakeup needed)
+	u32 Idles;     // times MTVU ran dry and went to sleep
+	u32 EEStalls;  // times the EE had to wait on MTVU (ring full or WaitVU)
+	u32 EEStallUs; // time the EE spent in those waits, in microseconds
+};
+
 // Notes:
 // - This class should only be accessed from the EE thread...
 // - buffer_size must be power of 2
 // - ring-buffer has no complete pending packets when read_pos==write_pos
 class VU_Thread : public pxThread {
 	static const s32 buffer_size = (_1mb * 16) / sizeof(s32);
+	// Pending writes are handed over on their own once they reach this size (see EndCommand)
+	static const s32 batch_size  = _16kb / sizeof(s32);
 
 	u32 buffer[buffer_size];
 	// Note: keep atomic on separate cache line to avoid CPU conflict
-	__aligned(64) std::atomic<bool> isBusy;   // Is thread processing data?
+	__aligned(64) std::atomic<bool> m_parked; // MTVU is (about to be) asleep on semaEvent
 	__aligned(64) std::atomic<int> m_ato_read_pos; // Only modified by VU thread
 	__aligned(64) std::atomic<int> m_ato_write_pos;    // Only modified by EE thread
 	__aligned(64) int  m_read_pos; // temporary read pos (local to the VU thread)
@@ -41,6 +55,22 @@ class VU_Thread : public pxThread {
 	BaseVUmicroCPU*& vuCPU;
 	VURegs&          vuRegs;
 
+	u32 m_batch_cmds; // commands written since the last commit (local to the EE thread)
+
+	// Number of iterations MTVU spins on the ring before going to sleep.  Adapts to how
+	// quickly the EE has been refilling it, within the vuThreadSpin limit.
+	int m_SpinBudget;
+	int m_cpu;        // host cpu MTVU is currently pinned to (-1 for none)
+
+	std::atomic<u32> m_stat_Packets;
+	std::atomic<u32> m_stat_Commands;
+	std::atomic<u32> m_stat_WakePosts;
+	std::atomic<u32> m_stat_Spins;
+	std::atomic<u32> m_stat_Idles;
+	u32              m_stat_EEStalls;     // EE thread only
+	u64              m_stat_EEStallTicks; // EE thread only
+	MTVU_RingStats   m_FrameStats;
+
 public:
 	__aligned16  vifStruct        vif;
 	__aligned16  VIFregisters     vifRegs;
@@ -56,6 +86,13 @@ public:
 	// Get MTVU to start processing its packets if it isn't already
 	void KickStart(bool forceKick = false);
 
+	// Hands the pending batch of writes (if any) over to MTVU and wakes it up
+	void FlushBatch();
+
+	// Closes the handoff counters of the frame that just ended
+	void PostVsync();
+	MTVU_RingStats GetFrameStats() const { return m_FrameStats; }
+
 	// Used for assertions...
 	bool IsDone();
 
@@ -81,6 +118,8 @@ protected:
 
 private:
 	void ExecuteRingBuffer();
+	void WaitForRingWork();
+	void UpdateAffinity();
 
 	void WaitOnSize(s32 size);
 	void ReserveSpace(s32 size);
@@ -92,6 +131,7 @@ private:
 
 	void CommitWritePos();
 	void CommitReadPos();
+	void EndCommand();
 
 	u32 Read();
 	void Read(void* dest, u32 size);
@@ -706,6 +706,7 @@ void memBindConditionalHandlers()
 // --------------------------------------------------------------------------------------
 eeMemoryReserve::eeMemoryReserve()
 	: _parent( L"EE Main Memory", sizeof(*eeMem) )
+	, m_fastmem( L"EE Fastmem Guard" )
 {
 }
 
@@ -713,12 +714,22 @@ void eeMemoryReserve::Reserve()
 {
 	_parent::Reserve(HostMemoryMap::EEmem);
 	//_parent::Reserve(EmuConfig.HostMap.IOP);
+
+	// Main memory ends the reserve; the guard has to follow it directly for the physical
+	// space to be contiguous, anywhere else is useless.
+	uptr guard = (uptr)m_reserve.GetPtrEnd();
+	if (m_fastmem.Reserve( vtlb_private::VTLB_PMAP_SZ - Ps2MemSize::MainRam, guard ) != (void*)guard)
+	{
+		m_fastmem.Release();
+		Console.Warning( "(EErec) Fastmem disabled: host memory following the EE main memory is in use." );
+	}
 }
 
 void eeMemoryReserve::Commit()
 {
 	_parent::Commit();
 	eeMem = (EEVM_MemoryAllocMess*)m_reserve.GetPtr();
+	vtlb_private::vtlbdata.fastmem = m_fastmem.IsOk() ? eeMem->Main : NULL;
 }
 
 // Resets memory mappings, unmaps TLBs, reloads bios roms, etc.
@@ -854,13 +865,16 @@ void eeMemoryReserve::Decommit()
 {
 	_parent::Decommit();
 	eeMem = NULL;
+	vtlb_private::vtlbdata.fastmem = NULL;
 }
 
 void eeMemoryReserve::Release()
 {
 	safe_delete(mmap_faultHandler);
 	_parent::Release();
+	m_fastmem.Release();
 	eeMem = NULL;
+	vtlb_private::vtlbdata.fastmem = NULL;
 	vtlb_Term();
 }
 
@@ -979,7 +993,14 @@ void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& h
 
 	// get bad virtual address
 	uptr offset = info.addr - (uptr)eeMem->Main;
-	if( offset >= Ps2MemSize::MainRam ) return;
+	if( offset >= Ps2MemSize::MainRam )
+	{
+		// EErec fastmem access to something else than ram: the access is redone through
+		// the vtlb, and from now on that's what this code does.
+		if( offset < vtlb_private::VTLB_PMAP_SZ && vtlb_private::vtlbdata.fastmem )
+			handled = vtlb_DynGenFastmemFault( info.pc );
+		return;
+	}
 
 	mmap_ClearCpuBlock( offset );
 	handled = true;
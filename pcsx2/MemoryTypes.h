@@ -81,9 +81,10 @@ struct EEVM_MemoryAllocMess
 
 #else
 
+// Main memory is the last member on purpose: the EErec fastmem guard is reserved right
+// after it (see eeMemoryReserve).
 struct EEVM_MemoryAllocMess
 {
-	u8 Main[Ps2MemSize::MainRam];			// Main memory (hard-wired to 32MB)
 	u8 Scratch[Ps2MemSize::Scratch];		// Scratchpad!
 	u8 ROM[Ps2MemSize::Rom];				// Boot rom (4MB)
 	u8 ROM1[Ps2MemSize::Rom1];				// DVD player
@@ -97,6 +98,8 @@ struct EEVM_MemoryAllocMess
 
 	u8 ZeroRead[_1mb];
 	u8 ZeroWrite[_1mb];
+
+	u8 Main[Ps2MemSize::MainRam];			// Main memory (hard-wired to 32MB)
 };
 
 #endif
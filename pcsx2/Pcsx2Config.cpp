@@ -50,6 +50,8 @@ Pcsx2Config::SpeedhackOptions& Pcsx2Config::SpeedhackOptions::DisableAll()
 	bitset			= 0;
 	EECycleRate		= 0;
 	EECycleSkip		= 0;
+	vuThreadSpin	= 0;
+	vuThreadCpu		= -1;
 	
 	return *this;
 }
@@ -65,6 +67,9 @@ void Pcsx2Config::SpeedhackOptions::LoadSave( IniInterface& ini )
 	IniBitBool( WaitLoop );
 	IniBitBool( vuFlagHack );
 	IniBitBool( vuThread );
+	IniBitBool( ipuThread );
+	IniEntry( vuThreadSpin );
+	IniEntry( vuThreadCpu );
 }
 
 void Pcsx2Config::ProfilerOptions::LoadSave( IniInterface& ini )
@@ -89,6 +94,8 @@ Pcsx2Config::RecompilerOptions::RecompilerOptions()
 
 	EnableEE	= true;
 	EnableEECache = false;
+	EnableEEBlockCache = false;
+	EnableFastmem = true;
 	EnableIOP	= true;
 	EnableVU0	= true;
 	EnableVU1	= true;
@@ -147,6 +154,8 @@ void Pcsx2Config::RecompilerOptions::LoadSave( IniInterface& ini )
 	IniBitBool( EnableEE );
 	IniBitBool( EnableIOP );
 	IniBitBool( EnableEECache );
+	IniBitBool( EnableEEBlockCache );
+	IniBitBool( EnableFastmem );
 	IniBitBool( EnableVU0 );
 	IniBitBool( EnableVU1 );
 
@@ -204,6 +213,7 @@ Pcsx2Config::GSOptions::GSOptions()
 	VsyncEnable				= VsyncMode::Off;
 
 	SynchronousMTGS			= false;
+	SpinWaitMTGS			= false;
 	VsyncQueueSize			= 2;
 
 	FramesToDraw			= 2;
@@ -219,6 +229,7 @@ void Pcsx2Config::GSOptions::LoadSave( IniInterface& ini )
 	ScopedIniGroup path( ini, L"GS" );
 
 	IniEntry( SynchronousMTGS );
+	IniEntry( SpinWaitMTGS );
 	IniEntry( VsyncQueueSize );
 
 	IniEntry( FrameLimitEnable );
@@ -439,6 +450,7 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 #endif
 	IniBitBool( ConsoleToStdio );
 	IniBitBool( HostFs );
+	IniBitBool( PinThreads );
 
 	IniBitBool( BackupSavestate );
 	IniBitBool( McdEnableEjection );
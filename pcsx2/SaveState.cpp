@@ -22,6 +22,7 @@
 #include "COP0.h"
 #include "VUmicro.h"
 #include "MTVU.h"
+#include "IPU/IPUThread.h"
 #include "Cache.h"
 #include "AppConfig.h"
 
@@ -152,6 +153,7 @@ static const uint MainMemorySizeInBytes =
 SaveStateBase& SaveStateBase::FreezeMainMemory()
 {
 	vu1Thread.WaitVU(); // Finish VU1 just in-case...
+	ipuThread.Stop(); // The IPU registers are part of eeHw
 	if (IsLoading()) PreLoadPrep();
 	else m_memory->MakeRoomFor( m_idx + MainMemorySizeInBytes );
 
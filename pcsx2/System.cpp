@@ -19,6 +19,7 @@
 #include "VUmicro.h"
 #include "newVif.h"
 #include "MTVU.h"
+#include "IPU/IPUThread.h"
 
 #include "Elfheader.h"
 
@@ -419,6 +420,7 @@ void SysMainMemory::DecommitAll()
 	// The EE thread must be stopped here command mustn't be send
 	// to the ring. Let's call it an extra safety valve :)
 	vu1Thread.Reset();
+	ipuThread.Reset();
 
 	m_ee.Decommit();
 	m_iop.Decommit();
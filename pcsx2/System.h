@@ -46,41 +46,42 @@ namespace HostMemoryMap
 	// as S = (M >> 3) + 0x20000000. So PCSX2 can't use 0x20000000 to 0x3FFFFFFF... Just add another
 	// 0x20000000 offset to avoid conflict.
 	static const uptr EEmem		= 0x40000000;
-	static const uptr IOPmem	= 0x44000000;
-	static const uptr VUmem		= 0x48000000;
-	static const uptr EErec		= 0x50000000;
-	static const uptr IOPrec	= 0x54000000;
-	static const uptr VIF0rec	= 0x56000000;
-	static const uptr VIF1rec	= 0x58000000;
-	static const uptr mVU0rec	= 0x5C000000;
-	static const uptr mVU1rec	= 0x60000000;
+	static const uptr IOPmem	= 0x64000000;
+	static const uptr VUmem		= 0x68000000;
+	static const uptr EErec		= 0x70000000;
+	static const uptr IOPrec	= 0x74000000;
+	static const uptr VIF0rec	= 0x76000000;
+	static const uptr VIF1rec	= 0x78000000;
+	static const uptr mVU0rec	= 0x7C000000;
+	static const uptr mVU1rec	= 0x80000000;
 #else
-	// PS2 main memory, SPR, and ROMs
+	// PS2 main memory, SPR, and ROMs.  Main memory comes last and is followed by the EErec
+	// fastmem guard, which spans the rest of the 512mb EE physical space.
 	static const uptr EEmem		= 0x20000000;
 
 	// IOP main memory and ROMs
-	static const uptr IOPmem	= 0x24000000;
+	static const uptr IOPmem	= 0x44000000;
 
 	// VU0 and VU1 memory.
-	static const uptr VUmem		= 0x28000000;
+	static const uptr VUmem		= 0x48000000;
 
 	// EE recompiler code cache area (64mb)
-	static const uptr EErec		= 0x30000000;
+	static const uptr EErec		= 0x50000000;
 
 	// IOP recompiler code cache area (16 or 32mb)
-	static const uptr IOPrec	= 0x34000000;
+	static const uptr IOPrec	= 0x54000000;
 
 	// newVif0 recompiler code cache area (16mb)
-	static const uptr VIF0rec	= 0x36000000;
+	static const uptr VIF0rec	= 0x56000000;
 
 	// newVif1 recompiler code cache area (32mb)
-	static const uptr VIF1rec	= 0x38000000;
+	static const uptr VIF1rec	= 0x58000000;
 
 	// microVU1 recompiler code cache area (32 or 64mb)
-	static const uptr mVU0rec	= 0x3C000000;
+	static const uptr mVU0rec	= 0x5C000000;
 
 	// microVU0 recompiler code cache area (64mb)
-	static const uptr mVU1rec	= 0x40000000;
+	static const uptr mVU1rec	= 0x60000000;
 #endif
 
 }
@@ -162,6 +163,10 @@ extern void SysLogMachineCaps();		// Detects cpu type and fills cpuInfo structs.
 extern void SysClearExecutionCache();	// clears recompiled execution caches!
 extern void SysOutOfMemory_EmergencyResponse(uptr blocksize);
 
+extern void SysApplyThreadPlacement();		// (re)pins the emulator threads when PinThreads is enabled
+extern void SysUpdateThreadPlacement();		// once per vsync: places new threads, samples migrations
+extern void SysLogThreadPlacement();		// logs the placement along with the migration counts
+
 extern u8 *SysMmapEx(uptr base, u32 size, uptr bounds, const char *caller="Unnamed");
 extern void vSyncDebugStuff( uint frame );
 extern void NTFS_CompressFile( const wxString& file, bool compressStatus=true );
@@ -225,6 +225,7 @@ void SysCoreThread::DoCpuReset()
 void SysCoreThread::VsyncInThread()
 {
 	ApplyLoadedPatches(PPT_CONTINUOUSLY);
+	SysUpdateThreadPlacement();
 }
 
 void SysCoreThread::GameStartingInThread()
@@ -274,12 +275,15 @@ void SysCoreThread::ExecuteTaskInThread()
 
 void SysCoreThread::OnSuspendInThread()
 {
+	SysLogThreadPlacement();
 	GetCorePlugins().Close();
 }
 
 void SysCoreThread::OnResumeInThread( bool isSuspended )
 {
 	GetCorePlugins().Open();
+	// After the plugins, which own some of the placed threads
+	SysApplyThreadPlacement();
 }
 
 
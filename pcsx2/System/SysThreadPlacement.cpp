@@ -0,0 +1,454 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// --------------------------------------------------------------------------------------
+//  Thread placement
+// --------------------------------------------------------------------------------------
+// Pins the emulator threads to host cpus following the cpu topology exported in /sys.
+// Threads are found by name in /proc/self/task, which also covers the threads owned by
+// the plugins (GSdx rasterizers, SPU2 output, CDVD reader).
+//
+// The EE, MTGS and MTVU threads get a physical core each, and the SMT siblings of those
+// cores are left idle so that the hot threads don't share execution units.  The other
+// threads are spread over the remaining cores, siblings included, and are left to the OS
+// once there is no free cpu left.
+//
+// Linux only.  Elsewhere PinThreads does nothing besides a warning.
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "System.h"
+
+#ifdef __linux__
+
+#include <sched.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <algorithm>
+
+static const struct
+{
+	const char*	prefix;
+	bool		exclusive;	// gets a whole physical core
+} s_roles[] =
+{
+	{ "EE Core",		true },
+	{ "MTGS",			true },
+	{ "MTVU",			true },
+	{ "GSdx raster",	false },
+	{ "SPU2 output",	false },
+	{ "CDVD reader",	false },
+	{ "IPU decode",		false },
+};
+
+struct HostCore
+{
+	int		package;
+	int		id;
+	std::vector<int> cpus;	// logical cpus (SMT siblings) of the core
+	int		users;			// placed threads running on the core
+	bool	exclusive;		// reserved for one of the hot threads
+};
+
+struct PlacedThread
+{
+	pid_t	tid;
+	char	name[16];
+	int		cpu;			// -1 when left to the OS
+	int		lastcpu;		// cpu the thread was last seen running on
+	u32		migrations;
+};
+
+static bool s_active = false;
+static uint s_frames = 0;
+static cpu_set_t s_allowed;
+static std::vector<HostCore> s_cores;
+static std::vector<int> s_cpu_users;
+static std::vector<PlacedThread> s_threads;
+
+// Threads which don't match any role, with the number of scans they were seen in.  Names
+// are set right after a thread starts, one which still doesn't match on its second scan
+// isn't read again.
+struct UnmatchedThread
+{
+	pid_t	tid;
+	u32		scans;
+};
+
+static std::vector<UnmatchedThread> s_unmatched;
+
+static bool ReadLine(const char* path, char* buf, int size)
+{
+	FILE* fp = fopen(path, "r");
+	if (!fp) return false;
+
+	bool ok = fgets(buf, size, fp) != NULL;
+	fclose(fp);
+
+	if (ok) buf[strcspn(buf, "\n")] = 0;
+	return ok;
+}
+
+static int ReadInt(const char* path, int defval)
+{
+	char buf[32];
+	return ReadLine(path, buf, sizeof(buf)) ? atoi(buf) : defval;
+}
+
+// Parses the kernel cpu list format ("0-3,8,10-11")
+static std::vector<int> ParseCpuList(const char* list)
+{
+	std::vector<int> cpus;
+
+	while (*list)
+	{
+		char* end;
+		int first = strtol(list, &end, 10);
+		int last = first;
+		if (end == list) break;
+
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+
+		for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+			cpus.push_back(cpu);
+
+		list = (*end == ',') ? end + 1 : end;
+		if (*end != ',') break;
+	}
+
+	return cpus;
+}
+
+static void ReadTopology()
+{
+	s_cores.clear();
+
+	// The main (UI) thread is never pinned, its mask is the one the process was started with.
+	CPU_ZERO(&s_allowed);
+	if (sched_getaffinity(getpid(), sizeof(s_allowed), &s_allowed))
+		return;
+
+	char online[256];
+	if (!ReadLine("/sys/devices/system/cpu/online", online, sizeof(online)))
+		return;
+
+	int maxcpu = 0;
+	for (int cpu : ParseCpuList(online))
+	{
+		if (!CPU_ISSET(cpu, &s_allowed)) continue;
+
+		// Without topology information every cpu is a core of its own.
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+		const int id = ReadInt(path, cpu);
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+		const int package = ReadInt(path, 0);
+
+		HostCore* core = NULL;
+		for (HostCore& c : s_cores)
+		{
+			if (c.package == package && c.id == id)
+				core = &c;
+		}
+
+		if (!core)
+		{
+			HostCore c = { package, id, {}, 0, false };
+			s_cores.push_back(c);
+			core = &s_cores.back();
+		}
+
+		core->cpus.push_back(cpu);
+		maxcpu = std::max(maxcpu, cpu);
+	}
+
+	s_cpu_users.assign(maxcpu + 1, 0);
+}
+
+static HostCore* FindCore(int cpu)
+{
+	for (HostCore& core : s_cores)
+	{
+		for (int c : core.cpus)
+		{
+			if (c == cpu) return &core;
+		}
+	}
+	return NULL;
+}
+
+static int PickCpu(bool exclusive)
+{
+	HostCore* best = NULL;
+
+	for (HostCore& core : s_cores)
+	{
+		if (core.exclusive) continue;
+
+		if (exclusive ? core.users == 0 : core.users < (int)core.cpus.size())
+		{
+			// Fill the cores one thread at a time before doubling up on siblings.
+			if (!best || core.users < best->users)
+				best = &core;
+		}
+	}
+
+	if (!best) return -1;
+
+	for (int cpu : best->cpus)
+	{
+		if (s_cpu_users[cpu] == 0)
+		{
+			best->users++;
+			best->exclusive = exclusive;
+			s_cpu_users[cpu]++;
+			return cpu;
+		}
+	}
+
+	return -1;
+}
+
+static void ReleaseCpu(int cpu)
+{
+	if (HostCore* core = FindCore(cpu))
+	{
+		core->users--;
+		core->exclusive = false;
+		s_cpu_users[cpu]--;
+	}
+}
+
+static bool PinThread(pid_t tid, int cpu)
+{
+	cpu_set_t set;
+	if (cpu < 0)
+		set = s_allowed;
+	else
+	{
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+	}
+
+	return sched_setaffinity(tid, sizeof(set), &set) == 0;
+}
+
+// Returns the cpu the thread last ran on, or -1 if the thread is gone.
+static int GetThreadCpu(pid_t tid)
+{
+	char path[64], stat[1024];
+	snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+	if (!ReadLine(path, stat, sizeof(stat)))
+		return -1;
+
+	// The processor is the 39th field.  The name (2nd field) may contain spaces, so count
+	// from the closing parenthesis, which is followed by the 3rd field.
+	const char* p = strrchr(stat, ')');
+	if (!p) return -1;
+
+	for (int field = 2; field < 39 && p; field++)
+		p = strchr(p + 1, ' ');
+
+	return p ? atoi(p + 1) : -1;
+}
+
+static void LogPlacement(const PlacedThread& thread)
+{
+	const HostCore* core = thread.cpu >= 0 ? FindCore(thread.cpu) : NULL;
+
+	if (core)
+		Console.WriteLn("%-12s (tid %d): cpu %d (core %d, package %d), %u migrations",
+			thread.name, thread.tid, thread.cpu, core->id, core->package, thread.migrations);
+	else
+		Console.WriteLn("%-12s (tid %d): not pinned, %u migrations", thread.name, thread.tid, thread.migrations);
+}
+
+// Places the named threads which aren't tracked yet.  The hot threads are looked up
+// first so that they get their cores even if the other threads were started earlier.
+static void ScanThreads()
+{
+	DIR* dir = opendir("/proc/self/task");
+	if (!dir) return;
+
+	struct Found { pid_t tid; char name[16]; bool exclusive; };
+	std::vector<Found> found;
+	std::vector<UnmatchedThread> unmatched;
+
+	while (struct dirent* entry = readdir(dir))
+	{
+		const pid_t tid = atoi(entry->d_name);
+		if (tid <= 0) continue;
+
+		bool known = false;
+		for (const PlacedThread& thread : s_threads)
+			known |= thread.tid == tid;
+		if (known) continue;
+
+		u32 scans = 0;
+		for (const UnmatchedThread& thread : s_unmatched)
+		{
+			if (thread.tid == tid) scans = thread.scans;
+		}
+
+		if (scans >= 2)
+		{
+			unmatched.push_back(UnmatchedThread{tid, scans});
+			continue;
+		}
+
+		char path[64], name[16];
+		snprintf(path, sizeof(path), "/proc/self/task/%d/comm", tid);
+		if (!ReadLine(path, name, sizeof(name))) continue;
+
+		bool matched = false;
+		for (const auto& role : s_roles)
+		{
+			if (strncmp(name, role.prefix, strlen(role.prefix)) == 0)
+			{
+				Found f;
+				f.tid = tid;
+				f.exclusive = role.exclusive;
+				strcpy(f.name, name);
+				found.push_back(f);
+				matched = true;
+				break;
+			}
+		}
+
+		if (!matched)
+			unmatched.push_back(UnmatchedThread{tid, scans + 1});
+	}
+
+	closedir(dir);
+
+	// Threads which exited drop out of the list
+	s_unmatched.swap(unmatched);
+
+	std::stable_sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.exclusive && !b.exclusive; });
+
+	for (const Found& f : found)
+	{
+		PlacedThread thread;
+		thread.tid = f.tid;
+		strcpy(thread.name, f.name);
+		thread.migrations = 0;
+		thread.lastcpu = GetThreadCpu(f.tid);
+
+		// An explicit MTVU cpu (Speedhacks.vuThreadCpu) wins over the placement.
+		const bool skip = !strcmp(f.name, "MTVU") && EmuConfig.Speedhacks.vuThreadCpu >= 0;
+
+		thread.cpu = skip ? -1 : PickCpu(f.exclusive);
+		if (thread.cpu >= 0 && !PinThread(f.tid, thread.cpu))
+		{
+			Console.Warning("Thread placement: could not pin %s (tid %d) to cpu %d", f.name, f.tid, thread.cpu);
+			ReleaseCpu(thread.cpu);
+			thread.cpu = -1;
+		}
+
+		s_threads.push_back(thread);
+		LogPlacement(thread);
+	}
+}
+
+static void ResetPlacement()
+{
+	for (const PlacedThread& thread : s_threads)
+	{
+		if (thread.cpu >= 0)
+			PinThread(thread.tid, -1);
+	}
+
+	s_threads.clear();
+	s_unmatched.clear();
+	s_active = false;
+}
+
+void SysApplyThreadPlacement()
+{
+	ResetPlacement();
+
+	if (!EmuConfig.PinThreads) return;
+
+	ReadTopology();
+	if (s_cores.size() < 2)
+	{
+		Console.Warning("Thread placement: not enough cpu cores, threads are left to the OS.");
+		return;
+	}
+
+	Console.WriteLn(Color_StrongBlack, "Thread placement: %u cores available", (uint)s_cores.size());
+	ConsoleIndentScope indent(1);
+
+	ScanThreads();
+	s_active = true;
+	s_frames = 0;
+}
+
+void SysUpdateThreadPlacement()
+{
+	// Once a second or so, /proc reads aren't free.
+	if (!s_active || ++s_frames < 60) return;
+	s_frames = 0;
+
+	for (size_t i = 0; i < s_threads.size();)
+	{
+		PlacedThread& thread = s_threads[i];
+		const int cpu = GetThreadCpu(thread.tid);
+
+		if (cpu < 0)
+		{
+			// The thread has exited (renderer or plugin change), its cpu can be reused.
+			if (thread.cpu >= 0) ReleaseCpu(thread.cpu);
+			s_threads.erase(s_threads.begin() + i);
+			continue;
+		}
+
+		if (cpu != thread.lastcpu)
+		{
+			thread.migrations++;
+			thread.lastcpu = cpu;
+		}
+		i++;
+	}
+
+	// Threads started after the plugins were opened (audio callbacks, lazily created workers)
+	ScanThreads();
+}
+
+void SysLogThreadPlacement()
+{
+	if (!s_active) return;
+
+	Console.WriteLn(Color_StrongBlack, "Thread placement:");
+	ConsoleIndentScope indent(1);
+
+	for (const PlacedThread& thread : s_threads)
+		LogPlacement(thread);
+}
+
+#else
+
+void SysApplyThreadPlacement()
+{
+	if (EmuConfig.PinThreads)
+		Console.Warning("Thread placement is only supported on Linux.");
+}
+
+void SysUpdateThreadPlacement() {}
+void SysLogThreadPlacement() {}
+
+#endif
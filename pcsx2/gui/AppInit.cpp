@@ -19,6 +19,9 @@
 #include "ConsoleLogger.h"
 #include "MSWstuff.h"
 #include "MTVU.h" // for thread cancellation on shutdown
+#include "AsyncFileReader.h"
+#include "IPU/IPU.h"
+#include "IPU/IPUThread.h" // for thread cancellation on shutdown
 
 #include "Utilities/IniInterface.h"
 #include "DebugTools/Debug.h"
@@ -242,6 +245,9 @@ void Pcsx2App::OnInitCmdLine( wxCmdLineParser& parser )
 	parser.AddSwitch( wxEmptyString,L"portable",	_("enables portable mode operation (requires admin/root access)") );
 
 	parser.AddSwitch( wxEmptyString,L"profiling",	_("update options to ease profiling (debug)") );
+	parser.AddOption( wxEmptyString,L"readtrace",	_("replays a CDVD read trace against the IsoFile with each file reader backend, then exits (benchmark)"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"ipucapture",	_("records the IPU commands and input data to the specified file, from the next IPU reset on"), wxCMD_LINE_VAL_STRING );
+	parser.AddOption( wxEmptyString,L"ipubench",	_("replays an IPU capture with each IDCT/colour conversion kernel set, then exits (benchmark)"), wxCMD_LINE_VAL_STRING );
 
 	const PluginInfo* pi = tbl_PluginInfo; do {
 		parser.AddOption( wxEmptyString, pi->GetShortname().Lower(),
@@ -339,6 +345,26 @@ bool Pcsx2App::OnCmdLineParsed( wxCmdLineParser& parser )
 	Startup.ForceWizard		= parser.Found(L"forcewiz");
 	Startup.PortableMode	= parser.Found(L"portable");
 
+	// The benchmarks run before anything else is started, and leave with their result as
+	// the exit code (returning false from here always exits with -1).
+	wxString readtrace;
+	if (parser.Found(L"readtrace", &readtrace))
+	{
+		bool ok = false;
+		if (parser.GetParamCount() < 1)
+			Console.Error("--readtrace needs an IsoFile to read from.");
+		else
+			ok = RunReadTraceBenchmark(parser.GetParam( 0 ), readtrace);
+		exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	wxString ipufile;
+	if (parser.Found(L"ipubench", &ipufile))
+		exit(RunIpuBenchmark(ipufile) ? EXIT_SUCCESS : EXIT_FAILURE);
+
+	if (parser.Found(L"ipucapture", &ipufile))
+		ipuCaptureOpen(ipufile);
+
 	if( parser.GetParamCount() >= 1 )
 	{
 		Startup.IsoFile		= parser.GetParam( 0 );
@@ -747,6 +773,7 @@ Pcsx2App::~Pcsx2App()
 	pxDoAssert = pxAssertImpl_LogIt;	
 	try {
 		vu1Thread.Cancel();
+		ipuThread.Cancel();
 	}
 	DESTRUCTOR_CATCHALL
 }
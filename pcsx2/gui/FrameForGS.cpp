@@ -20,6 +20,7 @@
 #include "AppSaveStates.h"
 #include "Counters.h"
 #include "GS.h"
+#include "MTVU.h"
 #include "MSWstuff.h"
 
 #include "ConsoleLogger.h"
@@ -692,6 +693,24 @@ void GSFrame::OnUpdateTitle( wxTimerEvent& evt )
 	out << std::fixed << std::setprecision(2) << fps;
 	OSDmonitor(Color_StrongGreen, "FPS:", out.str());
 
+#if defined(PCSX2_DEBUG) || defined(PCSX2_DEVBUILD)
+	const MTGS_RingStats ringStats = GetMTGS().GetFrameStats();
+	std::ostringstream ring;
+	ring << "stall " << ringStats.ProducerStalls << " idle " << ringStats.ConsumerIdles
+		<< " spin " << ringStats.ConsumerSpins << " wake " << ringStats.WakeSyscalls;
+	OSDmonitor(Color_StrongGreen, "MTGS:", ring.str());
+
+	if (THREAD_VU1)
+	{
+		const MTVU_RingStats vuStats = vu1Thread.GetFrameStats();
+		std::ostringstream vu;
+		vu << "pkt " << vuStats.Packets << " cmd " << vuStats.Commands << " wake " << vuStats.WakePosts
+			<< " spin " << vuStats.Spins << " idle " << vuStats.Idles
+			<< " stall " << vuStats.EEStalls << "/" << vuStats.EEStallUs << "us";
+		OSDmonitor(Color_StrongGreen, "MTVU:", vu.str());
+	}
+#endif
+
 #ifdef __linux__
 	// Important Linux note: When the title is set in fullscreen the window is redrawn. Unfortunately
 	// an intermediate white screen appears too which leads to a very annoying flickering.
@@ -661,6 +661,56 @@ __fi u32 vtlb_V2P(u32 vaddr)
 	return paddr;
 }
 
+// --------------------------------------------------------------------------------------
+//  EErec fastmem page tracking
+// --------------------------------------------------------------------------------------
+// Fastmem accesses fold the virtual address onto the physical space (vaddr & 0x1fffffff).
+// That is only right while every virtual page folding onto main ram is mapped onto that same
+// ram page, or not mapped at all (such accesses are bugs of the game anyway).  Pages breaking
+// the rule are counted here: new blocks don't use fastmem while there is any, and blocks which
+// were compiled with fastmem are cleared when the first one shows up.
+
+static const uint FastmemRamPages = Ps2MemSize::MainRam / VTLB_PAGE_SIZE;
+
+static u8 fastmem_conflict[(_4gb / VTLB_PMAP_SZ) * FastmemRamPages];
+
+static void vtlb_FastmemUpdatePage(u32 vaddr)
+{
+	if (!vtlbdata.fastmem) return;
+
+	const u32 paddr = vaddr & VTLB_FASTMEM_MASK;
+	if (paddr >= Ps2MemSize::MainRam) return; // faults in the guard, always safe
+
+	uptr vmv = vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS];
+	sptr ppf = vaddr + vmv;
+
+	bool conflict;
+	if (ppf < 0)
+	{
+		vtlbHandler handler = (u8)ppf;
+		conflict = handler != UnmappedVirtHandler0 && handler != UnmappedVirtHandler1;
+	}
+	else
+	{
+		conflict = ppf != (sptr)(vtlbdata.fastmem + paddr);
+	}
+
+	u8& entry = fastmem_conflict[(vaddr / VTLB_PMAP_SZ) * FastmemRamPages + (paddr >> VTLB_PAGE_BITS)];
+	if (entry == (u8)conflict) return;
+	entry = conflict;
+
+	if (!conflict)
+	{
+		vtlbdata.fastmem_conflicts--;
+	}
+	else if (vtlbdata.fastmem_conflicts++ == 0 && vtlbdata.fastmem_used)
+	{
+		vtlbdata.fastmem_used = false;
+		Cpu->Clear(0x00000000, Ps2MemSize::MainRam / 4);
+		Cpu->Clear(0x1fc00000, Ps2MemSize::Rom / 4);
+	}
+}
+
 //virtual mappings
 //TODO: Add invalid paddr checks
 void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
@@ -688,6 +738,7 @@ void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
 		}
 
 		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = pme-vaddr;
+		vtlb_FastmemUpdatePage(vaddr);
 		if (vtlbdata.ppmap)
 			if (!(vaddr & 0x80000000)) // those address are already physical don't change them
 				vtlbdata.ppmap[vaddr>>VTLB_PAGE_BITS] = paddr & ~VTLB_PAGE_MASK;
@@ -707,6 +758,7 @@ void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
 	while (size > 0)
 	{
 		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = bu8-vaddr;
+		vtlb_FastmemUpdatePage(vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		bu8 += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
@@ -730,6 +782,7 @@ void vtlb_VMapUnmap(u32 vaddr,u32 size)
 		handl |= 0x80000000;
 
 		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = handl-vaddr;
+		vtlb_FastmemUpdatePage(vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
 	}
@@ -766,6 +819,11 @@ void vtlb_Init()
 	//Setup the initial mappings
 	vtlb_MapHandler(DefaultPhyHandler,0,VTLB_PMAP_SZ);
 
+	// Every V page is (re)mapped below, fastmem tracking starts over
+	memzero(fastmem_conflict);
+	vtlbdata.fastmem_conflicts = 0;
+	vtlbdata.fastmem_used = false;
+
 	//Set the V space as unmapped
 	vtlb_VMapUnmap(0,(VTLB_VMAP_ITEMS-1)*VTLB_PAGE_SIZE);
 	//yeah i know, its stupid .. but this code has to be here for now ;p
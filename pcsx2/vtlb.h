@@ -90,6 +90,9 @@ extern void vtlb_DynGenWrite_Const( u32 bits, u32 addr_const );
 extern void vtlb_DynGenRead64_Const( u32 bits, u32 addr_const );
 extern void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const );
 
+extern bool vtlb_DynGenFastmemFault( uptr* pc );
+extern void vtlb_DynGenFastmemReset();
+
 // --------------------------------------------------------------------------------------
 //  VtlbMemoryReserve
 // --------------------------------------------------------------------------------------
@@ -122,6 +125,11 @@ class eeMemoryReserve : public VtlbMemoryReserve
 {
 	typedef VtlbMemoryReserve _parent;
 
+protected:
+	// Reserved (never committed) range following main memory, so that EErec fastmem
+	// accesses to anything else than ram fault.
+	VirtualMemoryReserve	m_fastmem;
+
 public:
 	eeMemoryReserve();
 	virtual ~eeMemoryReserve()
@@ -189,6 +197,9 @@ namespace vtlb_private
 
 	static const uint VTLB_HANDLER_ITEMS = 128;
 
+	// EErec fastmem folds virtual addresses onto the physical space with this mask.
+	static const uint VTLB_FASTMEM_MASK	= VTLB_PMAP_SZ - 1;
+
 	static const uptr POINTER_SIGN_BIT = 1ULL << (sizeof(uptr) * 8 - 1);
 
 	struct MapData
@@ -204,10 +215,17 @@ namespace vtlb_private
 
 		u32* ppmap;               //4MB (allocated by vtlb_init) // PS2 virtual to PS2 physical
 
+		u8* fastmem;              // PS2 physical 0 in the EErec fastmem window, NULL if unavailable
+		u32 fastmem_conflicts;    // virtual pages folding onto ram which aren't mapped onto it
+		bool fastmem_used;        // fastmem accesses were compiled since the last rec reset
+
 		MapData()
 		{
 			vmap = NULL;
 			ppmap = NULL;
+			fastmem = NULL;
+			fastmem_conflicts = 0;
+			fastmem_used = false;
 		}
 	};
 
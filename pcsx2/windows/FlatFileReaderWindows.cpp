@@ -16,7 +16,7 @@
 #include "PrecompiledHeader.h"
 #include "AsyncFileReader.h"
 
-FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite)
+FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite), m_backend(Backend_Default)
 {
 	m_blocksize = 2048;
 	hOverlappedFile = INVALID_HANDLE_VALUE;
@@ -29,6 +29,11 @@ FlatFileReader::~FlatFileReader(void)
 	Close();
 }
 
+const char* FlatFileReader::GetBackendName() const
+{
+	return "overlapped";
+}
+
 bool FlatFileReader::Open(const wxString& fileName)
 {
 	m_filename = fileName;
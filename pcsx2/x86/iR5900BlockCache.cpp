@@ -0,0 +1,218 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "Common.h"
+#include "Memory.h"
+#include "iR5900BlockCache.h"
+
+#include "AppConfig.h"
+#include "svnrev.h"
+
+#include <wx/ffile.h>
+
+RecBlockCache eeBlockCache;
+
+static const char BlockCacheMagic[8] = { 'E','E','R','E','C','B','L','K' };
+// Block boundaries depend on the recompiler itself (page splits, breakpoints, branch
+// handling...), so anything written by another revision is thrown away.  Bump the
+// version when changing how blocks are split, for builds that share a revision.
+static const u32 BlockCacheVersion = 2;
+static const char BlockCacheBuild[] = GIT_REV;
+
+#ifdef _MSC_VER
+#	pragma pack(1)
+#endif
+
+struct BlockCacheHeader
+{
+	char	magic[8];
+	u32		version;
+	u32		crc;
+	char	build[64];
+	u32		count;
+} __packed;
+
+#ifdef _MSC_VER
+#	pragma pack()
+#endif
+
+// FNV-1a over the instruction words.  Only has to tell apart different code living at
+// the same address (overlays), so it doesn't need to be anything fancy.
+u64 RecBlockCache::Hash(const u32* code, u32 size)
+{
+	u64 hash = 0xcbf29ce484222325ULL;
+	for (u32 i = 0; i < size; i++)
+	{
+		hash ^= code[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+static wxDirName GetBlockCacheFolder()
+{
+	return PathDefs::GetDocuments() + wxDirName(L"cache");
+}
+
+wxString RecBlockCache::GetFilename(u32 crc) const
+{
+	return Path::Combine(GetBlockCacheFolder(), wxFileName(pxsFmt(L"eerec_%08X.bin", crc)));
+}
+
+void RecBlockCache::Open(u32 crc)
+{
+	if (crc == m_crc) return;
+
+	Close();
+
+	if (!crc) return;
+
+	m_crc = crc;
+	if (!Load())
+		m_pages.clear();
+}
+
+void RecBlockCache::Close()
+{
+	if (!m_crc) return;
+
+	if (m_dirty)
+		Save();
+
+	DevCon.WriteLn("(EErec) Block cache %08X: %u blocks loaded, %u recorded", m_crc, m_loaded, m_recorded);
+
+	m_pages.clear();
+	m_crc = 0;
+	m_dirty = false;
+	m_loaded = 0;
+	m_recorded = 0;
+}
+
+void RecBlockCache::Record(u32 startpc, u32 size, const u32* code)
+{
+	if (!m_crc) return;
+
+	const u64 hash = Hash(code, size);
+	std::vector<Block>& page = m_pages[startpc >> 12];
+
+	for (Block& block : page)
+	{
+		if (block.startpc != startpc) continue;
+
+		if (block.size != size || block.hash != hash)
+		{
+			// Overlay or self-modified code, the latest version wins.
+			block.size = size;
+			block.hash = hash;
+			m_dirty = true;
+		}
+		return;
+	}
+
+	Block block = { startpc, size, hash };
+	page.push_back(block);
+	m_dirty = true;
+	m_recorded++;
+}
+
+const std::vector<RecBlockCache::Block>* RecBlockCache::GetPage(u32 pc) const
+{
+	auto it = m_pages.find(pc >> 12);
+	return it != m_pages.end() ? &it->second : NULL;
+}
+
+bool RecBlockCache::IsValid(const Block& block)
+{
+	const u32* code = (u32*)PSM(block.startpc);
+	return code && Hash(code, block.size) == block.hash;
+}
+
+bool RecBlockCache::Load()
+{
+	wxString filename(GetFilename(m_crc));
+	if (!wxFileExists(filename)) return false;
+
+	wxFFile file(filename, L"rb");
+	if (!file.IsOpened()) return false;
+
+	BlockCacheHeader header;
+	if (file.Read(&header, sizeof(header)) != sizeof(header)
+		|| memcmp(header.magic, BlockCacheMagic, sizeof(header.magic))
+		|| header.version != BlockCacheVersion
+		|| header.crc != m_crc
+		|| header.count > Ps2MemSize::MainRam / 4)
+	{
+		Console.Warning(L"(EErec) Ignoring invalid block cache: %s", WX_STR(filename));
+		return false;
+	}
+
+	header.build[sizeof(header.build) - 1] = 0;
+	if (strcmp(header.build, BlockCacheBuild))
+	{
+		Console.WriteLn(L"(EErec) Block cache was written by another revision, discarding: %s", WX_STR(filename));
+		return false;
+	}
+
+	std::vector<Block> blocks(header.count);
+	if (header.count && file.Read(blocks.data(), header.count * sizeof(Block)) != header.count * sizeof(Block))
+	{
+		Console.Warning(L"(EErec) Truncated block cache: %s", WX_STR(filename));
+		return false;
+	}
+
+	for (const Block& block : blocks)
+	{
+		if (!block.size || block.size > 0xffff) continue;
+		m_pages[block.startpc >> 12].push_back(block);
+	}
+
+	m_loaded = header.count;
+	Console.WriteLn(Color_StrongBlack, "(EErec) Loaded %u cached blocks for game %08X", m_loaded, m_crc);
+
+	return true;
+}
+
+void RecBlockCache::Save()
+{
+	if (!GetBlockCacheFolder().Mkdir())
+		return;
+
+	wxString filename(GetFilename(m_crc));
+
+	BlockCacheHeader header;
+	memzero(header);
+	memcpy(header.magic, BlockCacheMagic, sizeof(header.magic));
+	header.version = BlockCacheVersion;
+	header.crc = m_crc;
+	strncpy(header.build, BlockCacheBuild, sizeof(header.build) - 1);
+
+	std::vector<Block> blocks;
+	for (const auto& page : m_pages)
+		blocks.insert(blocks.end(), page.second.begin(), page.second.end());
+	header.count = blocks.size();
+
+	wxFFile file(filename, L"wb");
+	if (!file.IsOpened()
+		|| file.Write(&header, sizeof(header)) != sizeof(header)
+		|| (header.count && file.Write(blocks.data(), header.count * sizeof(Block)) != header.count * sizeof(Block)))
+	{
+		Console.Warning(L"(EErec) Failed to save block cache: %s", WX_STR(filename));
+		return;
+	}
+
+	m_dirty = false;
+}
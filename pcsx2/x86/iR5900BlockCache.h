@@ -0,0 +1,78 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+// --------------------------------------------------------------------------------------
+//  RecBlockCache
+// --------------------------------------------------------------------------------------
+// Remembers which EE blocks a game compiled in previous sessions, so that the recompiler
+// can compile them in batches (a page at a time) the first time execution reaches their
+// page, instead of stalling once per block during the first minutes of a game.
+//
+// The generated x86 code itself is not persisted: it embeds host addresses (const buffer,
+// block links, helper functions) that change with every session.  What is persisted is
+// the block layout (start pc, size) together with a hash of the guest code, which is
+// checked against the current RAM contents before anything gets compiled.
+//
+// Cache files are keyed by the game CRC, and are discarded when the emulator revision
+// or the cache version differs from the one that wrote them.
+//
+class RecBlockCache
+{
+public:
+	struct Block
+	{
+		u32 startpc;
+		u32 size;		// in instructions
+		u64 hash;		// of the guest code
+	};
+
+	RecBlockCache() : m_crc(0), m_dirty(false), m_loaded(0), m_recorded(0) {}
+
+	// Saves the blocks of the current game (if any) and loads the ones of the given game.
+	void Open(u32 crc);
+	void Close();
+	bool IsOpen() const { return m_crc != 0; }
+
+	void Record(u32 startpc, u32 size, const u32* code);
+
+	// Blocks recorded in the 4k page holding 'pc', or NULL if there are none.
+	const std::vector<Block>* GetPage(u32 pc) const;
+
+	// True if the guest code in RAM still matches the block.  Hashes the whole block, so
+	// callers should leave it for last.
+	static bool IsValid(const Block& block);
+
+	static u64 Hash(const u32* code, u32 size);
+
+protected:
+	wxString GetFilename(u32 crc) const;
+	bool Load();
+	void Save();
+
+	u32 m_crc;
+	bool m_dirty;
+	uint m_loaded;
+	uint m_recorded;
+
+	// Blocks indexed by page (pc >> 12)
+	std::unordered_map<u32, std::vector<Block>> m_pages;
+};
+
+extern RecBlockCache eeBlockCache;
@@ -21,6 +21,7 @@
 #include "R5900Exceptions.h"
 #include "R5900OpcodeTables.h"
 #include "iR5900.h"
+#include "iR5900BlockCache.h"
 #include "BaseblockEx.h"
 #include "System/RecTypes.h"
 
@@ -35,6 +36,8 @@
 #include "../DebugTools/Breakpoints.h"
 #include "Patch.h"
 
+#include <unordered_set>
+
 #if !PCSX2_SEH
 #	include <csetjmp>
 #endif
@@ -574,6 +577,10 @@ static bool eeCpuExecuting = false;
 static bool g_resetEeScalingStats = false;
 static int g_patchesNeedRedo = 0;
 
+// Pages (HWADDR >> 12) recPrecompileCachedBlocks already went through.  A page is walked
+// again once recClear invalidates some of it, or after a reset.
+static std::unordered_set<u32> s_precompiledPages;
+
 ////////////////////////////////////////////////////
 static void recResetRaw()
 {
@@ -591,6 +598,7 @@ static void recResetRaw()
 	recMem->Reset();
 	ClearRecLUT((BASEBLOCK*)recLutReserve_RAM, recLutSize);
 	memset(recRAMCopy, 0, Ps2MemSize::MainRam);
+	s_precompiledPages.clear();
 
 	maxrecmem = 0;
 
@@ -601,6 +609,7 @@ static void recResetRaw()
 
 	recBlocks.Reset();
 	mmap_ResetBlockTracking();
+	vtlb_DynGenFastmemReset();
 
 	x86SetPtr(*recMem);
 
@@ -626,6 +635,8 @@ static void recShutdown()
 	safe_free( s_pInstCache );
 	s_nInstCacheSize = 0;
 
+	eeBlockCache.Close();
+
 	// FIXME Warning thread unsafe
 	Perf::dump();
 }
@@ -771,6 +782,9 @@ void recClear(u32 addr, u32 size)
 		return;
 	addr = HWADDR(addr);
 
+	for (u32 page = addr >> 12; page <= (addr + size * 4 - 4) >> 12; page++)
+		s_precompiledPages.erase(page);
+
 	int blockidx = recBlocks.LastIndex(addr + size * 4 - 4);
 
 	if (blockidx == -1)
@@ -1609,6 +1623,69 @@ void doPlace0Patches()
     ApplyLoadedPatches(PPT_ONCE_ON_LOAD);
 }
 
+static bool s_precompiling = false;
+static std::vector<u32> s_precompileList;
+
+// Compiles the blocks the previous sessions of this game compiled in the page of startpc,
+// so that a new page costs a single stall instead of one per block.  Only blocks whose
+// guest code still matches the cache are compiled, and only ones that need no special
+// handling at compile time (hooks, patches).  Runs from recRecompile, which is the only
+// context where the rec state can be changed safely.
+static void recPrecompileCachedBlocks( u32 startpc )
+{
+	if (!EmuConfig.Cpu.Recompiler.EnableEEBlockCache)
+	{
+		eeBlockCache.Close();
+		return;
+	}
+
+	if (s_precompiling) return;
+
+	// Until the game has started its code is still unpatched: patches are applied when the
+	// entry point gets compiled (doPlace0Patches) and run (eeGameStarting).
+	if (g_GameLoading) return;
+
+	eeBlockCache.Open(ElfCRC);
+	if (!eeBlockCache.IsOpen() || EmuConfig.Gamefixes.GoemonTlbHack) return;
+
+	if (!s_precompiledPages.insert(HWADDR(startpc) >> 12).second) return;
+
+	const std::vector<RecBlockCache::Block>* page = eeBlockCache.GetPage(startpc);
+	if (!page) return;
+
+	// Compiling records blocks into the cache, so work from a copy of the page.
+	s_precompileList.clear();
+	for (const RecBlockCache::Block& block : *page)
+	{
+		const u32 hwpc = HWADDR(block.startpc);
+		if (block.startpc == startpc || hwpc == ElfEntry || hwpc == EELOAD_START
+			|| (g_eeloadMain && hwpc == HWADDR(g_eeloadMain))
+			|| (g_eeloadExec && hwpc == HWADDR(g_eeloadExec)))
+			continue;
+
+		const uptr fnptr = PC_GETBLOCK(block.startpc)->GetFnptr();
+		if (fnptr != (uptr)JITCompile && fnptr != (uptr)JITCompileInBlock)
+			continue;
+
+		if (RecBlockCache::IsValid(block))
+			s_precompileList.push_back(block.startpc);
+	}
+	if (s_precompileList.empty()) return;
+
+	ScopedBool precompiling(s_precompiling);
+
+	for (u32 blockpc : s_precompileList)
+	{
+		// Never trigger a reset from here, the block that brought us here must be compiled
+		// first.  Once the buffers run low the cache simply stops helping until the next reset.
+		if (eeRecNeedsReset || recPtr >= (recMem->GetPtrEnd() - _1mb)
+			|| (recConstBufPtr - recConstBuf) >= RECCONSTBUF_SIZE / 2)
+			break;
+
+		recRecompile(blockpc);
+	}
+}
+
 static void __fastcall recRecompile( const u32 startpc )
 {
 	u32 i = 0;
@@ -1621,6 +1698,8 @@ static void __fastcall recRecompile( const u32 startpc )
 
 	pxAssert( startpc );
 
+	recPrecompileCachedBlocks(startpc);
+
 	// if recPtr reached the mem limit reset whole mem
 	if (recPtr >= (recMem->GetPtrEnd() - _64kb)) {
 		eeRecNeedsReset = true;
@@ -2017,6 +2096,10 @@ StartRecomp:
 	pxAssert( (pc-startpc)>>2 <= 0xffff );
 	s_pCurBlockEx->size = (pc-startpc)>>2;
 
+	// Only game code is worth remembering, the kernel and EELOAD are compiled during boot.
+	if (doRecompilation && s_pCurBlockEx->size && HWADDR(startpc) >= 0x100000 && HWADDR(startpc) < Ps2MemSize::MainRam)
+		eeBlockCache.Record(startpc, s_pCurBlockEx->size, (u32*)PSM(startpc));
+
 	if (HWADDR(pc) <= Ps2MemSize::MainRam) {
 		BASEBLOCKEX *oldBlock;
 		int i;
@@ -23,6 +23,8 @@
 #include "iR5900.h"
 #include "Utilities/Perf.h"
 
+#include <algorithm>
+
 using namespace vtlb_private;
 using namespace x86Emitter;
 
@@ -162,34 +164,34 @@ namespace vtlb_private
 	}
 
 	// ------------------------------------------------------------------------
-	static void DynGen_DirectRead( u32 bits, bool sign )
+	static void DynGen_DirectRead( u32 bits, bool sign, const xAddressVoid& addr )
 	{
 		switch( bits )
 		{
 			case 8:
 				if( sign )
-					xMOVSX( eax, ptr8[ecx] );
+					xMOVSX( eax, ptr8[addr] );
 				else
-					xMOVZX( eax, ptr8[ecx] );
+					xMOVZX( eax, ptr8[addr] );
 			break;
 
 			case 16:
 				if( sign )
-					xMOVSX( eax, ptr16[ecx] );
+					xMOVSX( eax, ptr16[addr] );
 				else
-					xMOVZX( eax, ptr16[ecx] );
+					xMOVZX( eax, ptr16[addr] );
 			break;
 
 			case 32:
-				xMOV( eax, ptr[ecx] );
+				xMOV( eax, ptr[addr] );
 			break;
 
 			case 64:
-				iMOV64_Smart( ptr[edx], ptr[ecx] );
+				iMOV64_Smart( ptr[edx], ptr[addr] );
 			break;
 
 			case 128:
-				iMOV128_SSE( ptr[edx], ptr[ecx] );
+				iMOV128_SSE( ptr[edx], ptr[addr] );
 			break;
 
 			jNO_DEFAULT
@@ -197,29 +199,29 @@ namespace vtlb_private
 	}
 
 	// ------------------------------------------------------------------------
-	static void DynGen_DirectWrite( u32 bits )
+	static void DynGen_DirectWrite( u32 bits, const xAddressVoid& addr )
 	{
 		switch(bits)
 		{
 			//8 , 16, 32 : data on EDX
 			case 8:
-				xMOV( ptr[ecx], dl );
+				xMOV( ptr[addr], dl );
 			break;
 
 			case 16:
-				xMOV( ptr[ecx], dx );
+				xMOV( ptr[addr], dx );
 			break;
 
 			case 32:
-				xMOV( ptr[ecx], edx );
+				xMOV( ptr[addr], edx );
 			break;
 
 			case 64:
-				iMOV64_Smart( ptr[ecx], ptr[edx] );
+				iMOV64_Smart( ptr[addr], ptr[edx] );
 			break;
 
 			case 128:
-				iMOV128_SSE( ptr[ecx], ptr[edx] );
+				iMOV128_SSE( ptr[addr], ptr[edx] );
 			break;
 		}
 	}
@@ -305,6 +307,178 @@ static void DynGen_IndirectTlbDispatcher( int mode, int bits, bool sign )
 	xJMP( ebx );
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+//                            Fastmem
+// ------------------------------------------------------------------------
+// A fastmem access folds the address onto the EE physical space and accesses it directly:
+//
+//   mov ebx,ecx
+//   and ebx,0x1fffffff
+//   mov eax,[ebx+fastmem]
+//
+// Main ram sits at the start of the fastmem window, the rest of the window is reserved but
+// never committed (see eeMemoryReserve).  The first access to anything else than ram
+// faults, and the access site gets patched into a jump to a fallback going through the
+// interpreter's vtlb functions, which the site keeps using from then on.
+//
+// The host process being 32 bits, a window mirroring the whole 4GB of the EE virtual map
+// isn't an option, hence the fold.  It is right as long as the TLB maps ram onto itself,
+// which vtlb.cpp keeps track of (vtlbdata.fastmem_conflicts).
+//
+// Registers match the full vtlb path: ecx is the address, edx the data, eax and ebx are
+// trashed, and the caller did a full vtlb flush.
+
+struct FastmemSite
+{
+	uptr start;
+	uptr cont;		// first instruction after the access
+	u8* fallback;	// NULL once backpatched
+
+	bool operator<( uptr pc ) const { return cont <= pc; }
+};
+
+// Code is only ever appended to the cache between two resets, so the sites are sorted.
+static std::vector<FastmemSite> m_FastmemSites;
+static uint m_FastmemCompiled = 0;
+static uint m_FastmemPatched = 0;
+
+static __pagealigned u8 m_FastmemFallbacks[__pagesize];
+
+// Same layout as the indirect dispatchers.
+static u8* GetFastmemFallbackPtr( int mode, int operandsize, int sign = 0 )
+{
+	const int A = 32;
+
+	return &m_FastmemFallbacks[(mode*(7*A)) + (sign*5*A) + (operandsize*A)];
+}
+
+// ------------------------------------------------------------------------
+// Generates the fallbacks of the backpatched sites.  ebx holds the return address, the
+// arguments are already where the __fastcall vtlb functions want them.
+static void DynGen_FastmemFallback( int mode, int bits, bool sign )
+{
+	static void* const readers[5] =
+	{
+		(void*)vtlb_memRead<mem8_t>, (void*)vtlb_memRead<mem16_t>, (void*)vtlb_memRead<mem32_t>,
+		(void*)vtlb_memRead64, (void*)vtlb_memRead128
+	};
+
+	static void* const writers[5] =
+	{
+		(void*)vtlb_memWrite<mem8_t>, (void*)vtlb_memWrite<mem16_t>, (void*)vtlb_memWrite<mem32_t>,
+		(void*)vtlb_memWrite64, (void*)vtlb_memWrite128
+	};
+
+	xFastCall( mode ? writers[bits] : readers[bits], ecx, edx );
+
+	if (!mode)
+	{
+		if (bits == 0)
+		{
+			if (sign)
+				xMOVSX(eax, al);
+			else
+				xMOVZX(eax, al);
+		}
+		else if (bits == 1)
+		{
+			if (sign)
+				xMOVSX(eax, ax);
+			else
+				xMOVZX(eax, ax);
+		}
+	}
+
+	xJMP( ebx );
+}
+
+static bool DynGen_UseFastmem()
+{
+	return vtlbdata.fastmem && !vtlbdata.fastmem_conflicts
+		&& EmuConfig.Cpu.Recompiler.EnableFastmem && !EmuConfig.Gamefixes.GoemonTlbHack;
+}
+
+// ------------------------------------------------------------------------
+// mode - 0 for read, 1 for write
+static void DynGen_FastmemAccess( int mode, u32 bits, bool sign )
+{
+	EE::Profiler.EmitMem();
+
+	int szidx = 0;
+	switch( bits )
+	{
+		case 8:		szidx=0;	break;
+		case 16:	szidx=1;	break;
+		case 32:	szidx=2;	break;
+		case 64:	szidx=3;	break;
+		case 128:	szidx=4;	break;
+		jNO_DEFAULT;
+	}
+
+	uptr start = (uptr)xGetPtr();
+
+	xMOV( ebx, ecx );
+	xAND( ebx, VTLB_FASTMEM_MASK );
+
+	if( mode )
+		DynGen_DirectWrite( bits, ebx + vtlbdata.fastmem );
+	else
+		DynGen_DirectRead( bits, sign, ebx + vtlbdata.fastmem );
+
+	// The patch (mov ebx,imm32 / jmp rel32) must fit in the site.
+	pxAssume( (uptr)xGetPtr() - start >= 10 );
+
+	pxAssume( m_FastmemSites.empty() || m_FastmemSites.back().cont <= start );
+
+	FastmemSite site = { start, (uptr)xGetPtr(), GetFastmemFallbackPtr( mode, szidx, sign && bits < 32 ) };
+	m_FastmemSites.push_back( site );
+
+	vtlbdata.fastmem_used = true;
+	m_FastmemCompiled++;
+}
+
+// Called from the page fault handler when an access hits the fastmem guard.  Returns false
+// if the faulting instruction isn't a fastmem access.
+//
+// Note: this runs in the signal handler on Linux, no logging here.
+bool vtlb_DynGenFastmemFault( uptr* pc )
+{
+	if( !pc ) return false;
+
+	// First site ending after the faulting instruction
+	std::vector<FastmemSite>::iterator it = std::lower_bound( m_FastmemSites.begin(), m_FastmemSites.end(), *pc );
+	if( it == m_FastmemSites.end() || *pc < it->start || !it->fallback ) return false;
+
+	u8* oldptr = xGetPtr();
+
+	xSetPtr( (void*)it->start );
+	xMOV( ebx, it->cont );
+	xJMP( (void*)it->fallback );
+
+	xSetPtr( oldptr );
+
+	// Resume at the start of the site, ecx and edx are still untouched.
+	*pc = it->start;
+
+	it->fallback = NULL;
+	m_FastmemPatched++;
+
+	return true;
+}
+
+// The code cache is reset, forget about the sites it held.
+void vtlb_DynGenFastmemReset()
+{
+	if( m_FastmemCompiled )
+		eeRecPerfLog.Write( "Fastmem: %u accesses compiled, %u backpatched", m_FastmemCompiled, m_FastmemPatched );
+
+	m_FastmemSites.clear();
+	m_FastmemCompiled = 0;
+	m_FastmemPatched = 0;
+
+	vtlbdata.fastmem_used = false;
+}
+
 // One-time initialization procedure.  Multiple subsequent calls during the lifespan of the
 // process will be ignored.
 //
@@ -336,6 +510,26 @@ void vtlb_dynarec_init()
 	HostSys::MemProtectStatic( m_IndirectDispatchers, PageAccess_ExecOnly() );
 
 	Perf::any.map((uptr)m_IndirectDispatchers, __pagesize, "TLB Dispatcher");
+
+	HostSys::MemProtectStatic( m_FastmemFallbacks, PageAccess_ReadWrite() );
+	memset( m_FastmemFallbacks, 0xcc, __pagesize);
+
+	for( int mode=0; mode<2; ++mode )
+	{
+		for( int bits=0; bits<5; ++bits )
+		{
+			for (int sign = 0; sign < (!mode && bits < 2 ? 2 : 1); sign++)
+			{
+				xSetPtr( GetFastmemFallbackPtr( mode, bits, !!sign ) );
+
+				DynGen_FastmemFallback( mode, bits, !!sign );
+			}
+		}
+	}
+
+	HostSys::MemProtectStatic( m_FastmemFallbacks, PageAccess_ExecOnly() );
+
+	Perf::any.map((uptr)m_FastmemFallbacks, __pagesize, "Fastmem Fallback");
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -344,10 +538,16 @@ void vtlb_DynGenRead64(u32 bits)
 {
 	pxAssume( bits == 64 || bits == 128 );
 
+	if( DynGen_UseFastmem() )
+	{
+		DynGen_FastmemAccess( 0, bits, false );
+		return;
+	}
+
 	uptr* writeback = DynGen_PrepRegs();
 
 	DynGen_IndirectDispatch( 0, bits );
-	DynGen_DirectRead( bits, false );
+	DynGen_DirectRead( bits, false, ecx );
 
 	*writeback = (uptr)xGetPtr();		// return target for indirect's call/ret
 }
@@ -360,10 +560,16 @@ void vtlb_DynGenRead32(u32 bits, bool sign)
 {
 	pxAssume( bits <= 32 );
 
+	if( DynGen_UseFastmem() )
+	{
+		DynGen_FastmemAccess( 0, bits, sign );
+		return;
+	}
+
 	uptr* writeback = DynGen_PrepRegs();
 
 	DynGen_IndirectDispatch( 0, bits, sign && bits < 32 );
-	DynGen_DirectRead( bits, sign );
+	DynGen_DirectRead( bits, sign, ecx );
 
 	*writeback = (uptr)xGetPtr();
 }
@@ -496,10 +702,16 @@ void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const )
 
 void vtlb_DynGenWrite(u32 sz)
 {
+	if( DynGen_UseFastmem() )
+	{
+		DynGen_FastmemAccess( 1, sz, false );
+		return;
+	}
+
 	uptr* writeback = DynGen_PrepRegs();
 
 	DynGen_IndirectDispatch( 1, sz );
-	DynGen_DirectWrite( sz );
+	DynGen_DirectWrite( sz, ecx );
 
 	*writeback = (uptr)xGetPtr();
 }
@@ -97,6 +97,15 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 	mVU.prog.total		=  0;
 	mVU.prog.curFrame	=  0;
 
+	if (mVU.prog.peakStats.searches) {
+		DevCon.WriteLn("microVU%d: Peak program searches per frame = %d (probes = %d, compares = %d, new = %d)",
+					   mVU.index, mVU.prog.peakStats.searches, mVU.prog.peakStats.probes,
+					   mVU.prog.peakStats.compares, mVU.prog.peakStats.created);
+	}
+	memzero(mVU.prog.stats);
+	memzero(mVU.prog.frameStats);
+	memzero(mVU.prog.peakStats);
+
 	// Setup Dynarec Cache Limits for Each Program
 	u8* z = mVU.cache;
 	mVU.prog.x86start	= z;
@@ -106,7 +115,8 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 
 	for(u32 i = 0; i < (mVU.progSize / 2); i++) {
 		if(!mVU.prog.prog[i]) {
-			mVU.prog.prog[i] = new std::deque<microProgram*>();
+			mVU.prog.prog[i]  = new std::deque<microProgram*>();
+			mVU.prog.index[i] = new microProgramIndex();
 			continue;
 		}
 		std::deque<microProgram*>::iterator it(mVU.prog.prog[i]->begin());
@@ -114,6 +124,8 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 			mVUdeleteProg(mVU, it[0]);
 		}
 		mVU.prog.prog[i]->clear();
+		mVU.prog.index[i]->progs.clear();
+		mVU.prog.index[i]->keySizes.clear();
 		mVU.prog.quick[i].block = NULL;
 		mVU.prog.quick[i].prog  = NULL;
 	}
@@ -137,6 +149,7 @@ void mVUclose(microVU& mVU) {
 			mVUdeleteProg(mVU, it[0]);
 		}
 		safe_delete(mVU.prog.prog[i]);
+		safe_delete(mVU.prog.index[i]);
 	}
 }
 
@@ -159,6 +172,15 @@ __fi void mVUclear(mV, u32 addr, u32 size) {
 // Finds and Ages/Kills Programs if they haven't been used in a while.
 __ri void mVUvsyncUpdate(mV) {
 	//mVU.prog.curFrame++;
+
+	microProgStats& s = mVU.prog.stats;
+	microProgStats& p = mVU.prog.peakStats;
+	mVU.prog.frameStats = s;
+	p.searches = std::max(p.searches, s.searches);
+	p.probes   = std::max(p.probes,   s.probes);
+	p.compares = std::max(p.compares, s.compares);
+	p.created  = std::max(p.created,  s.created);
+	memzero(s);
 }
 
 // Deletes a program
@@ -187,6 +209,41 @@ __ri microProgram* mVUcreateProg(microVU& mVU, int startPC) {
 	return prog;
 }
 
+// Hashes 'size' bytes of program code (for program keys)
+static __fi u64 mVUhashCode(const u8* code, u32 size) {
+	u64 hash = 0xcbf29ce484222325ULL;
+	for (u32 i = 0; i < size / 4; i++) {
+		hash ^= ((u32*)code)[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+// Sets the key of a new program, which is the hash of the code it compiled at startPC.
+// That code is part of the program's ranges for good (ranges only ever grow), so any
+// program matching mVU.regs().Micro in mVUcmpPartial() has the same key.
+void mVUsetProgKey(microVU& mVU, microProgram& prog) {
+	const s32 start = prog.startPC * 8;
+	s32 end = start + 8;
+	std::deque<microRange>::const_iterator it(prog.ranges->begin());
+	for ( ; it != prog.ranges->end(); ++it) {
+		if ((it[0].start <= start) && (it[0].end >= start))
+			end = std::max(end, it[0].end + 8);
+	}
+	end = std::min<s32>(end, mVU.microMemSize);
+
+	prog.keySize = std::min<u32>(end - start, mVUprogKeyMax);
+	prog.key     = mVUhashCode((u8*)prog.data + start, prog.keySize);
+}
+
+// Adds a new program to the content-hash index of its startPC
+static __fi void mVUindexProg(microVU& mVU, microProgram& prog) {
+	microProgramIndex& index = *mVU.prog.index[prog.startPC];
+	index.progs.insert(std::make_pair(prog.key, &prog));
+	if (std::find(index.keySizes.begin(), index.keySizes.end(), prog.keySize) == index.keySizes.end())
+		index.keySizes.push_back(prog.keySize);
+}
+
 // Caches Micro Program
 __ri void mVUcacheProg(microVU& mVU, microProgram& prog) {
 	if (!mVU.index)	memcpy(prog.data, mVU.regs().Micro, 0x1000);
@@ -254,14 +311,42 @@ __fi bool mVUcmpProg(microVU& mVU, microProgram& prog, const bool cmpWholeProg)
 	return false;
 }
 
+// Looks up a cached program matching mVU.regs().Micro through the content-hash index
+static __fi microProgram* mVUfindProg(microVU& mVU, u32 startPC) {
+	microProgramIndex& index = *mVU.prog.index[startPC];
+	const u8* code = (u8*)mVU.regs().Micro + startPC * 8;
+	for (u32 size : index.keySizes) {
+		mVU.prog.stats.probes++;
+		auto range = index.progs.equal_range(mVUhashCode(code, size));
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second->keySize != size) continue;
+			mVU.prog.stats.compares++;
+			if (mVUcmpProg(mVU, *it->second, 0))
+				return it->second;
+		}
+	}
+	return NULL;
+}
+
 // Searches for Cached Micro Program and sets prog.cur to it (returns entry-point to program)
 _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 	microVU& mVU = mVUx;
 	microProgramQuick& quick = mVU.prog.quick[startPC/8];
 	microProgramList*  list  = mVU.prog.prog [startPC/8];
 	if(!quick.prog) { // If null, we need to search for new program
-		std::deque<microProgram*>::iterator it(list->begin());
-		for ( ; it != list->end(); ++it) {
+		mVU.prog.stats.searches++;
+
+		// The Ibit gamefixes match programs which differ in their compiled ranges, which a
+		// hash of the code can't do, so they still go through the whole list.
+		if (!EmuConfig.Gamefixes.ScarfaceIbit && !EmuConfig.Gamefixes.CrashTagTeamRacingIbit) {
+			if (microProgram* prog = mVUfindProg(mVU, startPC/8)) {
+				quick.block = prog->block[startPC/8];
+				quick.prog  = prog;
+				return mVUentryGet(mVU, quick.block, startPC, pState);
+			}
+		}
+		else for (std::deque<microProgram*>::iterator it(list->begin()); it != list->end(); ++it) {
+			mVU.prog.stats.compares++;
 			bool b = mVUcmpProg(mVU, *it[0], 0);
 			if (EmuConfig.Gamefixes.ScarfaceIbit) {
 				if (isVU1 && ((((u32*)mVU.regs().Micro)[startPC / 4 + 1]) == 0x80200118) &&
@@ -299,6 +384,9 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState) {
 		quick.block			= mVU.prog.cur->block[startPC/8];
 		quick.prog			= mVU.prog.cur;
 		list->push_front(mVU.prog.cur);
+		mVUsetProgKey(mVU, *mVU.prog.cur);
+		mVUindexProg(mVU, *mVU.prog.cur);
+		mVU.prog.stats.created++;
 		//mVUprintUniqueRatio(mVU);
 		return entryPoint;
 	}
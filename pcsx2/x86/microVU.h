@@ -21,6 +21,8 @@ class AsciiFile;
 using namespace x86Emitter;
 
 #include <deque>
+#include <unordered_map>
+#include <vector>
 #include <algorithm>
 #include <memory>
 #include "Common.h"
@@ -149,10 +151,26 @@ struct microProgram {
 	std::deque<microRange>* ranges;			   // The ranges of the microProgram that have already been recompiled
 	u32 startPC; // Start PC of this program
 	int idx;	 // Program index
+	u32 keySize; // Size (in bytes) of the code at startPC hashed into 'key'
+	u64 key;	 // Hash of the code at startPC (see mVUsetProgKey)
 };
 
 typedef std::deque<microProgram*> microProgramList;
 
+// Index of a microProgramList by content hash, so that finding a cached program is a hash
+// probe followed by a single partial compare, instead of a compare against every program.
+struct microProgramIndex {
+	std::unordered_multimap<u64, microProgram*> progs; // Programs by key
+	std::vector<u32> keySizes; // Distinct key sizes of the programs in 'progs'
+};
+
+struct microProgStats {
+	u32 searches; // Searches for a program (startPC had no quick reference)
+	u32 probes;   // Hash probes into the program index
+	u32 compares; // Programs compared against mVU.regs().Micro
+	u32 created;  // New programs
+};
+
 struct microProgramQuick {
 	microBlockManager*    block; // Quick reference to valid microBlockManager for current startPC
 	microProgram*		  prog;	 // The microProgram who is the owner of 'block'
@@ -161,6 +179,7 @@ struct microProgramQuick {
 struct microProgManager {
 	microIR<mProgSize>	IRinfo;				// IR information
 	microProgramList*	prog [mProgSize/2];	// List of microPrograms indexed by startPC values
+	microProgramIndex*	index[mProgSize/2];	// Content-hash index of the microPrograms in 'prog'
 	microProgramQuick	quick[mProgSize/2];	// Quick reference to valid microPrograms for current execution
 	microProgram*		cur;				// Pointer to currently running MicroProgram
 	int					total;				// Total Number of valid MicroPrograms
@@ -171,8 +190,13 @@ struct microProgManager {
 	u8*					x86start;			// Start of program's rec-cache
 	u8*					x86end;				// Limit of program's rec-cache
 	microRegInfo		lpState;			// Pipeline state from where program left off (useful for continuing execution)
+	microProgStats		stats;				// Program search stats of the current frame
+	microProgStats		frameStats;			// Program search stats of the last frame
+	microProgStats		peakStats;			// Highest per-frame program search stats since reset
 };
 
+static const uint mVUprogKeyMax		= 256;		  // Max size of the code hashed into a program's key (in bytes)
+
 static const uint mVUdispCacheSize	= __pagesize; // Dispatcher Cache Size (in bytes)
 static const uint mVUcacheSafeZone	= 3;		  // Safe-Zone for program recompilation (in megabytes)
 static const uint mVU0cacheReserve	= 64;		  // mVU0 Reserve Cache Size (in megabytes)
@@ -250,6 +274,7 @@ mVUop(mVUopL);
 // Private Functions
 extern void  mVUcacheProg (microVU& mVU, microProgram&  prog);
 extern void  mVUdeleteProg(microVU& mVU, microProgram*& prog);
+extern void  mVUsetProgKey(microVU& mVU, microProgram&  prog);
 _mVUt extern void* mVUsearchProg(u32 startPC, uptr pState);
 extern void* __fastcall mVUexecuteVU0(u32 startPC, u32 cycles);
 extern void* __fastcall mVUexecuteVU1(u32 startPC, u32 cycles);
@@ -29,6 +29,7 @@
 #include "Renderers/OpenGL/GSRendererOGL.h"
 #include "Renderers/OpenCL/GSRendererCL.h"
 #include "GSLzma.h"
+#include "Window/GSWndNull.h"
 
 #ifdef _WIN32
 
@@ -65,6 +66,7 @@ static void (*s_irq)() = NULL;
 static uint8 *s_basemem = NULL;
 static int s_vsync = 0;
 static bool s_exclusive = true;
+static bool s_headless = false; // GSReplayHeadless: no window, no GPU
 static const char *s_renderer_name = "";
 static const char *s_renderer_type = "";
 bool gsopen_done = false; // crash guard for GSgetTitleInfo2 and GSKeyEvent (replace with lock?)
@@ -242,7 +244,9 @@ static int _GSopen(void **dsp, const char *title, GSRendererType renderer, int t
         {
             // Select the window first to detect the GL requirement
             std::vector<std::shared_ptr<GSWnd>> wnds;
-            switch (renderer) {
+            if (s_headless)
+                wnds.push_back(std::make_shared<GSWndNull>());
+            else switch (renderer) {
                 case GSRendererType::OGL_HW:
                 case GSRendererType::OGL_SW:
 #ifdef ENABLE_OPENCL
@@ -344,7 +348,11 @@ static int _GSopen(void **dsp, const char *title, GSRendererType renderer, int t
                 break;
         }
 
-        switch (renderer) {
+        if (s_headless) {
+            dev = new GSDeviceNull();
+            s_renderer_name = " Null";
+            renderer_fullname = "Headless";
+        } else switch (renderer) {
             default:
 #ifdef _WIN32
             case GSRendererType::Vulkan:
@@ -1006,11 +1014,6 @@ EXPORT_C GSReplay(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow)
 
     Console console{"GSdx", true};
 
-    const std::string f{lpszCmdLine};
-    const bool is_xz = f.size() >= 4 && f.compare(f.size() - 3, 3, ".xz") == 0;
-
-    auto file = is_xz ? std::unique_ptr<GSDumpFile>{std::make_unique<GSDumpLzma>(lpszCmdLine, nullptr)} : std::unique_ptr<GSDumpFile>{std::make_unique<GSDumpRaw>(lpszCmdLine, nullptr)};
-
     GSinit();
 
     std::array<uint8, 0x2000> regs;
@@ -1022,107 +1025,63 @@ EXPORT_C GSReplay(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow)
 
     _GSopen((void **)&hWnd, "", renderer);
 
-    uint32 crc;
-    file->Read(&crc, 4);
-    GSsetGameCRC(crc, 0);
+    // Loop forever, the stream stops decoding when it is destroyed
+    GSDumpStream stream(lpszCmdLine, 0);
+
+    GSsetGameCRC(stream.GetCRC(), 0);
 
     {
         GSFreezeData fd;
-        file->Read(&fd.size, 4);
-        std::vector<uint8> freeze_data(fd.size);
-        fd.data = freeze_data.data();
-        file->Read(fd.data, fd.size);
+        fd.size = stream.GetState().size();
+        fd.data = stream.GetState().data();
         GSfreeze(FREEZE_LOAD, &fd);
     }
 
-    file->Read(regs.data(), 0x2000);
+    memcpy(regs.data(), stream.GetRegs(), 0x2000);
 
     GSvsync(1);
 
-    struct Packet
-    {
-        uint8 type, param;
-        uint32 size, addr;
-        std::vector<uint8> buff;
-    };
+    Sleep(100);
 
-    auto read_packet = [&file](uint8 type) {
-        Packet p;
-        p.type = type;
+    std::vector<uint8> buff;
+    GSDumpPacket p;
+    uint32 pass = 0;
+    while (stream.Next(p)) {
+        if (p.pass != pass) {
+            pass = p.pass;
+            if (!IsWindowVisible(hWnd))
+                break;
+        }
 
         switch (p.type) {
             case 0:
-                file->Read(&p.param, 1);
-                file->Read(&p.size, 4);
                 switch (p.param) {
                     case 0:
-                        p.buff.resize(0x4000);
-                        p.addr = 0x4000 - p.size;
-                        file->Read(&p.buff[p.addr], p.size);
+                        GSgifTransfer1(p.buff, p.addr);
                         break;
                     case 1:
+                        GSgifTransfer2(p.buff, p.size / 16);
+                        break;
                     case 2:
+                        GSgifTransfer3(p.buff, p.size / 16);
+                        break;
                     case 3:
-                        p.buff.resize(p.size);
-                        file->Read(p.buff.data(), p.size);
+                        GSgifTransfer(p.buff, p.size / 16);
                         break;
                 }
                 break;
             case 1:
-                file->Read(&p.param, 1);
+                GSvsync(p.param);
                 break;
             case 2:
-                file->Read(&p.size, 4);
+                if (buff.size() < p.size)
+                    buff.resize(p.size);
+                GSreadFIFO2(buff.data(), p.size / 16);
                 break;
             case 3:
-                p.buff.resize(0x2000);
-                file->Read(p.buff.data(), 0x2000);
+                memcpy(regs.data(), p.buff, 0x2000);
                 break;
         }
-
-        return p;
-    };
-
-    std::list<Packet> packets;
-    uint8 type;
-    while (file->Read(&type, 1))
-        packets.push_back(read_packet(type));
-
-    Sleep(100);
-
-    std::vector<uint8> buff;
-    while (IsWindowVisible(hWnd)) {
-        for (auto &p : packets) {
-            switch (p.type) {
-                case 0:
-                    switch (p.param) {
-                        case 0:
-                            GSgifTransfer1(p.buff.data(), p.addr);
-                            break;
-                        case 1:
-                            GSgifTransfer2(p.buff.data(), p.size / 16);
-                            break;
-                        case 2:
-                            GSgifTransfer3(p.buff.data(), p.size / 16);
-                            break;
-                        case 3:
-                            GSgifTransfer(p.buff.data(), p.size / 16);
-                            break;
-                    }
-                    break;
-                case 1:
-                    GSvsync(p.param);
-                    break;
-                case 2:
-                    if (buff.size() < p.size)
-                        buff.resize(p.size);
-                    GSreadFIFO2(p.buff.data(), p.size / 16);
-                    break;
-                case 3:
-                    memcpy(regs.data(), p.buff.data(), 0x2000);
-                    break;
-            }
-        }
     }
 
     Sleep(100);
@@ -1360,14 +1319,6 @@ EXPORT_C GSReplay(char *lpszCmdLine, int renderer)
         return;
     }
 
-    struct Packet
-    {
-        uint8 type, param;
-        uint32 size, addr;
-        std::vector<uint8> buff;
-    };
-
-    std::list<Packet *> packets;
     std::vector<uint8> buff;
     uint8 regs[0x2000];
 
@@ -1376,6 +1327,7 @@ EXPORT_C GSReplay(char *lpszCmdLine, int renderer)
     s_vsync = theApp.GetConfigI("vsync");
     int finished = theApp.GetConfigI("linux_replay");
     bool repack_dump = (finished < 0);
+    int repack_frames = repack_dump ? 1 - finished : 0;
 
     if (theApp.GetConfigI("dump")) {
         fprintf(stderr, "Dump is enabled. Replay will be disabled\n");
@@ -1393,169 +1345,737 @@ EXPORT_C GSReplay(char *lpszCmdLine, int renderer)
     if (s_gs->m_wnd == NULL)
         return;
 
-    { // Read .gs content
-        std::string f(lpszCmdLine);
-        bool is_xz = (f.size() >= 4) && (f.compare(f.size() - 3, 3, ".xz") == 0);
-        if (is_xz)
-            f.replace(f.end() - 6, f.end(), "_repack.gs");
-        else
-            f.replace(f.end() - 3, f.end(), "_repack.gs");
+    std::string f(lpszCmdLine);
+    bool is_xz = (f.size() >= 4) && (f.compare(f.size() - 3, 3, ".xz") == 0);
+    if (is_xz)
+        f.replace(f.end() - 6, f.end(), "_repack.gs");
+    else
+        f.replace(f.end() - 3, f.end(), "_repack.gs");
 
-        GSDumpFile *file = is_xz ? (GSDumpFile *)new GSDumpLzma(lpszCmdLine, repack_dump ? f.c_str() : nullptr) : (GSDumpFile *)new GSDumpRaw(lpszCmdLine, repack_dump ? f.c_str() : nullptr);
+    // Packets are decoded on a worker thread while they are played, the
+    // dump is never fully loaded in memory. 91-199 are infinite loops with a
+    // pause between passes, 200+ loop without pause (profiler mode).
+    int passes = finished > 90 ? 0 : std::max(finished, 1);
 
-        uint32 crc;
-        file->Read(&crc, 4);
-        GSsetGameCRC(crc, 0);
+    std::unique_ptr<GSDumpStream> stream;
 
-        GSFreezeData fd;
-        file->Read(&fd.size, 4);
-        fd.data = new uint8[fd.size];
-        file->Read(fd.data, fd.size);
+    try {
+        stream = std::make_unique<GSDumpStream>(lpszCmdLine, passes, 4 << 20, 8, repack_dump ? f.c_str() : nullptr, repack_frames);
+    } catch (...) {
+        fprintf(stderr, "Error failed to read %s\n", lpszCmdLine);
+        return;
+    }
 
-        GSfreeze(FREEZE_LOAD, &fd);
-        delete[] fd.data;
+    GSsetGameCRC(stream->GetCRC(), 0);
+
+    GSFreezeData fd;
+    fd.size = stream->GetState().size();
+    fd.data = stream->GetState().data();
+    GSfreeze(FREEZE_LOAD, &fd);
+
+    memcpy(regs, stream->GetRegs(), 0x2000);
 
-        file->Read(regs, 0x2000);
+    sleep(2);
 
-        uint8 type;
-        while (file->Read(&type, 1)) {
-            Packet *p = new Packet();
+    // Init vsync stuff
+    GSvsync(1);
 
-            p->type = type;
+    GSDumpPacket p;
+    uint32 pass = 0;
 
-            switch (type) {
-                case 0:
-                    file->Read(&p->param, 1);
-                    file->Read(&p->size, 4);
+    while (stream->Next(p)) {
+        if (finished <= 0)
+            continue; // repack only, just drain the stream
 
-                    switch (p->param) {
-                        case 0:
-                            p->buff.resize(0x4000);
-                            p->addr = 0x4000 - p->size;
-                            file->Read(&p->buff[p->addr], p->size);
-                            break;
-                        case 1:
-                        case 2:
-                        case 3:
-                            p->buff.resize(p->size);
-                            file->Read(&p->buff[0], p->size);
-                            break;
-                    }
+        if (p.pass != pass) {
+            pass = p.pass;
 
-                    break;
+            if (finished > 90 && finished < 200)
+                sleep(1);
+        }
 
-                case 1:
-                    file->Read(&p->param, 1);
-                    frame_number++;
+        switch (p.type) {
+            case 0:
 
-                    break;
+                switch (p.param) {
+                    case 0:
+                        GSgifTransfer1(p.buff, p.addr);
+                        break;
+                    case 1:
+                        GSgifTransfer2(p.buff, p.size / 16);
+                        break;
+                    case 2:
+                        GSgifTransfer3(p.buff, p.size / 16);
+                        break;
+                    case 3:
+                        GSgifTransfer(p.buff, p.size / 16);
+                        break;
+                }
 
-                case 2:
-                    file->Read(&p->size, 4);
+                break;
 
-                    break;
+            case 1:
 
-                case 3:
-                    p->buff.resize(0x2000);
+                GSvsync(p.param);
+                frame_number++;
 
-                    file->Read(&p->buff[0], 0x2000);
+                break;
 
-                    break;
-            }
+            case 2:
+
+                if (buff.size() < p.size)
+                    buff.resize(p.size);
 
-            packets.push_back(p);
+                GSreadFIFO2(&buff[0], p.size / 16);
 
-            if (repack_dump && frame_number > -finished)
                 break;
-        }
 
-        delete file;
+            case 3:
+
+                memcpy(regs, p.buff, 0x2000);
+
+                break;
+        }
     }
 
+    stream.reset();
+
+    static_cast<GSDeviceOGL *>(s_gs->m_dev)->GenerateProfilerData();
+
+#ifdef ENABLE_OGL_DEBUG_MEM_BW
+    unsigned long total_frame_nb = std::max(1l, frame_number) << 10;
+    fprintf(stderr, "memory bandwith. T: %f KB/f. V: %f KB/f. U: %f KB/f\n",
+            (float)g_real_texture_upload_byte / (float)total_frame_nb,
+            (float)g_vertex_upload_byte / (float)total_frame_nb,
+            (float)g_uniform_upload_byte / (float)total_frame_nb);
+#endif
+
     sleep(2);
 
+    GSclose();
+    GSshutdown();
+}
+#endif
 
-    frame_number = 0;
+// Headless replay, meant to track renderer performance on build machines
+// without a display or a GPU. Only the renderers that can run on top of
+// GSDeviceNull are supported (Null and SW).
+//
+// lpszCmdLine: the gs file to load and run.
+// renderer: GSRendererType (Null, OGL_SW or DX1011_SW).
+// passes: number of times the whole dump is played.
+// report: output file, ".csv" gives one row per frame, anything else a json
+//         summary. NULL or "-" writes the json summary to stdout.
+//
+// Returns 0 on success so the loader can forward it as its exit code.
+
+struct GSReplayFrameStat
+{
+    double ms;
+    double counter[GSPerfMon::CounterLast];
+};
+
+static double GSReplayPercentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    size_t rank = (size_t)std::ceil(p / 100 * sorted.size());
+
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+// Instruction set the SW renderer generates code for, so that runs of the
+// SSE2/SSE4/AVX2 builds (and AVX-512VL on/off) can be told apart in reports.
+static const char *GSReplayISA()
+{
+#if _M_SSE >= 0x501
+    return GSUtil::HasAVX512VL() && theApp.GetConfigB("sw_avx512vl") ? "AVX2+AVX-512VL" : "AVX2";
+#else
+    // The SSE builds pick AVX/SSE4.1 code generators at runtime
+    return g_cpu.has(Xbyak::util::Cpu::tAVX) ? "AVX" : g_cpu.has(Xbyak::util::Cpu::tSSE41) ? "SSE4.1" : "SSE2";
+#endif
+}
+
+static std::string GSReplayJsonEscape(const char *s)
+{
+    std::string r;
+
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            r += '\\';
+        r += *s;
+    }
+
+    return r;
+}
+
+EXPORT_C_(int)
+GSReplayHeadless(char *lpszCmdLine, int renderer, int passes, const char *report)
+{
+    GSRendererType type = static_cast<GSRendererType>(renderer);
+
+    switch (type) {
+        case GSRendererType::Null:
+        case GSRendererType::OGL_SW:
+        case GSRendererType::DX1011_SW:
+            break;
+        default:
+            fprintf(stderr, "GSReplayHeadless: renderer %d needs a window, use Null or SW\n", renderer);
+            return -1;
+    }
+
+    passes = std::max(passes, 1);
+
+    if (GSinit() != 0)
+        return -1;
+
+    std::array<uint8, 0x2000> regs;
+    GSsetBaseMem(regs.data());
+
+    s_vsync = 0;
+    s_headless = true;
+
+    void *hWnd = NULL;
+    int err = _GSopen(&hWnd, "", type);
+
+    s_headless = false;
+
+    if (err != 0) {
+        fprintf(stderr, "GSReplayHeadless: failed to GSopen\n");
+        GSshutdown();
+        return -1;
+    }
+
+    std::unique_ptr<GSDumpStream> stream;
+
+    try {
+        stream = std::make_unique<GSDumpStream>(lpszCmdLine, passes);
+    } catch (...) {
+        // GSDumpFile throws on open/decode errors
+        fprintf(stderr, "GSReplayHeadless: failed to read %s\n", lpszCmdLine);
+        GSclose();
+        GSshutdown();
+        return -1;
+    }
+
+    GSsetGameCRC(stream->GetCRC(), 0);
+
+    GSFreezeData fd;
+    fd.size = stream->GetState().size();
+    fd.data = stream->GetState().data();
+    GSfreeze(FREEZE_LOAD, &fd);
+
+    memcpy(regs.data(), stream->GetRegs(), 0x2000);
+
+    const GSPerfMon &pm = s_gs->m_perfmon;
+
+    std::vector<GSReplayFrameStat> frames;
+    std::vector<uint8> buff;
+    GSReplayFrameStat last;
+
+    auto sample = [&pm](GSReplayFrameStat &fs) {
+        for (int i = 0; i < GSPerfMon::CounterLast; i++)
+            fs.counter[i] = pm.GetTotal(static_cast<GSPerfMon::counter_t>(i));
+    };
 
-    // Init vsync stuff
     GSvsync(1);
 
-    while (finished > 0) {
-        for (auto i = packets.begin(); i != packets.end(); i++) {
-            Packet *p = *i;
+    auto start = std::chrono::steady_clock::now();
+    auto frame_start = start;
 
-            switch (p->type) {
-                case 0:
+    sample(last);
 
-                    switch (p->param) {
-                        case 0:
-                            GSgifTransfer1(&p->buff[0], p->addr);
-                            break;
-                        case 1:
-                            GSgifTransfer2(&p->buff[0], p->size / 16);
-                            break;
-                        case 2:
-                            GSgifTransfer3(&p->buff[0], p->size / 16);
-                            break;
-                        case 3:
-                            GSgifTransfer(&p->buff[0], p->size / 16);
-                            break;
-                    }
+    GSDumpPacket p;
 
-                    break;
+    while (stream->Next(p)) {
+        switch (p.type) {
+            case 0:
+                switch (p.param) {
+                    case 0:
+                        GSgifTransfer1(p.buff, p.addr);
+                        break;
+                    case 1:
+                        GSgifTransfer2(p.buff, p.size / 16);
+                        break;
+                    case 2:
+                        GSgifTransfer3(p.buff, p.size / 16);
+                        break;
+                    case 3:
+                        GSgifTransfer(p.buff, p.size / 16);
+                        break;
+                }
+                break;
+            case 1: {
+                GSvsync(p.param);
 
-                case 1:
+                auto now = std::chrono::steady_clock::now();
 
-                    GSvsync(p->param);
-                    frame_number++;
+                GSReplayFrameStat fs;
+                sample(fs);
 
-                    break;
+                for (int i = 0; i < GSPerfMon::CounterLast; i++) {
+                    double cur = fs.counter[i];
+                    fs.counter[i] -= last.counter[i];
+                    last.counter[i] = cur;
+                }
 
-                case 2:
+                fs.ms = std::chrono::duration<double, std::milli>(now - frame_start).count();
+                frames.push_back(fs);
 
-                    if (buff.size() < p->size)
-                        buff.resize(p->size);
+                frame_start = now;
+            } break;
+            case 2:
+                if (buff.size() < p.size)
+                    buff.resize(p.size);
+                GSreadFIFO2(buff.data(), p.size / 16);
+                break;
+            case 3:
+                memcpy(regs.data(), p.buff, 0x2000);
+                break;
+        }
+    }
 
-                    GSreadFIFO2(&buff[0], p->size / 16);
+    double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 
-                    break;
+    const char *isa = GSReplayISA();
 
-                case 3:
+    if (stream->HasError())
+        fprintf(stderr, "GSReplayHeadless: %s is truncated or corrupted\n", lpszCmdLine);
 
-                    memcpy(regs, &p->buff[0], 0x2000);
+    stream.reset();
 
-                    break;
+    GSclose();
+    GSshutdown();
+
+    // report
+
+    std::vector<double> sorted;
+    double sum[GSPerfMon::CounterLast] = {};
+
+    for (auto &fs : frames) {
+        sorted.push_back(fs.ms);
+        for (int i = 0; i < GSPerfMon::CounterLast; i++)
+            sum[i] += fs.counter[i];
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t n = std::max<size_t>(frames.size(), 1);
+    double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+
+    const double pixels_per_sec = sum[GSPerfMon::Fillrate] * 1000.0 / std::max(total_ms, 1.0);
+
+    fprintf(stderr, "%zu frames in %.1f ms (%.2f fps) | min %.3f | p50 %.3f | p95 %.3f | p99 %.3f | max %.3f | %s %.2f Mpixels/s\n",
+            frames.size(), total_ms, frames.size() * 1000.0 / std::max(total_ms, 1.0),
+            sorted.empty() ? 0 : sorted.front(), GSReplayPercentile(sorted, 50), GSReplayPercentile(sorted, 95),
+            GSReplayPercentile(sorted, 99), sorted.empty() ? 0 : sorted.back(), isa, pixels_per_sec / 1000000);
+
+    const bool to_stdout = report == NULL || strcmp(report, "-") == 0;
+    const size_t len = to_stdout ? 0 : strlen(report);
+    const bool csv = len >= 4 && strcmp(report + len - 4, ".csv") == 0;
+
+    FILE *fp = to_stdout ? stdout : fopen(report, "w");
+
+    if (fp == NULL) {
+        fprintf(stderr, "GSReplayHeadless: failed to open %s\n", report);
+        return -1;
+    }
+
+    if (csv) {
+        fprintf(fp, "frame,ms,draw,prim,pixels,swizzle,unswizzle,syncpoint,dedupe,dedupe_bytes\n");
+
+        for (size_t i = 0; i < frames.size(); i++) {
+            const GSReplayFrameStat &fs = frames[i];
+
+            fprintf(fp, "%zu,%.4f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f\n", i, fs.ms,
+                    fs.counter[GSPerfMon::Draw], fs.counter[GSPerfMon::Prim], fs.counter[GSPerfMon::Fillrate],
+                    fs.counter[GSPerfMon::Swizzle], fs.counter[GSPerfMon::Unswizzle], fs.counter[GSPerfMon::SyncPoint],
+                    fs.counter[GSPerfMon::TextureDedupe], fs.counter[GSPerfMon::TextureDedupeBytes]);
+        }
+    } else {
+        fprintf(fp, "{\n");
+        fprintf(fp, "  \"dump\": \"%s\",\n", GSReplayJsonEscape(lpszCmdLine).c_str());
+        fprintf(fp, "  \"renderer\": %d,\n", renderer);
+        fprintf(fp, "  \"isa\": \"%s\",\n", isa);
+        fprintf(fp, "  \"threads\": %d,\n", theApp.GetConfigI("extrathreads"));
+        fprintf(fp, "  \"binning\": %d,\n", theApp.GetConfigI("extrathreads_binning"));
+        fprintf(fp, "  \"passes\": %d,\n", passes);
+        fprintf(fp, "  \"frames\": %zu,\n", frames.size());
+        fprintf(fp, "  \"total_ms\": %.3f,\n", total_ms);
+        fprintf(fp, "  \"pixels_per_sec\": %.0f,\n", pixels_per_sec);
+        fprintf(fp, "  \"frame_ms\": {\"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+                sorted.empty() ? 0 : sorted.front(), mean,
+                GSReplayPercentile(sorted, 50), GSReplayPercentile(sorted, 90),
+                GSReplayPercentile(sorted, 95), GSReplayPercentile(sorted, 99),
+                sorted.empty() ? 0 : sorted.back());
+        fprintf(fp, "  \"total\": {\"draw\": %.0f, \"prim\": %.0f, \"pixels\": %.0f, \"swizzle\": %.0f, \"unswizzle\": %.0f, \"syncpoint\": %.0f, \"dedupe\": %.0f, \"dedupe_bytes\": %.0f},\n",
+                sum[GSPerfMon::Draw], sum[GSPerfMon::Prim], sum[GSPerfMon::Fillrate],
+                sum[GSPerfMon::Swizzle], sum[GSPerfMon::Unswizzle], sum[GSPerfMon::SyncPoint],
+                sum[GSPerfMon::TextureDedupe], sum[GSPerfMon::TextureDedupeBytes]);
+        fprintf(fp, "  \"per_frame\": {\"draw\": %.2f, \"prim\": %.2f, \"pixels\": %.2f, \"swizzle\": %.2f, \"unswizzle\": %.2f, \"syncpoint\": %.2f, \"dedupe\": %.2f, \"dedupe_bytes\": %.2f},\n",
+                sum[GSPerfMon::Draw] / n, sum[GSPerfMon::Prim] / n, sum[GSPerfMon::Fillrate] / n,
+                sum[GSPerfMon::Swizzle] / n, sum[GSPerfMon::Unswizzle] / n, sum[GSPerfMon::SyncPoint] / n,
+                sum[GSPerfMon::TextureDedupe] / n, sum[GSPerfMon::TextureDedupeBytes] / n);
+        // Stall saved: what the prefetched readbacks would have cost at the synchronous rate
+        double sync_ms = sum[GSPerfMon::Readback] > 0 ? sum[GSPerfMon::ReadbackStall] / sum[GSPerfMon::Readback] : 0;
+        fprintf(fp, "  \"readback\": {\"sync\": %.0f, \"sync_ms\": %.3f, \"async\": %.0f, \"async_ms\": %.3f, \"saved_ms\": %.3f}\n",
+                sum[GSPerfMon::Readback], sum[GSPerfMon::ReadbackStall],
+                sum[GSPerfMon::ReadbackAsync], sum[GSPerfMon::ReadbackAsyncStall],
+                std::max(sum[GSPerfMon::ReadbackAsync] * sync_ms - sum[GSPerfMon::ReadbackAsyncStall], 0.0));
+        fprintf(fp, "}\n");
+    }
+
+    if (!to_stdout)
+        fclose(fp);
+
+    return 0;
+}
+
+// Host to local transfer and texture read benchmark, for each format with a block
+// aligned writer. Every format is run single threaded and with the given number of
+// swizzle threads, so that the threshold can be tuned on the target machine.
+//
+// report: json output file, NULL or "-" writes it to stdout.
+//
+// Returns nonzero when the threaded output (local memory after the write, texture after
+// the read) differs from the serial one.
+
+EXPORT_C_(int)
+GSBenchmarkTransfer(int threads, const char *report)
+{
+    if (GSinit() != 0)
+        return -1;
+
+    static const struct
+    {
+        int psm;
+        const char *name;
+    } s_format[] =
+        {
+            {PSM_PSMCT32, "32"},
+            {PSM_PSMCT16, "16"},
+            {PSM_PSMCT16S, "16S"},
+            {PSM_PSMT8, "8"},
+            {PSM_PSMT4, "4"},
+            {PSM_PSMZ32, "32Z"},
+            {PSM_PSMZ16, "16Z"},
+            {PSM_PSMZ16S, "16ZS"},
+        };
+
+    static const int s_size[] = {256, 512, 1024};
+
+    bool to_stdout = report == NULL || strcmp(report, "-") == 0;
+    FILE *fp = to_stdout ? stdout : fopen(report, "w");
+
+    if (fp == NULL) {
+        fprintf(stderr, "GSBenchmarkTransfer: failed to open %s\n", report);
+        GSshutdown();
+        return -1;
+    }
+
+    GSLocalMemory *mem = new GSLocalMemory();
+
+    uint8 *src = (uint8 *)_aligned_malloc(1024 * 1024 * 4, 32);
+    uint8 *dst = (uint8 *)_aligned_malloc(1024 * 1024 * 4, 32);
+
+    // Output of the serial path, the threaded one must match it byte for byte
+    uint8 *ref_vm = (uint8 *)_aligned_malloc(GSLocalMemory::m_vmsize, 32);
+    uint8 *ref_dst = (uint8 *)_aligned_malloc(1024 * 1024 * 4, 32);
+
+    int mismatches = 0;
+
+    for (int i = 0; i < 1024 * 1024 * 4; i++)
+        src[i] = (uint8)i;
+
+    fprintf(fp, "{\n  \"threads\": %d,\n  \"results\": [\n", threads);
+
+    bool first = true;
+
+    for (int w : s_size) {
+        for (const auto &fmt : s_format) {
+            const GSLocalMemory::psm_t &psm = GSLocalMemory::m_psm[fmt.psm];
+
+            // The whole transfer has to fit in the local memory
+            int h = std::min(w, (int)(GSLocalMemory::m_vmsize * 8 / psm.trbpp / w));
+
+            GIFRegBITBLTBUF BITBLTBUF;
+
+            BITBLTBUF.DBP = 0;
+            BITBLTBUF.DBW = w / 64;
+            BITBLTBUF.DPSM = fmt.psm;
+
+            GIFRegTRXPOS TRXPOS;
+
+            TRXPOS.DSAX = 0;
+            TRXPOS.DSAY = 0;
+
+            GIFRegTRXREG TRXREG;
+
+            TRXREG.RRW = w;
+            TRXREG.RRH = h;
+
+            GIFRegTEXA TEXA;
+
+            TEXA.TA0 = 0;
+            TEXA.TA1 = 0x80;
+            TEXA.AEM = 0;
+
+            const GSOffset *off = mem->GetOffset(0, w / 64, fmt.psm);
+
+            int len = w * h * psm.trbpp / 8;
+            int n = std::max(16, (64 << 20) / len);
+
+            double ms[2][2];
+
+            for (int mt = 0; mt < 2; mt++) {
+                // threshold 0: always split, the point is to compare both paths at every size
+                mem->SetSwizzleThreads(mt ? threads : 0, 0);
+
+                memset(mem->m_vm8, 0, GSLocalMemory::m_vmsize);
+                memset(dst, 0, w * h * 4);
+
+                auto start = std::chrono::steady_clock::now();
+
+                for (int j = 0; j < n; j++) {
+                    int x = 0;
+                    int y = 0;
+
+                    (mem->*psm.wi)(x, y, src, len, BITBLTBUF, TRXPOS, TRXREG);
+                }
+
+                auto mid = std::chrono::steady_clock::now();
+
+                for (int j = 0; j < n; j++)
+                    mem->ReadTextureParallel(psm.rtx, off, GSVector4i(0, 0, w, h), dst, w * 4, TEXA);
+
+                auto end = std::chrono::steady_clock::now();
+
+                ms[mt][0] = std::chrono::duration<double, std::milli>(mid - start).count() / n;
+                ms[mt][1] = std::chrono::duration<double, std::milli>(end - mid).count() / n;
+
+                if (mt == 0) {
+                    memcpy(ref_vm, mem->m_vm8, GSLocalMemory::m_vmsize);
+                    memcpy(ref_dst, dst, w * h * 4);
+                } else {
+                    if (memcmp(ref_vm, mem->m_vm8, GSLocalMemory::m_vmsize) != 0) {
+                        fprintf(stderr, "GSBenchmarkTransfer: %s %dx%d threaded write differs from the serial one\n", fmt.name, w, h);
+                        mismatches++;
+                    }
+
+                    if (memcmp(ref_dst, dst, w * h * 4) != 0) {
+                        fprintf(stderr, "GSBenchmarkTransfer: %s %dx%d threaded read differs from the serial one\n", fmt.name, w, h);
+                        mismatches++;
+                    }
+                }
             }
+
+            fprintf(fp, "%s    {\"psm\": \"%s\", \"w\": %d, \"h\": %d, \"bytes\": %d,"
+                        " \"write_ms\": %.4f, \"write_mt_ms\": %.4f, \"read_ms\": %.4f, \"read_mt_ms\": %.4f}",
+                    first ? "" : ",\n", fmt.name, w, h, len, ms[0][0], ms[1][0], ms[0][1], ms[1][1]);
+
+            first = false;
         }
+    }
 
-        if (finished >= 200) {
-            ; // Nop for Nvidia Profiler
-        } else if (finished > 90) {
-            sleep(1);
-        } else {
-            finished--;
+    fprintf(fp, "\n  ]\n}\n");
+
+    if (!to_stdout)
+        fclose(fp);
+
+    _aligned_free(src);
+    _aligned_free(dst);
+    _aligned_free(ref_vm);
+    _aligned_free(ref_dst);
+
+    delete mem;
+
+    GSshutdown();
+
+    return mismatches ? -1 : 0;
+}
+
+// Checks of the pieces which can be tested without a window or a GPU.
+// Returns the number of failures.
+
+static int GSSelfTestReadbackRing()
+{
+    using ReadbackPool::Ring;
+
+    int failures = 0;
+
+    // Exact segment divisors (512x512 RGBA8 readbacks), a whole segment, and mixed sizes
+    const uint32 s_pattern[] = {1024 * 1024, Ring::m_seg_size, 0};
+
+    for (uint32 pattern : s_pattern) {
+        Ring ring;
+        ring.Reset();
+
+        struct Readback
+        {
+            uptr offset;
+            uint32 size;
+            uint32 generation;
+        };
+
+        std::vector<Readback> rb;
+
+        // A few laps of the ring
+        while (rb.size() < 200) {
+            uint32 size = pattern ? pattern : ((uint32)rb.size() * 2654435761u % Ring::m_seg_size + 64) & ~63;
+
+            Readback r;
+            r.size = size;
+            r.offset = ring.Alloc(size, r.generation);
+
+            if (r.offset % Ring::m_seg_size + size > Ring::m_seg_size || r.offset + size > Ring::m_pbo_size) {
+                fprintf(stderr, "GSSelfTest: readback %zu (%u bytes) at 0x%zx crosses a segment or the end of the ring\n", rb.size(), size, (size_t)r.offset);
+                failures++;
+            }
+
+            if (!ring.IsValid(r.offset, r.generation)) {
+                fprintf(stderr, "GSSelfTest: readback %zu is invalid right after its allocation\n", rb.size());
+                failures++;
+            }
+
+            // Everything this one overwrites must be invalid from now on, the rest must stay valid
+            for (size_t i = 0; i < rb.size(); i++) {
+                Readback &o = rb[i];
+
+                if (o.size == 0)
+                    continue;
+
+                const bool overwritten = o.offset < r.offset + size && r.offset < o.offset + o.size;
+                const bool valid = ring.IsValid(o.offset, o.generation);
+
+                if (overwritten && valid) {
+                    fprintf(stderr, "GSSelfTest: readback %zu is still valid after readback %zu overwrote it\n", i, rb.size());
+                    failures++;
+                }
+
+                if (overwritten || !valid)
+                    o.size = 0; // gone, don't check it again
+            }
+
+            rb.push_back(r);
         }
     }
 
-    static_cast<GSDeviceOGL *>(s_gs->m_dev)->GenerateProfilerData();
+    return failures;
+}
 
-#ifdef ENABLE_OGL_DEBUG_MEM_BW
-    unsigned long total_frame_nb = std::max(1l, frame_number) << 10;
-    fprintf(stderr, "memory bandwith. T: %f KB/f. V: %f KB/f. U: %f KB/f\n",
-            (float)g_real_texture_upload_byte / (float)total_frame_nb,
-            (float)g_vertex_upload_byte / (float)total_frame_nb,
-            (float)g_uniform_upload_byte / (float)total_frame_nb);
-#endif
+// Sources sharing a deduplicated texture: the texture belongs to the hashed texture
+// cache, dropping it from a source (OI_FFXII, destruction) must only unreference it,
+// never recycle it while other sources still draw with it.
+static int GSSelfTestHashedTexture()
+{
+    typedef GSTextureCache::Source Source;
+    typedef GSTextureCache::HashedTexture HashedTexture;
+
+    int failures = 0;
 
-    for (auto i = packets.begin(); i != packets.end(); i++) {
-        delete *i;
+    if (GSinit() != 0)
+        return 1;
+
+    std::array<uint8, 0x2000> regs;
+    GSsetBaseMem(regs.data());
+
+    s_headless = true;
+
+    void *hWnd = NULL;
+    int err = _GSopen(&hWnd, "", GSRendererType::Null);
+
+    s_headless = false;
+
+    if (err != 0) {
+        fprintf(stderr, "GSSelfTest: failed to GSopen\n");
+        GSshutdown();
+        return 1;
     }
 
-    packets.clear();
+    GSDevice *dev = s_gs->m_dev;
 
-    sleep(2);
+    GIFRegTEX0 TEX0;
+    GIFRegTEXA TEXA;
+    TEX0.u64 = 0;
+    TEXA.u64 = 0;
+
+    auto check = [&failures](bool cond, const char *what) {
+        if (!cond) {
+            fprintf(stderr, "GSSelfTest: hashed texture: %s\n", what);
+            failures++;
+        }
+    };
+
+    // As DedupeSource: the first source registers its texture, the next ones share it
+    Source *a = new Source(s_gs, TEX0, TEXA, NULL, true);
+    Source *b = new Source(s_gs, TEX0, TEXA, NULL, true);
+    Source *c = new Source(s_gs, TEX0, TEXA, NULL, true);
+
+    a->m_texture = dev->CreateTexture(64, 64);
+    b->m_texture = dev->CreateTexture(64, 64);
+    c->m_texture = dev->CreateTexture(64, 64);
+
+    HashedTexture e = {a->m_texture, 0, 0};
+
+    a->Share(&e);
+
+    b->ReleaseTexture();
+    b->Share(&e);
+
+    c->ReleaseTexture();
+    c->Share(&e);
+
+    check(e.refs == 3, "wrong reference count after sharing");
+    check(a->m_texture == e.texture && b->m_texture == e.texture && c->m_texture == e.texture, "source doesn't use the shared texture");
+
+    // As OI_FFXII: the source gets a texture of its own
+    b->ReleaseTexture();
+    b->m_texture = dev->CreateTexture(64, 64);
+
+    check(e.refs == 2, "wrong reference count after a release");
+    check(b->m_hashed == NULL && !b->m_shared_texture, "released source still refers to the hashed texture");
+    check(b->m_texture != e.texture, "shared texture was recycled by a release");
+
+    delete b;
+    delete c;
+
+    check(e.refs == 1, "wrong reference count after deleting sources");
+
+    // Anything recycled so far comes back from the pool, the shared texture must not
+    std::vector<GSTexture *> fetched;
+
+    for (int i = 0; i < 8; i++) {
+        fetched.push_back(dev->CreateTexture(64, 64));
+
+        check(fetched.back() != e.texture, "shared texture was recycled while referenced");
+    }
+
+    delete a;
+
+    check(e.refs == 0, "wrong reference count after deleting the last source");
+
+    // The texture cache owns it, as in IncAge/RemoveAll
+    dev->Recycle(e.texture);
+
+    for (auto t : fetched)
+        dev->Recycle(t);
 
     GSclose();
     GSshutdown();
+
+    return failures;
+}
+
+EXPORT_C_(int)
+GSSelfTest()
+{
+    int failures = 0;
+
+    failures += GSSelfTestReadbackRing();
+    failures += GSSelfTestHashedTexture();
+
+    fprintf(stderr, "GSSelfTest: %s (%d failures)\n", failures ? "FAILED" : "passed", failures);
+
+    return failures ? -1 : 0;
 }
-#endif
@@ -396,6 +396,7 @@ GSCapture::GSCapture()
 	m_threads = theApp.GetConfigI("capture_threads");
 #if defined(__unix__)
 	m_compression_level = theApp.GetConfigI("png_compression_level");
+	m_format = theApp.GetConfigI("capture_format");
 #endif
 }
 
@@ -498,8 +499,22 @@ bool GSCapture::BeginCapture(float fps, GSVector2i recommendedResolution, float
 	m_size.x = theApp.GetConfigI("CaptureWidth");
 	m_size.y = theApp.GetConfigI("CaptureHeight");
 
-	for(int i = 0; i < m_threads; i++) {
-		m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+	if(m_format == 1)
+	{
+		// 4:2:0 and the SIMD conversion need the size to be a multiple of 8. Round it down,
+		// the frames are scaled to m_size (GetSize) so they cover the whole Y4M frame.
+		m_size.x = std::max(m_size.x & ~7, 8);
+		m_size.y = std::max(m_size.y & ~7, 8);
+
+		// A few frames of slack for the writer, past that frames get dropped
+		if(!m_y4m.Open(m_out_dir + "/capture.y4m", m_size, fps, aspect, 8))
+			return false;
+	}
+	else
+	{
+		for(int i = 0; i < m_threads; i++) {
+			m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+		}
 	}
 #endif
 
@@ -530,6 +545,14 @@ bool GSCapture::DeliverFrame(const void* bits, int pitch, bool rgba)
 
 #elif defined(__unix__)
 
+	if(m_format == 1)
+	{
+		m_y4m.Push(static_cast<const uint8*>(bits), pitch, rgba);
+		m_frame++;
+
+		return true;
+	}
+
 	std::string out_file = m_out_dir + format("/frame.%010d.png", m_frame);
 	//GSPng::Save(GSPng::RGB_PNG, out_file, (uint8*)bits, m_size.x, m_size.y, pitch, m_compression_level);
 	m_workers[m_frame%m_threads]->Push(std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, out_file, static_cast<const uint8*>(bits), m_size.x, m_size.y, pitch, m_compression_level));
@@ -563,6 +586,7 @@ bool GSCapture::EndCapture()
 
 #elif defined(__unix__)
 	m_workers.clear();
+	m_y4m.Close();
 
 	m_frame = 0;
 
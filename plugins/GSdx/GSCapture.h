@@ -23,6 +23,7 @@
 
 #include "GSVector.h"
 #include "GSPng.h"
+#include "GSY4M.h"
 
 #ifdef _WIN32
 #include "Window/GSCaptureDlg.h"
@@ -46,6 +47,8 @@ class GSCapture
 
 	std::vector<std::unique_ptr<GSPng::Worker>> m_workers;
 	int m_compression_level;
+	int m_format;
+	GSY4MWriter m_y4m;
 
 	#endif
 
@@ -484,10 +484,24 @@ GSLocalMemory::GSLocalMemory()
 	m_psm[PSM_PSMZ24].depth  = 1;
 	m_psm[PSM_PSMZ16].depth  = 1;
 	m_psm[PSM_PSMZ16S].depth = 1;
+
+	for(auto& page : m_page_version)
+	{
+		for(auto& version : page)
+		{
+			version = 0;
+		}
+	}
+
+	m_version = 0;
+
+	SetSwizzleThreads(theApp.GetConfigI("swizzle_threads"), theApp.GetConfigI("swizzle_threshold"));
 }
 
 GSLocalMemory::~GSLocalMemory()
 {
+	SetSwizzleThreads(0, 0);
+
 	if (m_use_fifo_alloc)
 		fifo_free(m_vm8, m_vmsize, 4);
 	else
@@ -503,6 +517,103 @@ GSLocalMemory::~GSLocalMemory()
 	}
 }
 
+void GSLocalMemory::SetSwizzleThreads(int threads, int threshold)
+{
+	for(auto worker : m_swizzle_workers)
+	{
+		delete worker;
+	}
+
+	m_swizzle_workers.clear();
+
+	for(int i = 0; i < threads; i++)
+	{
+		m_swizzle_workers.push_back(new GSJobQueue<SwizzleJob, 4>([](SwizzleJob& job) {(*job.func)(job.top, job.bottom);}));
+	}
+
+	m_swizzle_threshold = threshold;
+}
+
+// Splits [top, bottom) into one band per thread, inner edges are aligned to step (a page height).
+// The caller processes the first band itself and returns when every band is done.
+
+void GSLocalMemory::ParallelRows(int top, int bottom, int step, const std::function<void(int, int)>& func)
+{
+	int n = (int)m_swizzle_workers.size() + 1;
+	int bands = 0;
+	int first = bottom;
+
+	for(int i = 1, y = top; i <= n; i++)
+	{
+		int next = i < n ? std::max(y, (top + (bottom - top) * i / n) & ~(step - 1)) : bottom;
+
+		if(next == y) continue;
+
+		if(bands == 0)
+		{
+			first = next;
+		}
+		else
+		{
+			SwizzleJob job = {&func, y, next};
+
+			m_swizzle_workers[bands - 1]->Push(job);
+		}
+
+		bands++;
+		y = next;
+	}
+
+	func(top, first);
+
+	for(int i = 0; i < bands - 1; i++)
+	{
+		m_swizzle_workers[i]->Wait();
+	}
+}
+
+void GSLocalMemory::ReadTextureParallel(readTexture rtx, const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	if(!UseSwizzleThreads(r.width() * r.height() * 4))
+	{
+		(this->*rtx)(off, r, dst, dstpitch, TEXA);
+
+		return;
+	}
+
+	ParallelRows(r.top, r.bottom, m_psm[off->psm].pgs.y, [&](int top, int bottom)
+	{
+		(this->*rtx)(off, GSVector4i(r.left, top, r.right, bottom), dst + (top - r.top) * dstpitch, dstpitch, TEXA);
+	});
+}
+
+void GSLocalMemory::InvalidatePages(const uint32* pages, uint32 psm)
+{
+	uint32 mask = PageVersionMask(psm);
+
+	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
+	{
+		for(int i = 0; i < 3; i++)
+		{
+			if(mask & (1 << i))
+			{
+				m_page_version[*p][i].fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	m_version.fetch_add(1, std::memory_order_release);
+}
+
+void GSLocalMemory::InvalidatePages(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r)
+{
+	GSOffset* off = GetOffset(BITBLTBUF.DBP, BITBLTBUF.DBW, BITBLTBUF.DPSM);
+
+	off->GetPages(r, m_tmp_pages);
+
+	InvalidatePages(m_tmp_pages, off->psm);
+}
+
 GSOffset* GSLocalMemory::GetOffset(uint32 bp, uint32 bw, uint32 psm)
 {
 	uint32 hash = bp | (bw << 14) | (psm << 20);
@@ -1028,17 +1139,41 @@ void GSLocalMemory::WriteImage(int& tx, int& ty, const uint8* src, int len, GIFR
 				{
 					size_t addr = (size_t)&s[la * trbpp >> 3];
 
+					void (GSLocalMemory::*wib)(int l, int r, int y, int h, const uint8* src, int srcpitch, const GIFRegBITBLTBUF& BITBLTBUF);
+
 					if((addr & 31) == 0 && (srcpitch & 31) == 0)
 					{
-						WriteImageBlock<psm, bsx, bsy, 32>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+						wib = &GSLocalMemory::WriteImageBlock<psm, bsx, bsy, 32>;
 					}
 					else if((addr & 15) == 0 && (srcpitch & 15) == 0)
 					{
-						WriteImageBlock<psm, bsx, bsy, 16>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+						wib = &GSLocalMemory::WriteImageBlock<psm, bsx, bsy, 16>;
+					}
+					else
+					{
+						wib = &GSLocalMemory::WriteImageBlock<psm, bsx, bsy, 0>;
+					}
+
+					// Blocks can only be written in any order when none of them alias: the rows must not
+					// spill into the next page row, nor wrap around the end of the memory
+
+					const GSVector2i& pgs = m_psm[psm].pgs;
+
+					uint32 bw = BITBLTBUF.DBW;
+					uint32 end = BITBLTBUF.DBP + ((ty + h2 + pgs.y - 1) / pgs.y) * bw * 32;
+
+					if(UseSwizzleThreads(srcpitch * h2) && bw > 0 && ra <= (int)bw * pgs.x && end <= MAX_BLOCKS)
+					{
+						const int y = ty;
+
+						ParallelRows(ty, ty + h2, pgs.y, [&](int top, int bottom)
+						{
+							(this->*wib)(la, ra, top, bottom - top, s + (top - y) * srcpitch, srcpitch, BITBLTBUF);
+						});
 					}
 					else
 					{
-						WriteImageBlock<psm, bsx, bsy, 0>(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
+						(this->*wib)(la, ra, ty, h2, s, srcpitch, BITBLTBUF);
 					}
 
 					s += srcpitch * h2;
@@ -26,6 +26,7 @@
 #include "GSVector.h"
 #include "GSBlock.h"
 #include "GSClut.h"
+#include "GSThread_CXX11.h"
 
 class GSOffset : public GSAlignedClass<32>
 {
@@ -178,10 +179,75 @@ protected:
 	std::unordered_map<uint32, GSPixelOffset4*> m_po4map;
 	std::unordered_map<uint64, std::vector<GSVector2i>*> m_p2tmap;
 
+	// Large transfers are split in bands of rows, swizzled by these threads and the caller
+
+	struct SwizzleJob
+	{
+		const std::function<void(int, int)>* func;
+		int top, bottom;
+	};
+
+	std::vector<GSJobQueue<SwizzleJob, 4>*> m_swizzle_workers;
+	int m_swizzle_threshold;
+
+	// Write versions of each page, texture caches compare them with the versions their data
+	// was read at instead of being notified of every write. Pages hold 3 versions, for the
+	// bits 0-23, 24-27 and 28-31 of 32 bits pixels, so that 24 bits formats and 8H/4HL/4HH
+	// can share a page like with GSUtil::HasSharedBits.
+
+	std::atomic<uint32> m_page_version[MAX_PAGES][3];
+	std::atomic<uint32> m_version;
+	uint32 m_tmp_pages[MAX_PAGES + 1];
+
+	static uint32 PageVersionMask(uint32 psm)
+	{
+		switch(psm)
+		{
+			case PSM_PSMCT24:
+			case PSM_PSMZ24: return 1;
+			case PSM_PSMT4HL: return 2;
+			case PSM_PSMT4HH: return 4;
+			case PSM_PSMT8H: return 6;
+			default: return 7;
+		}
+	}
+
+	void ParallelRows(int top, int bottom, int step, const std::function<void(int, int)>& func);
+
 public:
 	GSLocalMemory();
 	virtual ~GSLocalMemory();
 
+	void SetSwizzleThreads(int threads, int threshold);
+	bool UseSwizzleThreads(int bytes) const {return !m_swizzle_workers.empty() && bytes >= m_swizzle_threshold;}
+
+	// Same as (this->*rtx)(off, r, dst, dstpitch, TEXA), on several threads when r is big enough
+	void ReadTextureParallel(readTexture rtx, const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA);
+
+	// Bumps the versions of the pages written with psm
+	void InvalidatePages(const uint32* pages, uint32 psm);
+	void InvalidatePages(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
+
+	// Changes after any write, nothing has to be checked as long as it stays the same
+	uint32 GetVersion() const {return m_version.load(std::memory_order_relaxed);}
+
+	// Version of the bits of the page that a texture of format psm reads
+	uint32 GetPageVersion(uint32 page, uint32 psm) const
+	{
+		uint32 mask = PageVersionMask(psm);
+		uint32 version = 0;
+
+		for(int i = 0; i < 3; i++)
+		{
+			if(mask & (1 << i))
+			{
+				version += m_page_version[page][i].load(std::memory_order_relaxed);
+			}
+		}
+
+		return version;
+	}
+
 	GSOffset* GetOffset(uint32 bp, uint32 bw, uint32 psm);
 	GSPixelOffset* GetPixelOffset(const GIFRegFRAME& FRAME, const GIFRegZBUF& ZBUF);
 	GSPixelOffset4* GetPixelOffset4(const GIFRegFRAME& FRAME, const GIFRegZBUF& ZBUF);
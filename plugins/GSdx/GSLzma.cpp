@@ -176,3 +176,247 @@ bool GSDumpRaw::Read(void* ptr, size_t size) {
 
 	return false;
 }
+
+/******************************************************************/
+
+GSDumpStream::GSDumpStream(const char* filename, int passes, size_t chunk_size, int chunk_count, const char* repack_filename, int frame_limit)
+	: m_filename(filename)
+	, m_passes(passes)
+	, m_frame_limit(frame_limit)
+	, m_crc(0)
+	, m_exit(false)
+	, m_eof(false)
+	, m_error(false)
+	, m_cur(nullptr)
+	, m_cur_index(0)
+{
+	// The header is needed to start the renderer, read it synchronously.
+	m_file.reset(OpenFile(m_filename, repack_filename));
+	ReadHeader(m_file.get());
+
+	m_chunks.resize(std::max(chunk_count, 2));
+
+	for (auto& c : m_chunks) {
+		c.capacity = chunk_size;
+		c.data     = (uint8*)_aligned_malloc(c.capacity, 32);
+		c.used     = 0;
+		c.pass     = 0;
+
+		m_free.push_back(&c);
+	}
+
+	m_thread = std::thread(&GSDumpStream::ThreadProc, this);
+}
+
+GSDumpStream::~GSDumpStream()
+{
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+		m_exit = true;
+	}
+	m_cv.notify_all();
+
+	m_thread.join();
+
+	for (auto& c : m_chunks)
+		_aligned_free(c.data);
+}
+
+GSDumpFile* GSDumpStream::OpenFile(const std::string& filename, const char* repack_filename)
+{
+	const bool is_xz = filename.size() >= 4 && filename.compare(filename.size() - 3, 3, ".xz") == 0;
+	char* f = const_cast<char*>(filename.c_str());
+
+	if (is_xz)
+		return new GSDumpLzma(f, repack_filename);
+	else
+		return new GSDumpRaw(f, repack_filename);
+}
+
+void GSDumpStream::ReadHeader(GSDumpFile* file)
+{
+	uint32 size = 0;
+
+	file->Read(&m_crc, 4);
+	file->Read(&size, 4);
+	m_state.resize(size);
+	file->Read(m_state.data(), size);
+	file->Read(m_regs.data(), m_regs.size());
+}
+
+uint8* GSDumpStream::Alloc(Chunk*& c, uint32 size)
+{
+	const size_t aligned = (size + 31) & ~31;
+
+	if (c->used + aligned > c->capacity) {
+		if (!c->packets.empty()) {
+			c = Publish(c);
+
+			if (c == nullptr)
+				return nullptr;
+		}
+
+		if (aligned > c->capacity) {
+			// Big transfer (fmv/full frame upload), grow this chunk only
+			_aligned_free(c->data);
+			c->capacity = aligned;
+			c->data     = (uint8*)_aligned_malloc(c->capacity, 32);
+		}
+	}
+
+	uint8* ptr = c->data + c->used;
+	c->used += aligned;
+
+	return ptr;
+}
+
+GSDumpStream::Chunk* GSDumpStream::Publish(Chunk* c)
+{
+	std::unique_lock<std::mutex> l(m_lock);
+
+	uint32 pass = c->pass;
+
+	m_ready.push_back(c);
+	m_cv.notify_all();
+
+	while (m_free.empty() && !m_exit)
+		m_cv.wait(l);
+
+	if (m_exit)
+		return nullptr;
+
+	c = m_free.front();
+	m_free.pop_front();
+
+	c->used = 0;
+	c->pass = pass;
+	c->packets.clear();
+
+	return c;
+}
+
+void GSDumpStream::ThreadProc()
+{
+	Chunk* c;
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+		c = m_free.front();
+		m_free.pop_front();
+	}
+
+	int frames = 0;
+
+	try {
+		for (uint32 pass = 0; m_passes <= 0 || pass < (uint32)m_passes; pass++) {
+			if (pass > 0) {
+				m_file.reset(OpenFile(m_filename, nullptr));
+				ReadHeader(m_file.get());
+
+				// Never mix two passes in a chunk, the player uses it to detect the loop
+				if (!c->packets.empty() && (c = Publish(c)) == nullptr)
+					return;
+			}
+
+			c->pass = pass;
+
+			GSDumpFile* file = m_file.get();
+			uint8 type;
+
+			while (file->Read(&type, 1)) {
+				GSDumpPacket p = {};
+
+				p.type = type;
+				p.pass = pass;
+
+				switch (p.type) {
+					case 0:
+						file->Read(&p.param, 1);
+						file->Read(&p.size, 4);
+
+						switch (p.param) {
+							case 0:
+								// Path1 wraps around the 16KB of VU1 memory, keep the data at the end
+								if ((p.buff = Alloc(c, 0x4000)) == nullptr)
+									return;
+								p.addr = 0x4000 - p.size;
+								file->Read(&p.buff[p.addr], p.size);
+								break;
+							case 1:
+							case 2:
+							case 3:
+								if ((p.buff = Alloc(c, p.size)) == nullptr)
+									return;
+								file->Read(p.buff, p.size);
+								break;
+						}
+						break;
+
+					case 1:
+						file->Read(&p.param, 1);
+						frames++;
+						break;
+
+					case 2:
+						file->Read(&p.size, 4);
+						break;
+
+					case 3:
+						if ((p.buff = Alloc(c, 0x2000)) == nullptr)
+							return;
+						file->Read(p.buff, 0x2000);
+						break;
+				}
+
+				c->packets.push_back(p);
+
+				if (m_frame_limit > 0 && frames >= m_frame_limit)
+					break;
+			}
+
+			if (m_frame_limit > 0 && frames >= m_frame_limit)
+				break;
+		}
+	} catch (...) {
+		// GSDumpFile throws on read/decode errors, end the stream there
+		std::lock_guard<std::mutex> l(m_lock);
+		m_error = true;
+	}
+
+	m_file.reset();
+
+	std::lock_guard<std::mutex> l(m_lock);
+	if (!c->packets.empty())
+		m_ready.push_back(c);
+	else
+		m_free.push_back(c);
+	m_eof = true;
+	m_cv.notify_all();
+}
+
+bool GSDumpStream::Next(GSDumpPacket& p)
+{
+	while (m_cur == nullptr || m_cur_index >= m_cur->packets.size()) {
+		std::unique_lock<std::mutex> l(m_lock);
+
+		if (m_cur) {
+			m_free.push_back(m_cur);
+			m_cur = nullptr;
+			m_cv.notify_all();
+		}
+
+		while (m_ready.empty() && !m_eof)
+			m_cv.wait(l);
+
+		if (m_ready.empty())
+			return false;
+
+		m_cur = m_ready.front();
+		m_cur_index = 0;
+		m_ready.pop_front();
+	}
+
+	p = m_cur->packets[m_cur_index++];
+
+	return true;
+}
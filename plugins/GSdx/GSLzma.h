@@ -75,3 +75,73 @@ class GSDumpRaw : public GSDumpFile {
 	bool IsEof() final;
 	bool Read(void* ptr, size_t size) final;
 };
+
+/******************************************************************/
+
+struct GSDumpPacket
+{
+	uint8 type, param;
+	uint32 size, addr;
+	uint32 pass;
+	uint8* buff; // points inside a GSDumpStream chunk
+};
+
+// Decodes the packets of a dump on a background thread while the renderer
+// consumes them, so playback starts as soon as the header is read.
+//
+// Packets are stored in a fixed set of arena chunks that are recycled once
+// the player moved past them: peak memory is chunk_count * chunk_size (plus
+// the odd oversized transfer) whatever the size of the dump.
+class GSDumpStream {
+
+	struct Chunk {
+		uint8* data;
+		size_t capacity;
+		size_t used;
+		uint32 pass;
+		std::vector<GSDumpPacket> packets;
+	};
+
+	std::unique_ptr<GSDumpFile> m_file;
+	std::string m_filename;
+	int m_passes;
+	int m_frame_limit;
+
+	uint32 m_crc;
+	std::vector<uint8> m_state;
+	std::array<uint8, 0x2000> m_regs;
+
+	std::vector<Chunk> m_chunks;
+	std::deque<Chunk*> m_free;
+	std::deque<Chunk*> m_ready;
+	std::mutex m_lock;
+	std::condition_variable m_cv;
+	bool m_exit;
+	bool m_eof;
+	bool m_error;
+
+	Chunk* m_cur;
+	size_t m_cur_index;
+
+	std::thread m_thread;
+
+	static GSDumpFile* OpenFile(const std::string& filename, const char* repack_filename);
+	void ReadHeader(GSDumpFile* file);
+	uint8* Alloc(Chunk*& c, uint32 size);
+	Chunk* Publish(Chunk* c);
+	void ThreadProc();
+
+	public:
+
+	GSDumpStream(const char* filename, int passes, size_t chunk_size = 4 << 20, int chunk_count = 8, const char* repack_filename = nullptr, int frame_limit = 0);
+	~GSDumpStream();
+
+	uint32 GetCRC() const {return m_crc;}
+	std::vector<uint8>& GetState() {return m_state;}
+	const uint8* GetRegs() const {return m_regs.data();}
+	bool HasError() const {return m_error;}
+
+	// Blocks until the next packet is decoded, returns false at the end of
+	// the last pass. p.buff stays valid until the following call.
+	bool Next(GSDumpPacket& p);
+};
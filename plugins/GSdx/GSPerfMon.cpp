@@ -29,15 +29,21 @@ GSPerfMon::GSPerfMon()
 {
 	memset(m_counters, 0, sizeof(m_counters));
 	memset(m_stats, 0, sizeof(m_stats));
+	memset(m_totals, 0, sizeof(m_totals));
 	memset(m_total, 0, sizeof(m_total));
 	memset(m_begin, 0, sizeof(m_begin));
 }
 
 void GSPerfMon::Put(counter_t c, double val)
 {
-#ifndef DISABLE_PERF_MON
+	// The frame count and the totals are kept even with DISABLE_PERF_MON (unix release
+	// builds), the headless benchmark report is built from them
 	if(c == Frame)
 	{
+		m_frame++;
+		m_totals[c]++;
+
+#ifndef DISABLE_PERF_MON
 #if defined(__unix__)
 		// clock on linux will return CLOCK_PROCESS_CPUTIME_ID.
 		// CLOCK_THREAD_CPUTIME_ID is much more useful to measure the fps
@@ -54,14 +60,17 @@ void GSPerfMon::Put(counter_t c, double val)
 		}
 
 		m_lastframe = now;
-		m_frame++;
 		m_count++;
+#endif
 	}
 	else
 	{
+		m_totals[c] += val;
+
+#ifndef DISABLE_PERF_MON
 		m_counters[c] += val;
-	}
 #endif
+	}
 }
 
 void GSPerfMon::Update()
@@ -36,12 +36,15 @@ public:
 	enum counter_t 
 	{
 		Frame, Prim, Draw, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint,
+		TextureDedupe, TextureDedupeBytes, // HW texture uploads skipped thanks to an identical hashed texture
+		Readback, ReadbackAsync, ReadbackStall, ReadbackAsyncStall, // HW target readbacks, stalls in ms
 		CounterLast,
 	};
 
 protected:
 	double m_counters[CounterLast];
 	double m_stats[CounterLast];
+	double m_totals[CounterLast];
 	uint64 m_begin[TimerLast], m_total[TimerLast], m_start[TimerLast];
 	uint64 m_frame;
 	clock_t m_lastframe;
@@ -57,6 +60,7 @@ public:
 
 	void Put(counter_t c, double val = 0);
 	double Get(counter_t c) {return m_stats[c];}
+	double GetTotal(counter_t c) const {return m_totals[c];} // never reset, callers diff two samples
 	void Update();
 
 	void Start(int timer = Main);
@@ -1542,6 +1542,8 @@ void GSState::FlushWrite()
 	r.right = r.left + m_env.TRXREG.RRW;
 	r.bottom = r.top + m_env.TRXREG.RRH;
 
+	m_mem.InvalidatePages(m_env.BITBLTBUF, r);
+
 	InvalidateVideoMem(m_env.BITBLTBUF, r);
 
 	//int y = m_tr.y;
@@ -1757,6 +1759,8 @@ void GSState::Write(const uint8* mem, int len)
 		r.right = r.left + m_env.TRXREG.RRW;
 		r.bottom = r.top + m_env.TRXREG.RRH;
 
+		m_mem.InvalidatePages(blit, r);
+
 		InvalidateVideoMem(blit, r);
 
 		(m_mem.*psm.wi)(m_tr.x, m_tr.y, mem, m_tr.total, blit, m_env.TRXPOS, m_env.TRXREG);
@@ -1874,6 +1878,7 @@ void GSState::Move()
 		sx, sy, dx, dy, w, h);
 
 	InvalidateLocalMem(m_env.BITBLTBUF, GSVector4i(sx, sy, sx + w, sy + h));
+	m_mem.InvalidatePages(m_env.BITBLTBUF, GSVector4i(dx, dy, dx + w, dy + h));
 	InvalidateVideoMem(m_env.BITBLTBUF, GSVector4i(dx, dy, dx + w, dy + h));
 
 	int xinc = 1;
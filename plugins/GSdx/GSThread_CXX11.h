@@ -24,11 +24,25 @@
 #include "GSdx.h"
 #include "Utilities/boost_spsc_queue.hpp"
 
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+// Names the calling thread, so that it shows up in debuggers and can be found by the
+// emulator's thread placement (Linux only for now, names are limited to 15 characters).
+inline void GSSetThreadName(const char* name)
+{
+#ifdef __linux__
+	pthread_setname_np(pthread_self(), name);
+#endif
+}
+
 template<class T, int CAPACITY> class GSJobQueue final
 {
 private:
 	std::thread m_thread;
 	std::function<void(T&)> m_func;
+	std::string m_name;
 	bool m_exit;
 	ringbuffer_base<T, CAPACITY> m_queue;
 
@@ -38,6 +52,9 @@ private:
 	std::condition_variable m_notempty;
 
 	void ThreadProc() {
+		if (!m_name.empty())
+			GSSetThreadName(m_name.c_str());
+
 		std::unique_lock<std::mutex> l(m_lock);
 
 		while (true) {
@@ -64,8 +81,9 @@ private:
 	}
 
 public:
-	GSJobQueue(std::function<void(T&)> func) :
+	GSJobQueue(std::function<void(T&)> func, const std::string& name = std::string()) :
 		m_func(func),
+		m_name(name),
 		m_exit(false)
 	{
 		m_thread = std::thread(&GSJobQueue::ThreadProc, this);
@@ -78,7 +78,7 @@ const char* GSUtil::GetLibName()
 #endif
 
 #if _M_SSE >= 0x501
-		"AVX2", "AVX2"
+		"AVX2", HasAVX512VL() ? "AVX2+AVX-512VL" : "AVX2"
 #elif _M_SSE >= 0x500
 		"AVX", sw_sse
 #elif _M_SSE >= 0x401
@@ -247,6 +247,18 @@ bool GSUtil::CheckSSE()
 	return status;
 }
 
+// AVX-512 foundation + vector length extensions (EVEX forms of the 256-bit instructions,
+// mask registers). There is no 512-bit SW renderer, this only enables a few shorter
+// sequences in the AVX2 scanline generator, so 64-bit AVX2 builds only.
+bool GSUtil::HasAVX512VL()
+{
+#if _M_SSE >= 0x501 && (defined(_M_AMD64) || defined(_WIN64))
+	return g_cpu.has(Xbyak::util::Cpu::tAVX512F) && g_cpu.has(Xbyak::util::Cpu::tAVX512VL);
+#else
+	return false;
+#endif
+}
+
 CRCHackLevel GSUtil::GetRecommendedCRCHackLevel(GSRendererType type)
 {
 	return type == GSRendererType::OGL_HW ? CRCHackLevel::Partial : CRCHackLevel::Full;
@@ -900,6 +900,11 @@ public:
 		return GSVector4i(_mm_add_epi32(m, v.m));
 	}
 
+	__forceinline GSVector4i add64(const GSVector4i& v) const
+	{
+		return GSVector4i(_mm_add_epi64(m, v.m));
+	}
+
 	__forceinline GSVector4i adds8(const GSVector4i& v) const
 	{
 		return GSVector4i(_mm_adds_epi8(m, v.m));
@@ -0,0 +1,319 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "stdafx.h"
+#include "GSY4M.h"
+
+static int gcd(int a, int b)
+{
+	while(b != 0)
+	{
+		int t = a % b;
+		a = b;
+		b = t;
+	}
+
+	return a;
+}
+
+GSY4MWriter::GSY4MWriter()
+	: m_file(NULL)
+	, m_yuv(NULL)
+	, m_exit(false)
+	, m_written(0)
+	, m_dropped(0)
+{
+}
+
+GSY4MWriter::~GSY4MWriter()
+{
+	Close();
+}
+
+bool GSY4MWriter::Open(const std::string& file, const GSVector2i& size, float fps, float aspect, int buffers)
+{
+	Close();
+
+	ASSERT((size.x & 7) == 0 && (size.y & 7) == 0);
+
+	m_file = fopen(file.c_str(), "wb");
+
+	if(m_file == NULL)
+	{
+		fprintf(stderr, "GSdx: failed to open capture file %s\n", file.c_str());
+
+		return false;
+	}
+
+	m_size = size;
+
+	// NTSC rates are 1000/1001 of an integer rate, keep them exact so that muxers don't drift
+
+	int fps_num = (int)(fps * 1000 + 0.5f);
+	int fps_den = 1000;
+
+	if(fabs(fps * 1.001f - floor(fps * 1.001f + 0.5f)) < 0.001f)
+	{
+		fps_num = (int)floor(fps * 1.001f + 0.5f) * 1000;
+		fps_den = 1001;
+	}
+
+	int fps_gcd = gcd(fps_num, fps_den);
+
+	// Y4M wants the pixel aspect ratio, derive it from the display aspect ratio
+
+	int par_num = (int)(aspect * size.y + 0.5f);
+	int par_den = size.x;
+	int par_gcd = std::max(gcd(par_num, par_den), 1);
+
+	fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:%d Ip A%d:%d C420jpeg XCOLORRANGE=LIMITED\n",
+		size.x, size.y, fps_num / fps_gcd, fps_den / fps_gcd, par_num / par_gcd, par_den / par_gcd);
+
+	m_frames.resize(std::max(buffers, 2));
+
+	for(Frame& frame : m_frames)
+	{
+		frame.rgba = (uint8*)_aligned_malloc(size.x * size.y * 4, 32);
+		frame.rb_swapped = false;
+
+		m_free.push_back(&frame);
+	}
+
+	m_yuv = (uint8*)_aligned_malloc(size.x * size.y * 3 / 2, 32);
+
+	m_exit = false;
+	m_written = 0;
+	m_dropped = 0;
+
+	m_thread = std::thread(&GSY4MWriter::ThreadProc, this);
+
+	return true;
+}
+
+void GSY4MWriter::Close()
+{
+	if(m_file == NULL)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+
+		m_exit = true;
+	}
+
+	m_notempty.notify_one();
+
+	m_thread.join();
+
+	fclose(m_file);
+
+	m_file = NULL;
+
+	fprintf(stderr, "GSdx: capture done, %llu frames written, %llu dropped\n", (unsigned long long)m_written, (unsigned long long)m_dropped);
+
+	for(Frame& frame : m_frames)
+	{
+		_aligned_free(frame.rgba);
+	}
+
+	m_frames.clear();
+	m_free.clear();
+	m_queued.clear();
+
+	_aligned_free(m_yuv);
+
+	m_yuv = NULL;
+}
+
+bool GSY4MWriter::Push(const uint8* bits, int pitch, bool rgba)
+{
+	Frame* frame;
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+
+		if(m_free.empty())
+		{
+			m_dropped++;
+
+			return false;
+		}
+
+		frame = m_free.back();
+
+		m_free.pop_back();
+	}
+
+	int row = m_size.x * 4;
+	int len = std::min(row, pitch);
+
+	ASSERT(len == row);
+
+	for(int y = 0; y < m_size.y; y++, bits += pitch)
+	{
+		uint8* dst = &frame->rgba[y * row];
+
+		memcpy(dst, bits, len);
+		memset(dst + len, 0, row - len); // narrower frame, black instead of stale data
+	}
+
+	frame->rb_swapped = !rgba;
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+
+		m_queued.push_back(frame);
+	}
+
+	m_notempty.notify_one();
+
+	return true;
+}
+
+void GSY4MWriter::ThreadProc()
+{
+	std::unique_lock<std::mutex> l(m_lock);
+
+	while(true)
+	{
+		while(m_queued.empty())
+		{
+			if(m_exit)
+				return;
+
+			m_notempty.wait(l);
+		}
+
+		Frame* frame = m_queued.front();
+
+		m_queued.pop_front();
+
+		l.unlock();
+
+		Convert(frame);
+
+		static const char header[] = "FRAME\n";
+
+		fwrite(header, sizeof(header) - 1, 1, m_file);
+		fwrite(m_yuv, m_size.x * m_size.y * 3 / 2, 1, m_file);
+
+		l.lock();
+
+		m_free.push_back(frame);
+		m_written++;
+	}
+}
+
+// RGB to YUV 4:2:0 (BT.601, limited range), two lines and eight pixels at a time.
+// Chroma is the average of each 2x2 block (centered, hence C420jpeg).
+//
+// Y = ((66 R + 129 G + 25 B + 128) >> 8) + 16
+// U = ((-38 R - 74 G + 112 B + 128) >> 8) + 128
+// V = ((112 R - 94 G - 18 B + 128) >> 8) + 128
+
+void GSY4MWriter::Convert(const Frame* frame)
+{
+	const int w = m_size.x;
+	const int h = m_size.y;
+
+	uint8* RESTRICT dy = m_yuv;
+	uint8* RESTRICT du = dy + w * h;
+	uint8* RESTRICT dv = du + w * h / 4;
+
+	const int rs = frame->rb_swapped ? 16 : 0;
+	const int bs = frame->rb_swapped ? 0 : 16;
+
+	const GSVector4i mask = GSVector4i::x000000ff();
+	const GSVector4i y_r = GSVector4i(66).ps32();
+	const GSVector4i y_g = GSVector4i(129).ps32();
+	const GSVector4i y_b = GSVector4i(25).ps32();
+	const GSVector4i y_round = GSVector4i(128).ps32();
+	const GSVector4i y_bias = GSVector4i(16).ps32();
+
+	// RG pairs and (B, 1) pairs for pmaddwd, the 1 picks up the rounding term
+
+	const GSVector4i u_rg(-38, -74, -38, -74, -38, -74, -38, -74);
+	const GSVector4i u_b1(112, 512, 112, 512, 112, 512, 112, 512);
+	const GSVector4i v_rg(112, -94, 112, -94, 112, -94, 112, -94);
+	const GSVector4i v_b1(-18, 512, -18, 512, -18, 512, -18, 512);
+	const GSVector4i one_hi(0x10000);
+	const GSVector4i uv_bias(128);
+
+	for(int y = 0; y < h; y += 2)
+	{
+		const uint8* src0 = &frame->rgba[(y + 0) * w * 4];
+		const uint8* src1 = &frame->rgba[(y + 1) * w * 4];
+
+		uint8* RESTRICT y0 = &dy[(y + 0) * w];
+		uint8* RESTRICT y1 = &dy[(y + 1) * w];
+		uint8* RESTRICT u = &du[(y / 2) * (w / 2)];
+		uint8* RESTRICT v = &dv[(y / 2) * (w / 2)];
+
+		for(int x = 0; x < w; x += 8)
+		{
+			GSVector4i r[2], g[2], b[2];
+
+			for(int i = 0; i < 2; i++)
+			{
+				const uint8* s = (i == 0 ? src0 : src1) + x * 4;
+
+				GSVector4i p0 = GSVector4i::load<true>(s);
+				GSVector4i p1 = GSVector4i::load<true>(s + 16);
+
+				r[i] = (p0.srl32(rs) & mask).ps32(p1.srl32(rs) & mask);
+				g[i] = (p0.srl32(8) & mask).ps32(p1.srl32(8) & mask);
+				b[i] = (p0.srl32(bs) & mask).ps32(p1.srl32(bs) & mask);
+
+				// The sum fits in 16 bits unsigned, so the wrapping adds and the logical shift are exact
+
+				GSVector4i l = r[i].mul16l(y_r).add16(g[i].mul16l(y_g)).add16(b[i].mul16l(y_b)).add16(y_round);
+
+				l = l.srl16(8).add16(y_bias);
+
+				GSVector4i::storel(i == 0 ? &y0[x] : &y1[x], l.pu16(l));
+			}
+
+			// Sum of each 2x2 block (0 - 1020)
+
+			GSVector4i rr = r[0].add16(r[1]);
+			GSVector4i gg = g[0].add16(g[1]);
+			GSVector4i bb = b[0].add16(b[1]);
+
+			rr = (rr & GSVector4i::x0000ffff()).add32(rr.srl32(16));
+			gg = (gg & GSVector4i::x0000ffff()).add32(gg.srl32(16));
+			bb = (bb & GSVector4i::x0000ffff()).add32(bb.srl32(16));
+
+			GSVector4i rg = rr | gg.sll32(16);
+			GSVector4i b1 = bb | one_hi;
+
+			GSVector4i cu = rg.madd(u_rg).add32(b1.madd(u_b1)).sra32(10).add32(uv_bias);
+			GSVector4i cv = rg.madd(v_rg).add32(b1.madd(v_b1)).sra32(10).add32(uv_bias);
+
+			cu = cu.ps32(cu);
+			cv = cv.ps32(cv);
+
+			*(int*)&u[x / 2] = cu.pu16(cu).extract32<0>();
+			*(int*)&v[x / 2] = cv.pu16(cv).extract32<0>();
+		}
+	}
+}
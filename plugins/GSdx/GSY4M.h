@@ -0,0 +1,71 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "GSVector.h"
+
+// Streams the captured frames into a single YUV4MPEG2 (.y4m) file, which any encoder
+// (ffmpeg, x264, ...) can read directly.
+//
+// The GS thread only copies the mapped frame into a preallocated buffer. The RGB to
+// YUV 4:2:0 conversion and the file writes happen on a dedicated thread. When the writer
+// falls behind and all the buffers are in flight, frames are dropped instead of stalling
+// the GS thread.
+class GSY4MWriter
+{
+	struct Frame
+	{
+		uint8* rgba;
+		bool rb_swapped;
+	};
+
+	FILE* m_file;
+	GSVector2i m_size;
+
+	std::vector<Frame> m_frames;
+	std::vector<Frame*> m_free;
+	std::deque<Frame*> m_queued;
+	uint8* m_yuv;
+
+	std::thread m_thread;
+	std::mutex m_lock;
+	std::condition_variable m_notempty;
+	bool m_exit;
+
+	uint64 m_written;
+	uint64 m_dropped;
+
+	void ThreadProc();
+	void Convert(const Frame* frame);
+
+public:
+	GSY4MWriter();
+	~GSY4MWriter();
+
+	// size must be a multiple of 8 in both directions.
+	bool Open(const std::string& file, const GSVector2i& size, float fps, float aspect, int buffers);
+	void Close();
+
+	// The frame is expected to be the size given to Open, anything past it is ignored.
+	// Returns false if the frame was dropped.
+	bool Push(const uint8* bits, int pitch, bool rgba);
+};
@@ -312,6 +312,9 @@ void GSdxApp::Init()
 	m_gs_acc_blend_level_d3d11.push_back(GSSetting(2, "Medium", "Debug"));
 	m_gs_acc_blend_level_d3d11.push_back(GSSetting(3, "High", "Debug"));
 
+	m_gs_capture_format.push_back(GSSetting(0, "PNG", "One file per frame"));
+	m_gs_capture_format.push_back(GSSetting(1, "Y4M", "Uncompressed stream"));
+
 	m_gs_tv_shaders.push_back(GSSetting(0, "None", ""));
 	m_gs_tv_shaders.push_back(GSSetting(1, "Scanline filter", ""));
 	m_gs_tv_shaders.push_back(GSSetting(2, "Diagonal filter", ""));
@@ -337,6 +340,7 @@ void GSdxApp::Init()
 	m_default_configuration["AspectRatio"] = "1";
 	m_default_configuration["autoflush_sw"] = "1";
 	m_default_configuration["capture_enabled"] = "0";
+	m_default_configuration["capture_format"] = "1";
 	m_default_configuration["capture_out_dir"] = "/tmp/GSdx_Capture";
 	m_default_configuration["capture_threads"] = "4";
 	m_default_configuration["CaptureHeight"] = "480";
@@ -350,7 +354,9 @@ void GSdxApp::Init()
 	m_default_configuration["dithering_ps2"] = "1";
 	m_default_configuration["dump"] = "0";
 	m_default_configuration["extrathreads"] = "2";
+	m_default_configuration["extrathreads_binning"] = "0";
 	m_default_configuration["extrathreads_height"] = "4";
+	m_default_configuration["sw_avx512vl"] = "1";
 	m_default_configuration["filter"] = std::to_string(static_cast<int8>(BiFiltering::PS2));
 	m_default_configuration["force_texture_clear"] = "0";
 	m_default_configuration["fxaa"] = "0";
@@ -414,6 +420,10 @@ void GSdxApp::Init()
 	m_default_configuration["shaderfx"] = "0";
 	m_default_configuration["shaderfx_conf"] = "shaders/GSdx_FX_Settings.ini";
 	m_default_configuration["shaderfx_glsl"] = "shaders/GSdx.fx";
+	m_default_configuration["sw_jit_cache"] = "1";
+	m_default_configuration["swizzle_threads"] = "2";
+	m_default_configuration["swizzle_threshold"] = "262144";
+	m_default_configuration["texture_dedupe"] = "0";
 	m_default_configuration["TVShader"] = "0";
 	m_default_configuration["upscale_multiplier"] = "1";
 	m_default_configuration["UserHacks"] = "0";
@@ -520,6 +530,13 @@ void GSdxApp::SetConfigDir(const char *dir)
 	}
 }
 
+std::string GSdxApp::GetConfigDir()
+{
+	size_t pos = m_ini.find_last_of(DIRECTORY_SEPARATOR);
+
+	return pos == std::string::npos ? std::string() : m_ini.substr(0, pos + 1);
+}
+
 std::string GSdxApp::GetConfigS(const char *entry)
 {
 	char buff[4096] = {0};
@@ -64,6 +64,7 @@ public:
 	GSRendererType GetCurrentRendererType();
 
 	void SetConfigDir(const char* dir);
+	std::string GetConfigDir();
 
 	std::vector<GSSetting> m_gs_renderers;
 	std::vector<GSSetting> m_gs_interlace;
@@ -81,6 +82,7 @@ public:
 	std::vector<GSSetting> m_gs_acc_blend_level;
 	std::vector<GSSetting> m_gs_acc_blend_level_d3d11;
 	std::vector<GSSetting> m_gs_tv_shaders;
+	std::vector<GSSetting> m_gs_capture_format;
 };
 
 struct GSDXError {};
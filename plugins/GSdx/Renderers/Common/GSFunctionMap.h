@@ -160,17 +160,88 @@ class GSCodeGeneratorFunctionMap : public GSFunctionMap<KEY, VALUE>
 	std::string m_name;
 	void* m_param;
 	std::unordered_map<uint64, VALUE> m_cgmap;
+	std::unordered_set<uint64> m_prepared; // generated ahead of time, not requested yet
+	std::mutex m_lock; // Prepare() runs on another thread than the rasterizer
 	GSCodeBuffer m_cb;
 	size_t m_total_code_size;
 
 	enum {MAX_SIZE = 8192};
 
+	VALUE Generate(KEY key)
+	{
+		void* code_ptr = m_cb.GetBuffer(MAX_SIZE);
+
+		CG* cg = new CG(m_param, key, code_ptr, MAX_SIZE);
+		ASSERT(cg->getSize() < MAX_SIZE);
+
+#if 0
+		fprintf(stderr, "%s Location:%p Size:%zu Key:%llx\n", m_name.c_str(), code_ptr, cg->getSize(), (uint64)key);
+		GSScanlineSelector sel(key);
+		sel.Print();
+#endif
+
+		m_total_code_size += cg->getSize();
+
+		m_cb.ReleaseBuffer(cg->getSize());
+
+		VALUE ret = (VALUE)cg->getCode();
+
+		m_cgmap[key] = ret;
+
+		#ifdef ENABLE_VTUNE
+
+		// vtune method registration
+
+		// if(iJIT_IsProfilingActive()) // always > 0
+		{
+			std::string name = format("%s<%016llx>()", m_name.c_str(), (uint64)key);
+
+			iJIT_Method_Load ml;
+
+			memset(&ml, 0, sizeof(ml));
+
+			ml.method_id = iJIT_GetNewMethodID();
+			ml.method_name = (char*)name.c_str();
+			ml.method_load_address = (void*)cg->getCode();
+			ml.method_size = (unsigned int)cg->getSize();
+
+			iJIT_NotifyEvent(iJVM_EVENT_TYPE_METHOD_LOAD_FINISHED, &ml);
+/*
+			name = format("c:/temp1/%s_%016llx.bin", m_name.c_str(), (uint64)key);
+
+			if(FILE* fp = fopen(name.c_str(), "wb"))
+			{
+				fputc(0x0F, fp); fputc(0x0B, fp);
+				fputc(0xBB, fp); fputc(0x6F, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
+				fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
+
+				fwrite(cg->getCode(), cg->getSize(), 1, fp);
+
+				fputc(0xBB, fp); fputc(0xDE, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
+				fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
+				fputc(0x0F, fp); fputc(0x0B, fp);
+
+				fclose(fp);
+			}
+*/
+		}
+
+		#endif
+
+		delete cg;
+
+		return ret;
+	}
+
 public:
+	struct Stats {int generated, prepared, stall_avoided;} m_stats;
+
 	GSCodeGeneratorFunctionMap(const char* name, void* param)
 		: m_name(name)
 		, m_param(param)
 		, m_total_code_size(0)
 	{
+		memset(&m_stats, 0, sizeof(m_stats));
 	}
 
 	~GSCodeGeneratorFunctionMap()
@@ -182,78 +253,49 @@ public:
 
 	VALUE GetDefaultFunction(KEY key)
 	{
-		VALUE ret = NULL;
+		std::lock_guard<std::mutex> lock(m_lock);
 
 		auto i = m_cgmap.find(key);
 
 		if(i != m_cgmap.end())
 		{
-			ret = i->second;
-		}
-		else
-		{
-			void* code_ptr = m_cb.GetBuffer(MAX_SIZE);
-
-			CG* cg = new CG(m_param, key, code_ptr, MAX_SIZE);
-			ASSERT(cg->getSize() < MAX_SIZE);
-
-#if 0
-			fprintf(stderr, "%s Location:%p Size:%zu Key:%llx\n", m_name.c_str(), code_ptr, cg->getSize(), (uint64)key);
-			GSScanlineSelector sel(key);
-			sel.Print();
-#endif
-
-			m_total_code_size += cg->getSize();
-
-			m_cb.ReleaseBuffer(cg->getSize());
-
-			ret = (VALUE)cg->getCode();
-
-			m_cgmap[key] = ret;
-
-			#ifdef ENABLE_VTUNE
-
-			// vtune method registration
-
-			// if(iJIT_IsProfilingActive()) // always > 0
+			if(m_prepared.erase(key) > 0)
 			{
-				std::string name = format("%s<%016llx>()", m_name.c_str(), (uint64)key);
+				m_stats.stall_avoided++;
+			}
 
-				iJIT_Method_Load ml;
+			return i->second;
+		}
 
-				memset(&ml, 0, sizeof(ml));
+		m_stats.generated++;
 
-				ml.method_id = iJIT_GetNewMethodID();
-				ml.method_name = (char*)name.c_str();
-				ml.method_load_address = (void*)cg->getCode();
-				ml.method_size = (unsigned int)cg->getSize();
+		return Generate(key);
+	}
 
-				iJIT_NotifyEvent(iJVM_EVENT_TYPE_METHOD_LOAD_FINISHED, &ml);
-/*
-				name = format("c:/temp1/%s_%016llx.bin", m_name.c_str(), (uint64)key);
+	// Generates the code of a key before the rasterizer asks for it.
+	void Prepare(KEY key)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
 
-				if(FILE* fp = fopen(name.c_str(), "wb"))
-				{
-					fputc(0x0F, fp); fputc(0x0B, fp);
-					fputc(0xBB, fp); fputc(0x6F, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
-					fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
+		if(m_cgmap.find(key) == m_cgmap.end())
+		{
+			Generate(key);
 
-					fwrite(cg->getCode(), cg->getSize(), 1, fp);
+			m_prepared.insert(key);
+			m_stats.prepared++;
+		}
+	}
 
-					fputc(0xBB, fp); fputc(0xDE, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
-					fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
-					fputc(0x0F, fp); fputc(0x0B, fp);
+	void GetKeys(std::vector<uint64>& keys)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
 
-					fclose(fp);
-				}
-*/
+		for(const auto& i : m_cgmap)
+		{
+			if(m_prepared.find(i.first) == m_prepared.end())
+			{
+				keys.push_back(i.first);
 			}
-
-			#endif
-
-			delete cg;
 		}
-
-		return ret;
 	}
 };
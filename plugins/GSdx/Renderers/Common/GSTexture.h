@@ -49,6 +49,9 @@ public:
 	virtual bool Map(GSMap& m, const GSVector4i* r = NULL, int layer = 0) = 0;
 	virtual void Unmap() = 0;
 	virtual void GenerateMipmap() {}
+	// Offscreen only: starts copying r to the CPU, a later Map() of the same rect waits for it instead of the whole pipeline
+	virtual bool ReadbackAsync(const GSVector4i& r) {return false;}
+	virtual void ReadbackCancel() {}
 	virtual bool Save(const std::string& fn) = 0;
 	virtual uint32 GetID() { return 0; }
 
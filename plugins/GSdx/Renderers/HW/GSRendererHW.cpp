@@ -793,6 +793,7 @@ void GSRendererHW::SwSpriteRender()
 
 	if (texture_mapping_enabled)
 		InvalidateLocalMem(bitbltbuf, GSVector4i(sx, sy, sx + w, sy + h));
+	m_mem.InvalidatePages(bitbltbuf, GSVector4i(dx, dy, dx + w, dy + h));
 	InvalidateVideoMem(bitbltbuf, GSVector4i(dx, dy, dx + w, dy + h));
 
 	GSOffset* RESTRICT spo = texture_mapping_enabled ? m_mem.GetOffset(bitbltbuf.SBP, bitbltbuf.SBW, bitbltbuf.SPSM) : nullptr;
@@ -1111,6 +1112,9 @@ void GSRendererHW::Draw()
 		ds_tex = ds->m_texture;
 	}
 
+	// The other targets won't be drawn to for a while, read them back ahead of the CPU
+	m_tc->PrefetchReadbacks(rt, ds);
+
 	m_src = nullptr;
 	m_texture_shuffle = false;
 
@@ -1784,7 +1788,7 @@ bool GSRendererHW::OI_FFXII(GSTexture* rt, GSTexture* ds, GSTextureCache::Source
 				// normally, this step would copy the video onto screen with 512 texture mapped horizontal lines,
 				// but we use the stored video data to create a new texture, and replace the lines with two triangles
 
-				m_dev->Recycle(t->m_texture);
+				t->ReleaseTexture(); // might be a hashed texture shared with other sources
 
 				t->m_texture = m_dev->CreateTexture(512, 512);
 
@@ -27,6 +27,97 @@
 bool GSTextureCache::m_disable_partial_invalidation = false;
 bool GSTextureCache::m_wrap_gs_mem = false;
 
+// 128 bits wide streaming hash of the GS memory behind a texture. Each 16 bytes are
+// accumulated with a 32x32->64 bits multiply (the XXH3 accumulate step), and the lanes
+// are scrambled between blocks so that moving blocks around changes the hash.
+class GSBlockHash
+{
+	GSVector4i m_acc[2];
+
+	__forceinline void Accumulate(GSVector4i& acc, const GSVector4i& data, const GSVector4i& key)
+	{
+		GSVector4i dk = data ^ key;
+		GSVector4i prod = GSVector4i(_mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(2, 3, 0, 1))));
+
+		acc = acc.add64(data.zwxy()).add64(prod);
+	}
+
+	__forceinline void Scramble(GSVector4i& acc, const GSVector4i& key)
+	{
+		const GSVector4i prime(0x9E3779B1);
+
+		acc = acc ^ acc.srl64(47) ^ key;
+
+		GSVector4i lo = GSVector4i(_mm_mul_epu32(acc, prime));
+		GSVector4i hi = GSVector4i(_mm_mul_epu32(acc.srl64(32), prime));
+
+		acc = lo.add64(hi.sll64(32));
+	}
+
+	static const GSVector4i& Key(int i)
+	{
+		static const GSVector4i keys[4] =
+		{
+			GSVector4i(0xbe4ba423, 0x396cfeb8, 0x1cad21f7, 0x2c81017c),
+			GSVector4i(0xdb979083, 0xe96b6e6d, 0x8a0b1f3c, 0x4fe6b1a5),
+			GSVector4i(0x7c1e8b52, 0xd1b8e5a6, 0x1fcb0a87, 0xa9c54e3f),
+			GSVector4i(0x63d2b7e9, 0x0f4a7c15, 0x85ebca77, 0xc2b2ae3d),
+		};
+
+		return keys[i & 3];
+	}
+
+public:
+	GSBlockHash()
+	{
+		m_acc[0] = Key(2);
+		m_acc[1] = Key(3);
+	}
+
+	// size must be a multiple of 32
+	void Add(const void* p, size_t size)
+	{
+		const GSVector4i* RESTRICT v = (const GSVector4i*)p;
+
+		for(size_t i = 0; i < size / 16; i += 2)
+		{
+			Accumulate(m_acc[0], GSVector4i::load<false>(&v[i + 0]), Key(i + 0));
+			Accumulate(m_acc[1], GSVector4i::load<false>(&v[i + 1]), Key(i + 1));
+		}
+
+		Scramble(m_acc[0], Key(1));
+		Scramble(m_acc[1], Key(0));
+	}
+
+	void Add(uint64 a, uint64 b)
+	{
+		GSVector4i v = GSVector4i::loadl(&a).upl64(GSVector4i::loadl(&b));
+
+		Accumulate(m_acc[0], v, Key(0));
+		Accumulate(m_acc[1], v, Key(1));
+
+		Scramble(m_acc[0], Key(1));
+		Scramble(m_acc[1], Key(0));
+	}
+
+	uint64 Get() const
+	{
+		GSVector4i acc = m_acc[0] ^ m_acc[1].zwxy();
+
+		uint64 h = acc.u64[0] ^ (acc.u64[1] * 0x9E3779B185EBCA87ULL);
+
+		// XXH64 avalanche
+
+		h ^= h >> 33;
+		h *= 0xC2B2AE3D27D4EB4FULL;
+		h ^= h >> 29;
+		h *= 0x165667B19E3779F9ULL;
+		h ^= h >> 32;
+
+		return h;
+	}
+};
+
 GSTextureCache::GSTextureCache(GSRenderer* r)
 	: m_renderer(r)
 	, m_palette_map(r)
@@ -50,6 +141,7 @@ GSTextureCache::GSTextureCache(GSRenderer* r)
 	}
 
 	m_paltex = theApp.GetConfigB("paltex");
+	m_texture_dedupe = theApp.GetConfigB("texture_dedupe");
 	m_crc_hack_level = theApp.GetConfigT<CRCHackLevel>("crc_hack_level");
 	if (m_crc_hack_level == CRCHackLevel::Automatic)
 		m_crc_hack_level = GSUtil::GetRecommendedCRCHackLevel(theApp.GetCurrentRendererType());
@@ -94,6 +186,16 @@ void GSTextureCache::RemoveAll()
 		m_dst[type].clear();
 	}
 
+	// Sources are gone, nobody references the hashed textures anymore
+	for (auto& i : m_hashed_textures)
+	{
+		ASSERT(i.second.refs == 0);
+
+		m_renderer->m_dev->Recycle(i.second.texture);
+	}
+
+	m_hashed_textures.clear();
+
 	m_palette_map.Clear();
 }
 
@@ -454,6 +556,10 @@ GSTextureCache::Source* GSTextureCache::LookupSource(const GIFRegTEX0& TEX0, con
 		AttachPaletteToSource(src, psm_s.pal, true);
 	}
 
+	if (new_source && m_texture_dedupe && !src->m_target) {
+		DedupeSource(src, r);
+	}
+
 	src->Update(r);
 
 	m_src.m_used = true;
@@ -461,6 +567,104 @@ GSTextureCache::Source* GSTextureCache::LookupSource(const GIFRegTEX0& TEX0, con
 	return src;
 }
 
+bool GSTextureCache::HashSource(Source* src, const GSVector4i& r, uint64& hash)
+{
+	const GIFRegTEX0& TEX0 = src->m_TEX0;
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
+	const GSVector2i& bs = psm.bs;
+
+	int tw = std::max<int>(1 << TEX0.TW, bs.x);
+	int th = std::max<int>(1 << TEX0.TH, bs.y);
+
+	// Only whole textures can be shared, a partial upload leaves the rest undefined
+	if(!r.ralign<Align_Outside>(bs).eq(GSVector4i(0, 0, tw, th)))
+	{
+		return false;
+	}
+
+	const GSOffset* off = m_renderer->m_context->offset.tex;
+	const GSLocalMemory& mem = m_renderer->m_mem;
+
+	GSBlockHash h;
+
+	// Blocks are hashed in texture order, the same sequence of blocks decodes to the same
+	// texture whatever TBP0/TBW they came from.
+	for(int y = 0; y < th; y += bs.y)
+	{
+		uint32 base = off->block.row[y >> 3u];
+
+		for(int x = 0; x < tw; x += bs.x)
+		{
+			uint32 block = base + off->block.col[x >> 3u];
+
+			if(block >= MAX_BLOCKS && !m_wrap_gs_mem)
+			{
+				return false;
+			}
+
+			h.Add(mem.BlockPtr(block % MAX_BLOCKS), 256);
+		}
+	}
+
+	// Everything else that changes the decoded texels
+	h.Add(TEX0.PSM | (TEX0.TW << 8) | (TEX0.TH << 12) | ((src->m_palette ? 1ull : 0) << 16), src->m_TEXA.u64);
+
+	if(psm.pal > 0 && !src->m_palette)
+	{
+		// Expanded on the CPU with the current CLUT
+		h.Add((const uint32*)mem.m_clut, psm.pal * sizeof(uint32));
+	}
+
+	hash = h.Get();
+
+	return true;
+}
+
+// Games regularly upload data which is already on the GPU: the same texture again after
+// it was invalidated, or into another slot of a streaming pool. The GS memory behind the
+// whole texture is hashed, and an identical texture is reused instead of being unswizzled
+// and uploaded again.
+void GSTextureCache::DedupeSource(Source* src, const GSVector4i& r)
+{
+	uint64 hash;
+
+	if(!HashSource(src, r, hash))
+	{
+		return;
+	}
+
+	auto i = m_hashed_textures.find(hash);
+
+	if(i != m_hashed_textures.end())
+	{
+		HashedTexture& e = i->second;
+
+		if(e.texture->GetFormat() == src->m_texture->GetFormat())
+		{
+			int tw = 1 << src->m_TEX0.TW;
+			int th = 1 << src->m_TEX0.TH;
+
+			m_renderer->m_perfmon.Put(GSPerfMon::TextureDedupe, 1);
+			m_renderer->m_perfmon.Put(GSPerfMon::TextureDedupeBytes, tw * th << (src->m_palette ? 0 : 2));
+
+			src->ReleaseTexture();
+			src->Share(&e);
+			src->m_complete = true; // m_valid stays empty, any invalidation will upload the whole texture again
+		}
+
+		return;
+	}
+
+	src->Update(r);
+
+	if(src->m_complete)
+	{
+		HashedTexture e = {src->m_texture, 0, 0};
+
+		src->Share(&(m_hashed_textures[hash] = e));
+	}
+}
+
 void GSTextureCache::ScaleTexture(GSTexture* texture)
 {
 	if (!m_renderer->CanUpscale())
@@ -600,6 +804,7 @@ GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, int
 	if(used)
 	{
 		dst->m_used = true;
+		dst->DiscardReadback();
 	}
 
 	return dst;
@@ -806,6 +1011,7 @@ void GSTextureCache::InvalidateVideoMem(GSOffset* off, const GSVector4i& rect, b
 							t->m_texture ? t->m_texture->GetID() : 0,
 							t->m_TEX0.TBP0);
 					m_renderer->m_dev->ClearRenderTarget(t->m_texture, 0);
+					t->DiscardReadback();
 				}
 			}
 		}
@@ -1131,6 +1337,9 @@ void GSTextureCache::InvalidateVideoMemSubTarget(GSTextureCache::Target* rt)
 
 void GSTextureCache::IncAge()
 {
+	// End of the frame, whatever was drawn into a target is final now
+	PrefetchReadbacks(NULL, NULL);
+
 	int maxage = m_src.m_used ? 3 : 30;
 
 	// You can't use m_map[page] because Source* are duplicated on several pages.
@@ -1138,7 +1347,7 @@ void GSTextureCache::IncAge()
 	{
 		Source* s = *i;
 
-		if(s->m_shared_texture) {
+		if(s->m_shared_texture && !s->m_hashed) {
 			// Shared textures are temporary only added in the hash set but not in the texture
 			// cache list therefore you can't use RemoveAt
 			i = m_src.m_surfaces.erase(i);
@@ -1153,6 +1362,24 @@ void GSTextureCache::IncAge()
 
 	m_src.m_used = false;
 
+	// Unreferenced hashed textures are kept around for a while, games tend to upload the
+	// same data again shortly after they overwrote it.
+	for(auto i = m_hashed_textures.begin(); i != m_hashed_textures.end(); )
+	{
+		HashedTexture& e = i->second;
+
+		if(e.refs == 0 && ++e.age > 30)
+		{
+			m_renderer->m_dev->Recycle(e.texture);
+
+			i = m_hashed_textures.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
 	// Clearing of Rendertargets causes flickering in many scene transitions.
 	// Sigh, this seems to be used to invalidate surfaces. So set a huge maxage to avoid flicker,
 	// but still invalidate surfaces. (Disgaea 2 fmv when booting the game through the BIOS)
@@ -1190,6 +1417,25 @@ void GSTextureCache::IncAge()
 	}
 }
 
+// Games which read a target back tend to do it again on the next frames, once they are done
+// drawing into it. Start the copy as soon as another target is bound (or at the end of the
+// frame) so that Read() doesn't have to wait for the whole GPU pipeline.
+void GSTextureCache::PrefetchReadbacks(Target* rt, Target* ds)
+{
+	for(int type = 0; type < 2; type++)
+	{
+		for(auto t : m_dst[type])
+		{
+			if(t == rt || t == ds || !t->m_readback_wanted || !t->m_readback_stale || !t->m_dirty.empty())
+				continue;
+
+			t->m_readback_stale = false;
+
+			PrefetchReadback(t);
+		}
+	}
+}
+
 //Fixme: Several issues in here. Not handling depth stencil, pitch conversion doesnt work.
 GSTextureCache::Source* GSTextureCache::CreateSource(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, Target* dst, bool half_right, int x_offset, int y_offset)
 {
@@ -1615,6 +1861,7 @@ GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFR
 	, m_p2t(NULL)
 	, m_from_target(NULL)
 	, m_from_target_TEX0(TEX0)
+	, m_hashed(NULL)
 {
 	m_TEX0 = TEX0;
 	m_TEXA = TEXA;
@@ -1650,6 +1897,11 @@ GSTextureCache::Source::Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFR
 GSTextureCache::Source::~Source()
 {
 	_aligned_free(m_write.rect);
+
+	if(m_hashed)
+	{
+		ReleaseTexture();
+	}
 }
 
 void GSTextureCache::Source::Update(const GSVector4i& rect, int layer)
@@ -1798,8 +2050,59 @@ void GSTextureCache::Source::Write(const GSVector4i& r, int layer)
 	}
 }
 
+// Sources sharing a hashed texture get their own copy before anything is written to it
+void GSTextureCache::Source::Unshare()
+{
+	GSDevice* dev = m_renderer->m_dev;
+
+	int w = m_texture->GetWidth();
+	int h = m_texture->GetHeight();
+
+	GSTexture* t = dev->CreateTexture(w, h, m_texture->GetFormat());
+
+	dev->CopyRect(m_texture, t, GSVector4i(0, 0, w, h));
+
+	ReleaseTexture();
+
+	m_texture = t;
+}
+
+// m_texture is owned by the hashed texture cache from now on
+void GSTextureCache::Source::Share(HashedTexture* e)
+{
+	m_texture = e->texture;
+	m_hashed = e;
+	m_shared_texture = true;
+
+	e->refs++;
+	e->age = 0;
+}
+
+// Drops m_texture, before the source gets another one. A hashed texture is only
+// unreferenced, the texture cache recycles it once it ages out.
+void GSTextureCache::Source::ReleaseTexture()
+{
+	if(m_hashed)
+	{
+		m_hashed->refs--;
+		m_hashed = NULL;
+		m_shared_texture = false;
+	}
+	else if(!m_shared_texture)
+	{
+		m_renderer->m_dev->Recycle(m_texture);
+	}
+
+	m_texture = NULL;
+}
+
 void GSTextureCache::Source::Flush(uint32 count, int layer)
 {
+	if(m_hashed)
+	{
+		Unshare();
+	}
+
 	// This function as written will not work for paletted formats copied from framebuffers
 	// because they are 8 or 4 bit formats on the GS and the GS local memory module reads
 	// these into an 8 bit format while the D3D surfaces are 32 bit.
@@ -1834,7 +2137,7 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 		if((r > tr).mask() & 0xff00)
 		{
-			(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+			mem.ReadTextureParallel(rtx, off, r, buff, pitch, m_TEXA);
 
 			m_texture->Update(r.rintersect(tr), buff, pitch, layer);
 		}
@@ -1844,13 +2147,13 @@ void GSTextureCache::Source::Flush(uint32 count, int layer)
 
 			if(m_texture->Map(m, &r, layer))
 			{
-				(mem.*rtx)(off, r, m.bits, m.pitch, m_TEXA);
+				mem.ReadTextureParallel(rtx, off, r, m.bits, m.pitch, m_TEXA);
 
 				m_texture->Unmap();
 			}
 			else
 			{
-				(mem.*rtx)(off, r, buff, pitch, m_TEXA);
+				mem.ReadTextureParallel(rtx, off, r, buff, pitch, m_TEXA);
 
 				m_texture->Update(r, buff, pitch, layer);
 			}
@@ -1878,12 +2181,41 @@ GSTextureCache::Target::Target(GSRenderer* r, const GIFRegTEX0& TEX0, uint8* tem
 	, m_used(false)
 	, m_depth_supported(depth_supported)
 	, m_end_block(0)
+	, m_readback(NULL)
+	, m_readback_src(NULL)
+	, m_readback_psm(0)
+	, m_readback_wanted(false)
+	, m_readback_stale(false)
 {
 	m_TEX0 = TEX0;
 	m_32_bits_fmt |= (GSLocalMemory::m_psm[TEX0.PSM].trbpp != 16);
 	m_dirty_alpha = GSLocalMemory::m_psm[TEX0.PSM].trbpp != 24;
 
 	m_valid = GSVector4i::zero();
+	m_readback_rect = GSVector4i::zero();
+	m_readback_want = GSVector4i::zero();
+}
+
+GSTextureCache::Target::~Target()
+{
+	DiscardReadback();
+}
+
+void GSTextureCache::Target::DiscardReadback()
+{
+	m_readback_stale = true;
+
+	if (m_readback == NULL)
+		return;
+
+	// Nobody used it, don't bother until the target is read back again
+	m_readback_wanted = false;
+
+	m_readback->ReadbackCancel();
+	m_renderer->m_dev->Recycle(m_readback);
+
+	m_readback = NULL;
+	m_readback_src = NULL;
 }
 
 void GSTextureCache::Target::Update()
@@ -1909,6 +2241,8 @@ void GSTextureCache::Target::Update()
 
 	if (r.rempty()) return;
 
+	DiscardReadback();
+
 	// No handling please
 	if ((m_type == DepthStencil) && !m_depth_supported) {
 		// do the most likely thing a direct write would do, clear it
@@ -93,12 +93,21 @@ public:
 		bool operator()(const PaletteKey &lhs, const PaletteKey &rhs) const;
 	};
 
+	// Texture owned by the cache and shared by every source which uploaded identical data
+	struct HashedTexture
+	{
+		GSTexture* texture;
+		uint32 refs;
+		int age;
+	};
+
 	class Source : public Surface
 	{
 		struct {GSVector4i* rect; uint32 count;} m_write;
 
 		void Write(const GSVector4i& r, int layer);
 		void Flush(uint32 count, int layer);
+		void Unshare();
 
 	public:
 		std::shared_ptr<Palette> m_palette_obj;
@@ -118,6 +127,7 @@ public:
 		// Keep a GSTextureCache::SourceMap::m_map iterator to allow fast erase
 		std::array<uint16, MAX_PAGES> m_erase_it;
 		uint32* m_pages_as_bit;
+		HashedTexture* m_hashed; // m_texture belongs to this hashed texture (m_shared_texture is set)
 
 	public:
 		Source(GSRenderer* r, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint8* temp, bool dummy_container = false);
@@ -127,6 +137,9 @@ public:
 		void UpdateLayer(const GIFRegTEX0& TEX0, const GSVector4i& rect, int layer = 0);
 
 		bool ClutMatch(PaletteKey palette_key);
+
+		void Share(HashedTexture* e);
+		void ReleaseTexture();
 	};
 
 	class Target : public Surface
@@ -140,13 +153,24 @@ public:
 		bool m_dirty_alpha;
 		uint32 m_end_block; // Hint of the target area
 
+		// Readback started ahead of time, for targets which were already read back once
+		GSTexture* m_readback;
+		GSTexture* m_readback_src;
+		GSVector4i m_readback_rect;
+		uint32 m_readback_psm;
+		GSVector4i m_readback_want;
+		bool m_readback_wanted;
+		bool m_readback_stale;
+
 	public:
 		Target(GSRenderer* r, const GIFRegTEX0& TEX0, uint8* temp, bool depth_supported);
+		virtual ~Target();
 
 		void UpdateValidity(const GSVector4i& rect);
 		bool Inside(uint32 bp, uint32 bw, uint32 psm, const GSVector4i& rect);
 
 		void Update();
+		void DiscardReadback();
 	};
 
 	class PaletteMap
@@ -214,12 +238,19 @@ protected:
 	static bool m_wrap_gs_mem;
 	uint8 m_texture_inside_rt_cache_size = 255;
 	std::vector<TexInsideRtCacheEntry> m_texture_inside_rt_cache;
+	bool m_texture_dedupe;
+	std::unordered_map<uint64, HashedTexture> m_hashed_textures;
+
+	bool HashSource(Source* src, const GSVector4i& r, uint64& hash);
+	void DedupeSource(Source* src, const GSVector4i& r);
 
 	virtual Source* CreateSource(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, Target* t = NULL, bool half_right = false, int x_offset = 0, int y_offset = 0);
 	virtual Target* CreateTarget(const GIFRegTEX0& TEX0, int w, int h, int type);
 
 	virtual int Get8bitFormat() = 0;
 
+	virtual void PrefetchReadback(Target* t) {}
+
 	// TODO: virtual void Write(Source* s, const GSVector4i& r) = 0;
 	// TODO: virtual void Write(Target* t, const GSVector4i& r) = 0;
 
@@ -243,6 +274,7 @@ public:
 	void InvalidateLocalMem(GSOffset* off, const GSVector4i& r);
 
 	void IncAge();
+	void PrefetchReadbacks(Target* rt, Target* ds);
 	bool UserHacks_HalfPixelOffset;
 	void ScaleTexture(GSTexture* texture);
 
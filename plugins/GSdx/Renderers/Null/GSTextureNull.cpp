@@ -33,4 +33,9 @@ GSTextureNull::GSTextureNull(int type, int w, int h, int format)
 	m_desc.w = w;
 	m_desc.h = h;
 	m_desc.format = format;
+
+	// GSDevice::FetchSurface matches pooled textures on these
+	m_size = GSVector2i(w, h);
+	m_type = type;
+	m_format = format;
 }
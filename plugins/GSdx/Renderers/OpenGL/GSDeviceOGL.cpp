@@ -146,6 +146,7 @@ GSDeviceOGL::~GSDeviceOGL()
 	for (uint32 key = 0; key < countof(m_om_dss); key++) delete m_om_dss[key];
 
 	PboPool::Destroy();
+	ReadbackPool::Destroy();
 
 	// Must be done after the destruction of all shader/program objects
 	delete m_shader;
@@ -527,6 +528,7 @@ bool GSDeviceOGL::Create(const std::shared_ptr<GSWnd> &wnd)
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 		PboPool::Init();
+		ReadbackPool::Init();
 	}
 
 	// ****************************************************************
@@ -28,11 +28,8 @@ GSTextureCacheOGL::GSTextureCacheOGL(GSRenderer* r)
 {
 }
 
-void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
+GSTexture* GSTextureCacheOGL::CopyTarget(Target* t, const GSVector4i& r)
 {
-	if (!t->m_dirty.empty() || r.width() == 0 || r.height() == 0)
-		return;
-
 	const GIFRegTEX0& TEX0 = t->m_TEX0;
 
 	GLuint fmt;
@@ -64,9 +61,50 @@ void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
 			break;
 
 		default:
-			return;
+			return NULL;
+	}
+
+	GSVector4 src = GSVector4(r) * GSVector4(t->m_texture->GetScale()).xyxy() / GSVector4(t->m_texture->GetSize()).xyxy();
+
+	return m_renderer->m_dev->CopyOffscreen(t->m_texture, src, r.width(), r.height(), fmt, ps_shader);
+}
+
+void GSTextureCacheOGL::WriteTarget(Target* t, const GSVector4i& r, uint8* bits, int pitch)
+{
+	// TODO: block level write
+
+	const GIFRegTEX0& TEX0 = t->m_TEX0;
+
+	GSOffset* off = m_renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
+
+	switch(TEX0.PSM)
+	{
+		case PSM_PSMCT32:
+		case PSM_PSMZ32:
+			m_renderer->m_mem.WritePixel32(bits, pitch, off, r);
+			break;
+		case PSM_PSMCT24:
+		case PSM_PSMZ24:
+			m_renderer->m_mem.WritePixel24(bits, pitch, off, r);
+			break;
+		case PSM_PSMCT16:
+		case PSM_PSMCT16S:
+		case PSM_PSMZ16:
+		case PSM_PSMZ16S:
+			m_renderer->m_mem.WritePixel16(bits, pitch, off, r);
+			break;
+
+		default:
+			ASSERT(0);
 	}
+}
+
+void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
+{
+	if (!t->m_dirty.empty() || r.width() == 0 || r.height() == 0)
+		return;
 
+	const GIFRegTEX0& TEX0 = t->m_TEX0;
 
 	// Yes lots of logging, but I'm not confident with this code
 	GL_PUSH("Texture Cache Read. Format(0x%x)", TEX0.PSM);
@@ -74,39 +112,41 @@ void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
 	GL_PERF("TC: Read Back Target: %d (0x%x)[fmt: 0x%x]. Size %dx%d",
 			t->m_texture->GetID(), TEX0.TBP0, TEX0.PSM, r.width(), r.height());
 
-	GSVector4 src = GSVector4(r) * GSVector4(t->m_texture->GetScale()).xyxy() / GSVector4(t->m_texture->GetSize()).xyxy();
+	auto start = std::chrono::steady_clock::now();
+
+	bool async = t->m_readback
+		&& t->m_readback_src == t->m_texture
+		&& t->m_readback_psm == TEX0.PSM
+		&& t->m_readback_rect.rintersect(r).eq(r);
 
-	if(GSTexture* offscreen = m_renderer->m_dev->CopyOffscreen(t->m_texture, src, r.width(), r.height(), fmt, ps_shader))
+	if (async)
 	{
 		GSTexture::GSMap m;
-		GSVector4i r_offscreen(0, 0, r.width(), r.height());
+		const GSVector4i& rr = t->m_readback_rect;
+		GSVector4i r_offscreen(0, 0, rr.width(), rr.height());
 
-		if(offscreen->Map(m, &r_offscreen))
+		if(t->m_readback->Map(m, &r_offscreen))
 		{
-			// TODO: block level write
+			int bpp = GSLocalMemory::m_psm[TEX0.PSM].trbpp == 16 ? 2 : 4;
 
-			GSOffset* off = m_renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
+			WriteTarget(t, r, m.bits + (r.top - rr.top) * m.pitch + (r.left - rr.left) * bpp, m.pitch);
+
+			t->m_readback->Unmap();
+		}
+
+		m_renderer->m_dev->Recycle(t->m_readback);
 
-			switch(TEX0.PSM)
-			{
-				case PSM_PSMCT32:
-				case PSM_PSMZ32:
-					m_renderer->m_mem.WritePixel32(m.bits, m.pitch, off, r);
-					break;
-				case PSM_PSMCT24:
-				case PSM_PSMZ24:
-					m_renderer->m_mem.WritePixel24(m.bits, m.pitch, off, r);
-					break;
-				case PSM_PSMCT16:
-				case PSM_PSMCT16S:
-				case PSM_PSMZ16:
-				case PSM_PSMZ16S:
-					m_renderer->m_mem.WritePixel16(m.bits, m.pitch, off, r);
-					break;
-
-				default:
-					ASSERT(0);
-			}
+		t->m_readback = NULL;
+		t->m_readback_src = NULL;
+	}
+	else if(GSTexture* offscreen = CopyTarget(t, r))
+	{
+		GSTexture::GSMap m;
+		GSVector4i r_offscreen(0, 0, r.width(), r.height());
+
+		if(offscreen->Map(m, &r_offscreen))
+		{
+			WriteTarget(t, r, m.bits, m.pitch);
 
 			offscreen->Unmap();
 		}
@@ -114,6 +154,46 @@ void GSTextureCacheOGL::Read(Target* t, const GSVector4i& r)
 		// FIXME invalidate data
 		m_renderer->m_dev->Recycle(offscreen);
 	}
+	else
+	{
+		return;
+	}
+
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	m_renderer->m_perfmon.Put(async ? GSPerfMon::ReadbackAsync : GSPerfMon::Readback, 1);
+	m_renderer->m_perfmon.Put(async ? GSPerfMon::ReadbackAsyncStall : GSPerfMon::ReadbackStall, ms);
+
+	// Expect the same area to be read back again once the target is drawn again
+	t->m_readback_want = t->m_readback_wanted ? t->m_readback_want.runion(r) : r;
+	t->m_readback_wanted = true;
+	t->m_readback_stale = false;
+}
+
+void GSTextureCacheOGL::PrefetchReadback(Target* t)
+{
+	GSVector4i r = t->m_readback_want.rintersect(t->m_valid);
+
+	if (r.rempty())
+		return;
+
+	if(GSTexture* offscreen = CopyTarget(t, r))
+	{
+		if(!offscreen->ReadbackAsync(GSVector4i(0, 0, r.width(), r.height())))
+		{
+			m_renderer->m_dev->Recycle(offscreen);
+
+			return;
+		}
+
+		GL_PERF("TC: Prefetch Read Back Target: %d (0x%x)[fmt: 0x%x]. Size %dx%d",
+				t->m_texture->GetID(), t->m_TEX0.TBP0, t->m_TEX0.PSM, r.width(), r.height());
+
+		t->m_readback = offscreen;
+		t->m_readback_src = t->m_texture;
+		t->m_readback_rect = r;
+		t->m_readback_psm = t->m_TEX0.PSM;
+	}
 }
 
 void GSTextureCacheOGL::Read(Source* t, const GSVector4i& r)
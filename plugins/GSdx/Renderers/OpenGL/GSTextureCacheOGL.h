@@ -30,9 +30,14 @@ class GSTextureCacheOGL final : public GSTextureCache
 protected:
 	int Get8bitFormat() { return GL_R8;}
 
+	GSTexture* CopyTarget(Target* t, const GSVector4i& r);
+	void WriteTarget(Target* t, const GSVector4i& r, uint8* bits, int pitch);
+
 	void Read(Target* t, const GSVector4i& r);
 	void Read(Source* t, const GSVector4i& r);
 
+	void PrefetchReadback(Target* t);
+
 public:
 	GSTextureCacheOGL(GSRenderer* r);
 };
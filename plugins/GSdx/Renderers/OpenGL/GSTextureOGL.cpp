@@ -152,8 +152,115 @@ namespace PboPool {
 	}
 }
 
+// Readbacks land in a persistently mapped ring, each one protected by its own fence.
+// Nothing waits for the ring to be free: when a segment is reused its generation is
+// bumped, and a readback whose data was overwritten before being consumed is done again
+// synchronously.
+namespace ReadbackPool {
+
+	void Ring::Reset() {
+		m_offset = 0;
+
+		for (size_t i = 0; i < countof(m_generation); i++) {
+			m_generation[i] = 0;
+		}
+	}
+
+	uptr Ring::Alloc(uint32 size, uint32& generation) {
+		uint32 segment = m_offset / m_seg_size;
+
+		// A readback never straddles two segments, move to the next one if it doesn't fit
+		if (m_offset % m_seg_size + size > m_seg_size) {
+			segment++;
+			m_offset = m_seg_size * segment;
+		}
+
+		// m_offset reaches the end of the ring when the last segment is filled exactly
+		if (segment >= countof(m_generation)) {
+			segment  = 0;
+			m_offset = 0;
+		}
+
+		// Every readback which starts a segment invalidates the previous content of that
+		// segment, including when the previous readback ended exactly on its boundary
+		if (m_offset % m_seg_size == 0) {
+			m_generation[segment]++;
+		}
+
+		uptr offset = m_offset;
+		generation  = m_generation[segment];
+
+		m_offset += size;
+
+		return offset;
+	}
+
+	bool Ring::IsValid(uptr offset, uint32 generation) const {
+		return m_generation[offset / m_seg_size] == generation;
+	}
+
+	GLuint m_buffer;
+	char*  m_map;
+	Ring   m_ring;
+
+	const GLbitfield common_flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const GLbitfield create_flags = common_flags | GL_CLIENT_STORAGE_BIT;
+
+	void Init() {
+		glGenBuffers(1, &m_buffer);
+
+		BindPbo();
+
+		glObjectLabel(GL_BUFFER, m_buffer, -1, "Readback PBO");
+
+		glBufferStorage(GL_PIXEL_PACK_BUFFER, Ring::m_pbo_size, NULL, create_flags);
+		m_map = (char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, Ring::m_pbo_size, common_flags);
+
+		m_ring.Reset();
+
+		UnbindPbo();
+	}
+
+	void Destroy() {
+		m_map = NULL;
+
+		m_ring.Reset();
+
+		glDeleteBuffers(1, &m_buffer);
+	}
+
+	void BindPbo() {
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+	}
+
+	void UnbindPbo() {
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	bool Alloc(uint32 size, uptr& offset, uint32& generation) {
+		// Note: keep offset aligned for SSE/AVX
+		size = (size + 63) & ~0x3F;
+
+		if (m_map == NULL || size > Ring::m_seg_size)
+			return false;
+
+		offset = m_ring.Alloc(size, generation);
+
+		return true;
+	}
+
+	bool IsValid(uptr offset, uint32 generation) {
+		return m_ring.IsValid(offset, generation);
+	}
+
+	char* Ptr(uptr offset) {
+		return m_map + offset;
+	}
+}
+
 GSTextureOGL::GSTextureOGL(int type, int w, int h, int format, GLuint fbo_read, bool mipmap)
 	: m_clean(false), m_generate_mipmap(true), m_local_buffer(nullptr), m_r_x(0), m_r_y(0), m_r_w(0), m_r_h(0), m_layer(0)
+	, m_rb_fence(0), m_rb_offset(0), m_rb_generation(0), m_rb_x(0), m_rb_y(0), m_rb_w(0), m_rb_h(0)
 {
 	// OpenGL didn't like dimensions of size 0
 	m_size.x = std::max(1,w);
@@ -328,6 +435,8 @@ GSTextureOGL::GSTextureOGL(int type, int w, int h, int format, GLuint fbo_read,
 
 GSTextureOGL::~GSTextureOGL()
 {
+	ReadbackCancel();
+
 	/* Unbind the texture from our local state */
 
 	if (m_texture_id == GLState::rt)
@@ -441,8 +550,26 @@ bool GSTextureOGL::Map(GSMap& m, const GSVector4i* _r, int layer)
 	m.pitch = row_byte;
 
 	if (m_type == GSTexture::Offscreen) {
-		// The fastest way will be to use a PBO to read the data asynchronously. Unfortunately GSdx
-		// architecture is waiting the data right now.
+		if (m_rb_fence) {
+			bool same_rect = r.x == m_rb_x && r.y == m_rb_y && r.width() == m_rb_w && r.height() == m_rb_h;
+
+			if (same_rect) {
+				glClientWaitSync(m_rb_fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			}
+
+			glDeleteSync(m_rb_fence);
+			m_rb_fence = 0;
+
+			if (same_rect && ReadbackPool::IsValid(m_rb_offset, m_rb_generation)) {
+				m.bits = (uint8*)ReadbackPool::Ptr(m_rb_offset);
+
+				return true;
+			}
+
+			GL_PERF("Readback of texture %d was lost, reading it again", m_texture_id);
+		}
+
+		// Synchronous readback, when nobody asked for the data in advance (see ReadbackAsync)
 
 #if 0
 		// Maybe it is as good as the code below. I don't know
@@ -512,6 +639,52 @@ void GSTextureOGL::Unmap()
 	}
 }
 
+bool GSTextureOGL::ReadbackAsync(const GSVector4i& r)
+{
+	if (m_type != GSTexture::Offscreen)
+		return false;
+
+	ReadbackCancel();
+
+	uint32 size = r.height() * (r.width() << m_int_shift);
+
+	if (!ReadbackPool::Alloc(size, m_rb_offset, m_rb_generation))
+		return false;
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo_read);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture_id, 0);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1u << m_int_shift);
+
+	ReadbackPool::BindPbo();
+
+	glReadPixels(r.x, r.y, r.width(), r.height(), m_int_format, m_int_type, (void*)m_rb_offset);
+
+	ReadbackPool::UnbindPbo();
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+	m_rb_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	// Get the copy going, the point is to have it done by the time Map() is called
+	glFlush();
+
+	m_rb_x = r.x;
+	m_rb_y = r.y;
+	m_rb_w = r.width();
+	m_rb_h = r.height();
+
+	return true;
+}
+
+void GSTextureOGL::ReadbackCancel()
+{
+	if (m_rb_fence) {
+		glDeleteSync(m_rb_fence);
+		m_rb_fence = 0;
+	}
+}
+
 void GSTextureOGL::GenerateMipmap()
 {
 	if (m_generate_mipmap && m_max_layer > 1) {
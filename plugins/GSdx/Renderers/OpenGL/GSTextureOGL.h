@@ -37,6 +37,34 @@ namespace PboPool {
 	void Destroy();
 }
 
+namespace ReadbackPool {
+	// Placement of the readbacks in the ring, kept apart from the GL buffer so that it can
+	// be checked without a GL context (GSSelfTest).
+	class Ring {
+	public:
+		static const uint32 m_pbo_size = 32*1024*1024;
+		static const uint32 m_seg_size = 8*1024*1024;
+
+		void  Reset();
+		uptr  Alloc(uint32 size, uint32& generation); // size <= m_seg_size
+		bool  IsValid(uptr offset, uint32 generation) const;
+
+	private:
+		uptr   m_offset;
+		uint32 m_generation[m_pbo_size/m_seg_size];
+	};
+
+	inline void BindPbo();
+	inline void UnbindPbo();
+
+	bool  Alloc(uint32 size, uptr& offset, uint32& generation);
+	bool  IsValid(uptr offset, uint32 generation);
+	char* Ptr(uptr offset);
+
+	void Init();
+	void Destroy();
+}
+
 class GSTextureOGL final : public GSTexture
 {
 	private:
@@ -55,6 +83,15 @@ class GSTextureOGL final : public GSTexture
 		int m_layer;
 		int m_max_layer;
 
+		// Pending asynchronous readback (Offscreen)
+		GLsync m_rb_fence;
+		uptr m_rb_offset;
+		uint32 m_rb_generation;
+		int m_rb_x;
+		int m_rb_y;
+		int m_rb_w;
+		int m_rb_h;
+
 		// internal opengl format/type/alignment
 		GLenum m_int_format;
 		GLenum m_int_type;
@@ -72,6 +109,8 @@ class GSTextureOGL final : public GSTexture
 		void Unmap() final;
 		void GenerateMipmap() final;
 		bool Save(const std::string& fn) final;
+		bool ReadbackAsync(const GSVector4i& r) final;
+		void ReadbackCancel() final;
 
 		bool IsBackbuffer() { return (m_type == GSTexture::Backbuffer); }
 		bool IsDss() { return (m_type == GSTexture::DepthStencil || m_type == GSTexture::SparseDepthStencil); }
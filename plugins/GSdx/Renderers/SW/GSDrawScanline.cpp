@@ -114,6 +114,31 @@ void GSDrawScanline::EndDraw(uint64 frame, uint64 ticks, int actual, int total)
 	m_ds_map.UpdateStats(frame, ticks, actual, total);
 }
 
+void GSDrawScanline::GetSelectors(std::vector<uint64>& ds, std::vector<uint64>& sp)
+{
+	m_ds_map.GetKeys(ds);
+	m_sp_map.GetKeys(sp);
+}
+
+void GSDrawScanline::PrepareSelector(uint64 key, bool setup)
+{
+	if(setup)
+		m_sp_map.Prepare(key);
+	else
+		m_ds_map.Prepare(key);
+}
+
+IDrawScanline::CodeStats GSDrawScanline::GetCodeStats()
+{
+	CodeStats cs;
+
+	cs.generated = m_ds_map.m_stats.generated + m_sp_map.m_stats.generated;
+	cs.prepared = m_ds_map.m_stats.prepared + m_sp_map.m_stats.prepared;
+	cs.stall_avoided = m_ds_map.m_stats.stall_avoided + m_sp_map.m_stats.stall_avoided;
+
+	return cs;
+}
+
 #ifndef ENABLE_JIT_RASTERIZER
 
 void GSDrawScanline::SetupPrim(const GSVertexSW* vertex, const uint32* index, const GSVertexSW& dscan)
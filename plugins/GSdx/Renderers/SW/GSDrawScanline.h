@@ -87,4 +87,8 @@ public:
 #endif
 
 	void PrintStats() {m_ds_map.PrintStats();}
+
+	void GetSelectors(std::vector<uint64>& ds, std::vector<uint64>& sp);
+	void PrepareSelector(uint64 key, bool setup);
+	CodeStats GetCodeStats();
 };
@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include "GSDrawScanlineCodeGenerator.h"
+#include "GSdx.h"
 
 #if _M_SSE >= 0x501
 #else
@@ -37,6 +38,7 @@ GSDrawScanlineCodeGenerator::GSDrawScanlineCodeGenerator(void* param, uint64 key
 	: GSCodeGenerator(code, maxsize)
 	, m_local(*(GSScanlineLocalData*)param)
 	, m_rip(false)
+	, m_avx512vl(GSUtil::HasAVX512VL() && theApp.GetConfigB("sw_avx512vl"))
 {
 	m_sel.key = key;
 
@@ -188,7 +190,13 @@ void GSDrawScanlineCodeGenerator::alltrue(const Xmm& test)
 
 void GSDrawScanlineCodeGenerator::blend(const Xmm& a, const Xmm& b, const Xmm& mask)
 {
-	if(m_cpu.has(util::Cpu::tAVX))
+	if(m_avx512vl)
+	{
+		// a = (a & ~mask) | (b & mask)
+
+		vpternlogd(a, b, mask, 0xd8);
+	}
+	else if(m_cpu.has(util::Cpu::tAVX))
 	{
 		vpand(b, mask);
 		vpandn(mask, a);
@@ -205,7 +213,13 @@ void GSDrawScanlineCodeGenerator::blend(const Xmm& a, const Xmm& b, const Xmm& m
 
 void GSDrawScanlineCodeGenerator::blendr(const Xmm& b, const Xmm& a, const Xmm& mask)
 {
-	if(m_cpu.has(util::Cpu::tAVX))
+	if(m_avx512vl)
+	{
+		// b = (b & mask) | (a & ~mask)
+
+		vpternlogd(b, a, mask, 0xe4);
+	}
+	else if(m_cpu.has(util::Cpu::tAVX))
 	{
 		vpand(b, mask);
 		vpandn(mask, a);
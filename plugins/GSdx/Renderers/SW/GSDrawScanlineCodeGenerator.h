@@ -40,6 +40,7 @@ class GSDrawScanlineCodeGenerator : public GSCodeGenerator
 	GSScanlineSelector m_sel;
 	GSScanlineLocalData& m_local;
 	bool m_rip;
+	bool m_avx512vl; // AVX-512VL forms (mask registers, ternary logic) in the AVX2 generator
 
 	void Generate();
 
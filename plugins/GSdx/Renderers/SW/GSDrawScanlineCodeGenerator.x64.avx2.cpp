@@ -758,6 +758,30 @@ void GSDrawScanlineCodeGenerator::TestZ(const Ymm& temp1, const Ymm& temp2)
 			vpsrld(ymm1, (uint8)(m_sel.zpsm * 8));
 		}
 
+		if(m_avx512vl)
+		{
+			// AVX-512VL compares unsigned, straight into a mask register
+
+			switch(m_sel.ztst)
+			{
+			case ZTST_GEQUAL:
+				// test |= zs < zd;
+				vpcmpud(k1, ymm0, ymm1, 1); // LT
+				vpternlogd(ymm7 | k1, ymm7, ymm7, 0xff);
+				break;
+
+			case ZTST_GREATER:
+				// test |= zs <= zd;
+				vpcmpud(k1, ymm0, ymm1, 2); // LE
+				vpternlogd(ymm7 | k1, ymm7, ymm7, 0xff);
+				break;
+			}
+
+			alltrue(ymm7);
+
+			return;
+		}
+
 		if(m_sel.zoverflow || m_sel.zpsm == 0)
 		{
 			// GSVector8i o = GSVector8i::x80000000();
@@ -2190,9 +2214,17 @@ void GSDrawScanlineCodeGenerator::TestAlpha()
 		// t = (ga >> 16) != m_local.gd->aref;
 		vpsrld(ymm1, ymm6, 16);
 		vbroadcasti128(ymm0, ptr[&m_local.gd->aref]);
-		vpcmpeqd(ymm1, ymm0);
-		vpcmpeqd(ymm0, ymm0);
-		vpxor(ymm1, ymm0);
+		if(m_avx512vl)
+		{
+			vpcmpd(k1, ymm1, ymm0, 4); // NE
+			vpternlogd(ymm1 | k1 | T_z, ymm1, ymm1, 0xff);
+		}
+		else
+		{
+			vpcmpeqd(ymm1, ymm0);
+			vpcmpeqd(ymm0, ymm0);
+			vpxor(ymm1, ymm0);
+		}
 		break;
 
 	case ATST_GEQUAL:
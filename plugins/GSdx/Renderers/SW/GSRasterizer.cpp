@@ -131,11 +131,21 @@ int GSRasterizer::GetPixels(bool reset)
 	return pixels;
 }
 
+void GSRasterizer::OwnAllScanlines()
+{
+	memset(m_scanline, 1, (2048 >> m_thread_height) + 16);
+}
+
 void GSRasterizer::Draw(GSRasterizerData* data)
+{
+	Draw(data, data->scissor, data->index, data->index_count);
+}
+
+void GSRasterizer::Draw(GSRasterizerData* data, const GSVector4i& clip, const uint32* index, int index_count)
 {
 	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
 
-	if(data->vertex != NULL && data->vertex_count == 0 || data->index != NULL && data->index_count == 0) return;
+	if(data->vertex != NULL && data->vertex_count == 0 || index != NULL && index_count == 0) return;
 
 	m_pixels.actual = 0;
 	m_pixels.total = 0;
@@ -147,16 +157,17 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 	const GSVertexSW* vertex = data->vertex;
 	const GSVertexSW* vertex_end = data->vertex + data->vertex_count;
 
-	const uint32* index = data->index;
-	const uint32* index_end = data->index + data->index_count;
+	const uint32* index_end = index + index_count;
 
 	uint32 tmp_index[] = {0, 1, 2};
 
-	bool scissor_test = !data->bbox.eq(data->bbox.rintersect(data->scissor));
+	GSVector4i scissor = data->scissor.rintersect(clip);
+
+	bool scissor_test = !data->bbox.eq(data->bbox.rintersect(scissor));
 
-	m_scissor = data->scissor;
-	m_fscissor_x = GSVector4(data->scissor).xzxz();
-	m_fscissor_y = GSVector4(data->scissor).ywyw();
+	m_scissor = scissor;
+	m_fscissor_x = GSVector4(scissor).xzxz();
+	m_fscissor_y = GSVector4(scissor).ywyw();
 
 	switch(data->primclass)
 	{
@@ -164,11 +175,11 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 
 		if(scissor_test)
 		{
-			DrawPoint<true>(vertex, data->vertex_count, index, data->index_count);
+			DrawPoint<true>(vertex, data->vertex_count, index, index_count);
 		}
 		else
 		{
-			DrawPoint<false>(vertex, data->vertex_count, index, data->index_count);
+			DrawPoint<false>(vertex, data->vertex_count, index, index_count);
 		}
 
 		break;
@@ -1213,3 +1224,366 @@ int GSRasterizerList::GetPixels(bool reset)
 
 	return pixels;
 }
+
+//
+
+GSRasterizerTileList::GSRasterizerTileList(int threads, GSPerfMon* perfmon)
+	: m_perfmon(perfmon)
+	, m_tiles(new Tile[TILE_COUNT * TILE_COUNT])
+	, m_pending(0)
+	, m_ready(0)
+	, m_exit(false)
+{
+	for(int i = 0; i < TILE_COUNT * TILE_COUNT; i++)
+	{
+		m_tiles[i].scheduled = false;
+	}
+}
+
+GSRasterizerTileList::~GSRasterizerTileList()
+{
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+		m_exit = true;
+	}
+
+	m_notempty.notify_all();
+
+	for(auto& w : m_workers)
+	{
+		w->thread.join();
+	}
+}
+
+void GSRasterizerTileList::Start()
+{
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		m_workers.push_back(std::unique_ptr<Worker>(new Worker()));
+	}
+
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		m_workers[i]->thread = std::thread(&GSRasterizerTileList::ThreadProc, this, (int)i);
+	}
+}
+
+void GSRasterizerTileList::Queue(const std::shared_ptr<GSRasterizerData>& data)
+{
+	GSVector4i r = data->bbox.rintersect(data->scissor);
+
+	if(r.rempty()) return;
+
+	ASSERT(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
+
+	int left = r.left >> TILE_SHIFT;
+	int top = r.top >> TILE_SHIFT;
+	int right = (r.right - 1) >> TILE_SHIFT;
+	int bottom = (r.bottom - 1) >> TILE_SHIFT;
+	int pitch = right - left + 1;
+	int count = pitch * (bottom - top + 1);
+
+	if(count == 1 || data->index == NULL)
+	{
+		// nothing to bin, the scissor of each tile does the clipping
+
+		for(int y = top; y <= bottom; y++)
+		{
+			for(int x = left; x <= right; x++)
+			{
+				Push(y * TILE_COUNT + x, Job{data, nullptr, 0, 0});
+			}
+		}
+
+		return;
+	}
+
+	int n = 0;
+
+	switch(data->primclass)
+	{
+	case GS_POINT_CLASS: n = 1; break;
+	case GS_LINE_CLASS: n = 2; break;
+	case GS_TRIANGLE_CLASS: n = 3; break;
+	case GS_SPRITE_CLASS: n = 2; break;
+	default: __assume(0);
+	}
+
+	// 1st pass: tile range of each primitive (1 pixel margin for the edges)
+
+	int prims = data->index_count / n;
+
+	std::vector<GSVector4i> range(prims);
+
+	m_bin_count.assign(count, 0);
+
+	const GSVertexSW* RESTRICT vertex = data->vertex;
+	const uint32* RESTRICT index = data->index;
+
+	for(int i = 0; i < prims; i++, index += n)
+	{
+		GSVector4 pmin = vertex[index[0]].p;
+		GSVector4 pmax = pmin;
+
+		for(int j = 1; j < n; j++)
+		{
+			pmin = pmin.min(vertex[index[j]].p);
+			pmax = pmax.max(vertex[index[j]].p);
+		}
+
+		GSVector4i b = GSVector4i(pmin.xyxy(pmax).floor()).add32(GSVector4i(-1, -1, 1, 1)).rintersect(r);
+
+		if(b.rempty())
+		{
+			range[i] = GSVector4i::zero();
+
+			continue;
+		}
+
+		b = GSVector4i(b.left >> TILE_SHIFT, b.top >> TILE_SHIFT, (b.right - 1) >> TILE_SHIFT, (b.bottom - 1) >> TILE_SHIFT) - GSVector4i(left, top, left - 1, top - 1);
+
+		range[i] = b;
+
+		for(int y = b.top; y < b.bottom; y++)
+		{
+			for(int x = b.left; x < b.right; x++)
+			{
+				m_bin_count[y * pitch + x] += n;
+			}
+		}
+	}
+
+	// 2nd pass: copy the indices of each tile next to each other
+
+	std::vector<uint32> offset(count + 1);
+
+	offset[0] = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		offset[i + 1] = offset[i] + m_bin_count[i];
+	}
+
+	std::shared_ptr<std::vector<uint32>> bins = std::make_shared<std::vector<uint32>>(offset[count]);
+
+	uint32* RESTRICT dst = bins->data();
+
+	m_bin_count.assign(count, 0);
+
+	index = data->index;
+
+	for(int i = 0; i < prims; i++, index += n)
+	{
+		const GSVector4i& b = range[i];
+
+		for(int y = b.top; y < b.bottom; y++)
+		{
+			for(int x = b.left; x < b.right; x++)
+			{
+				int tile = y * pitch + x;
+
+				uint32* RESTRICT p = &dst[offset[tile] + m_bin_count[tile]];
+
+				for(int j = 0; j < n; j++)
+				{
+					p[j] = index[j];
+				}
+
+				m_bin_count[tile] += n;
+			}
+		}
+	}
+
+	for(int i = 0; i < count; i++)
+	{
+		if(m_bin_count[i] > 0)
+		{
+			int tile = (top + i / pitch) * TILE_COUNT + left + i % pitch;
+
+			Push(tile, Job{data, bins, offset[i], m_bin_count[i]});
+		}
+	}
+}
+
+void GSRasterizerTileList::Push(int tile, Job&& job)
+{
+	Tile& t = m_tiles[tile];
+
+	m_pending++;
+
+	bool schedule;
+
+	{
+		std::lock_guard<std::mutex> l(t.lock);
+
+		t.jobs.push_back(std::move(job));
+
+		schedule = !t.scheduled;
+
+		t.scheduled = true;
+	}
+
+	if(schedule)
+	{
+		// neighbouring tiles go to the same worker, it keeps the pages of the frame/depth buffer hot
+
+		Worker& w = *m_workers[((tile / TILE_COUNT) / 2 * (TILE_COUNT / 2) + (tile % TILE_COUNT) / 2) % m_workers.size()];
+
+		{
+			std::lock_guard<std::mutex> l(w.lock);
+
+			w.tiles.push_back(tile);
+		}
+
+		m_ready++;
+
+		{
+			std::lock_guard<std::mutex> l(m_lock);
+		}
+
+		m_notempty.notify_all();
+	}
+}
+
+bool GSRasterizerTileList::Pop(int id, int& tile)
+{
+	// own queue first (oldest), then steal from the others (newest)
+
+	for(size_t i = 0; i < m_workers.size(); i++)
+	{
+		Worker& w = *m_workers[(id + i) % m_workers.size()];
+
+		std::lock_guard<std::mutex> l(w.lock);
+
+		if(!w.tiles.empty())
+		{
+			if(i == 0)
+			{
+				tile = w.tiles.front();
+				w.tiles.pop_front();
+			}
+			else
+			{
+				tile = w.tiles.back();
+				w.tiles.pop_back();
+			}
+
+			m_ready--;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void GSRasterizerTileList::ThreadProc(int id)
+{
+	GSSetThreadName(("GSdx raster " + std::to_string(id)).c_str());
+
+	GSRasterizer* r = m_r[id].get();
+
+	while(true)
+	{
+		int tile;
+
+		if(!Pop(id, tile))
+		{
+			std::unique_lock<std::mutex> l(m_lock);
+
+			while(m_ready == 0 && !m_exit)
+			{
+				m_notempty.wait(l);
+			}
+
+			if(m_exit)
+			{
+				return;
+			}
+
+			continue;
+		}
+
+		Tile& t = m_tiles[tile];
+
+		int x = (tile % TILE_COUNT) << TILE_SHIFT;
+		int y = (tile / TILE_COUNT) << TILE_SHIFT;
+
+		GSVector4i clip(x, y, x + TILE_SIZE, y + TILE_SIZE);
+
+		while(true)
+		{
+			Job job;
+
+			{
+				std::lock_guard<std::mutex> l(t.lock);
+
+				if(t.jobs.empty())
+				{
+					t.scheduled = false;
+
+					break;
+				}
+
+				job = std::move(t.jobs.front());
+
+				t.jobs.pop_front();
+			}
+
+			GSRasterizerData* data = job.data.get();
+
+			if(job.index)
+			{
+				r->Draw(data, clip, job.index->data() + job.offset, job.count);
+			}
+			else
+			{
+				r->Draw(data, clip, data->index, data->index_count);
+			}
+
+			job.data.reset();
+			job.index.reset();
+
+			if(--m_pending == 0)
+			{
+				{
+					std::lock_guard<std::mutex> l(m_lock);
+				}
+
+				m_empty.notify_all();
+			}
+		}
+	}
+}
+
+void GSRasterizerTileList::Sync()
+{
+	if(!IsSynced())
+	{
+		std::unique_lock<std::mutex> l(m_lock);
+
+		while(m_pending != 0)
+		{
+			m_empty.wait(l);
+		}
+
+		m_perfmon->Put(GSPerfMon::SyncPoint, 1);
+	}
+}
+
+bool GSRasterizerTileList::IsSynced() const
+{
+	return m_pending == 0;
+}
+
+int GSRasterizerTileList::GetPixels(bool reset)
+{
+	int pixels = 0;
+
+	for(size_t i = 0; i < m_r.size(); i++)
+	{
+		pixels += m_r[i]->GetPixels(reset);
+	}
+
+	return pixels;
+}
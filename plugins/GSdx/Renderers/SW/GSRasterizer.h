@@ -106,6 +106,14 @@ public:
 
 	virtual void PrintStats() = 0;
 
+	// JIT code cache, keys are GSScanlineSelector values (setup = GSSetupPrim keys)
+
+	struct CodeStats {int generated, prepared, stall_avoided;};
+
+	virtual void GetSelectors(std::vector<uint64>& ds, std::vector<uint64>& sp) {}
+	virtual void PrepareSelector(uint64 key, bool setup) {}
+	virtual CodeStats GetCodeStats() {CodeStats cs = {0, 0, 0}; return cs;}
+
 	__forceinline bool HasEdge() const {return m_de != NULL;}
 	__forceinline bool IsSolidRect() const {return m_dr != NULL;}
 };
@@ -120,6 +128,7 @@ public:
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
 	virtual void PrintStats() = 0;
+	virtual void GetDrawScanlines(std::vector<IDrawScanline*>& ds) = 0;
 };
 
 class alignas(32) GSRasterizer : public IRasterizer
@@ -168,6 +177,8 @@ public:
 	__forceinline int FindMyNextScanline(int top) const;
 
 	void Draw(GSRasterizerData* data);
+	void Draw(GSRasterizerData* data, const GSVector4i& clip, const uint32* index, int index_count);
+	void OwnAllScanlines();
 
 	// IRasterizer
 
@@ -176,6 +187,86 @@ public:
 	bool IsSynced() const {return true;}
 	int GetPixels(bool reset);
 	void PrintStats() {m_ds->PrintStats();}
+	void GetDrawScanlines(std::vector<IDrawScanline*>& ds) {ds.push_back(m_ds);}
+};
+
+// Alternative to the scanline bands of GSRasterizerList: the producer bins
+// the primitives of each draw into screen tiles, and the workers own a tile
+// at a time (draws of a tile are applied in order by one thread). Tiles have
+// a home worker for locality, idle workers steal from the others.
+
+class GSRasterizerTileList : public IRasterizer
+{
+	enum {TILE_SHIFT = 6, TILE_SIZE = 1 << TILE_SHIFT, TILE_COUNT = 2048 >> TILE_SHIFT};
+
+	struct Job
+	{
+		std::shared_ptr<GSRasterizerData> data;
+		std::shared_ptr<std::vector<uint32>> index; // NULL: use the whole draw
+		uint32 offset;
+		uint32 count;
+	};
+
+	struct Tile
+	{
+		std::mutex lock;
+		std::deque<Job> jobs;
+		bool scheduled; // sitting in a worker queue or being drawn
+	};
+
+	struct Worker
+	{
+		std::mutex lock;
+		std::deque<int> tiles;
+		std::thread thread;
+	};
+
+	GSPerfMon* m_perfmon;
+	std::vector<std::unique_ptr<GSRasterizer>> m_r;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::unique_ptr<Tile[]> m_tiles;
+	std::vector<uint32> m_bin_count;
+
+	std::atomic<int> m_pending; // queued jobs
+	std::atomic<int> m_ready; // scheduled tiles not picked yet
+	bool m_exit;
+	std::mutex m_lock;
+	std::condition_variable m_notempty;
+	std::condition_variable m_empty;
+
+	GSRasterizerTileList(int threads, GSPerfMon* perfmon);
+
+	void Start();
+	void Push(int tile, Job&& job);
+	bool Pop(int id, int& tile);
+	void ThreadProc(int id);
+
+public:
+	virtual ~GSRasterizerTileList();
+
+	template<class DS> static IRasterizer* Create(int threads, GSPerfMon* perfmon)
+	{
+		GSRasterizerTileList* rl = new GSRasterizerTileList(threads, perfmon);
+
+		for(int i = 0; i < threads; i++)
+		{
+			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon)));
+			rl->m_r[i]->OwnAllScanlines();
+		}
+
+		rl->Start();
+
+		return rl;
+	}
+
+	// IRasterizer
+
+	void Queue(const std::shared_ptr<GSRasterizerData>& data);
+	void Sync();
+	bool IsSynced() const;
+	int GetPixels(bool reset);
+	void PrintStats() {}
+	void GetDrawScanlines(std::vector<IDrawScanline*>& ds) {for(auto& r : m_r) r->GetDrawScanlines(ds);}
 };
 
 class GSRasterizerList : public IRasterizer
@@ -204,6 +295,11 @@ public:
 			return new GSRasterizer(new DS(), 0, 1, perfmon);
 		}
 
+		if(theApp.GetConfigB("extrathreads_binning"))
+		{
+			return GSRasterizerTileList::Create<DS>(threads, perfmon);
+		}
+
 		GSRasterizerList* rl = new GSRasterizerList(threads, perfmon);
 
 		for(int i = 0; i < threads; i++)
@@ -211,7 +307,8 @@ public:
 			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon)));
 			auto &r = *rl->m_r[i];
 			rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
-				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); })));
+				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); },
+				"GSdx raster " + std::to_string(i))));
 		}
 
 		return rl;
@@ -224,4 +321,5 @@ public:
 	bool IsSynced() const;
 	int GetPixels(bool reset);
 	void PrintStats() {}
+	void GetDrawScanlines(std::vector<IDrawScanline*>& ds) {for(auto& r : m_r) r->GetDrawScanlines(ds);}
 };
@@ -42,6 +42,7 @@ void GSRendererSW::InitVectors()
 
 GSRendererSW::GSRendererSW(int threads)
 	: m_fzb(NULL)
+	, m_jit_exit(false)
 {
 	m_nativeres = true; // ignore ini, sw is always native
 
@@ -83,10 +84,18 @@ GSRendererSW::GSRendererSW(int threads)
 		m_userhacks_auto_flush = true;
 		ResetHandlers();
 	}
+
+	m_jit_cache = theApp.GetConfigB("sw_jit_cache");
 }
 
 GSRendererSW::~GSRendererSW()
 {
+	if(m_jit_cache)
+	{
+		StopCodeCache();
+		SaveCodeCache();
+	}
+
 	delete m_tc;
 
 	for(size_t i = 0; i < countof(m_texture); i++)
@@ -99,6 +108,150 @@ GSRendererSW::~GSRendererSW()
 	_aligned_free(m_output);
 }
 
+void GSRendererSW::SetGameCRC(uint32 crc, int options)
+{
+	if(m_jit_cache && crc != m_crc)
+	{
+		StopCodeCache();
+		SaveCodeCache();
+
+		GSRenderer::SetGameCRC(crc, options);
+
+		LoadCodeCache();
+	}
+	else
+	{
+		GSRenderer::SetGameCRC(crc, options);
+	}
+}
+
+// The SW JIT code cache only stores the selectors, the code itself depends on
+// the address of each GSDrawScanline instance and is regenerated every run.
+//
+// File format: magic, version, ds count, sp count, ds keys, sp keys
+
+static const uint32 s_jit_cache_magic = 0x54494a53; // SJIT
+static const uint32 s_jit_cache_version = 1;
+
+std::string GSRendererSW::GetCodeCachePath(uint32 crc)
+{
+	return theApp.GetConfigDir() + format("GSdx_swjit_%08X.bin", crc);
+}
+
+void GSRendererSW::LoadCodeCache()
+{
+	m_jit_ds.clear();
+	m_jit_sp.clear();
+
+	if(m_crc == 0)
+		return;
+
+	if(FILE* fp = fopen(GetCodeCachePath(m_crc).c_str(), "rb"))
+	{
+		uint32 header[4];
+
+		if(fread(header, sizeof(header), 1, fp) == 1 && header[0] == s_jit_cache_magic && header[1] == s_jit_cache_version && header[2] < 65536 && header[3] < 65536)
+		{
+			m_jit_ds.resize(header[2]);
+			m_jit_sp.resize(header[3]);
+
+			if(fread(m_jit_ds.data(), sizeof(uint64), m_jit_ds.size(), fp) != m_jit_ds.size() ||
+			   fread(m_jit_sp.data(), sizeof(uint64), m_jit_sp.size(), fp) != m_jit_sp.size())
+			{
+				m_jit_ds.clear();
+				m_jit_sp.clear();
+			}
+		}
+
+		fclose(fp);
+	}
+
+	if(m_jit_ds.empty() && m_jit_sp.empty())
+		return;
+
+	std::vector<IDrawScanline*> ds;
+	m_rl->GetDrawScanlines(ds);
+
+	m_jit_exit = false;
+
+	m_jit_thread = std::thread([this, ds]()
+	{
+		// Every rasterizer thread owns its own code, fill them in turn so the
+		// first ones are warm as soon as possible
+		for(IDrawScanline* d : ds)
+		{
+			for(uint64 key : m_jit_sp)
+			{
+				if(m_jit_exit) return;
+
+				d->PrepareSelector(key, true);
+			}
+
+			for(uint64 key : m_jit_ds)
+			{
+				if(m_jit_exit) return;
+
+				d->PrepareSelector(key, false);
+			}
+		}
+	});
+}
+
+void GSRendererSW::StopCodeCache()
+{
+	if(m_jit_thread.joinable())
+	{
+		m_jit_exit = true;
+		m_jit_thread.join();
+	}
+}
+
+void GSRendererSW::SaveCodeCache()
+{
+	if(m_crc == 0)
+		return;
+
+	std::vector<IDrawScanline*> ds;
+	m_rl->GetDrawScanlines(ds);
+
+	IDrawScanline::CodeStats cs = {0, 0, 0};
+
+	std::vector<uint64> ds_keys = m_jit_ds;
+	std::vector<uint64> sp_keys = m_jit_sp;
+
+	for(IDrawScanline* d : ds)
+	{
+		IDrawScanline::CodeStats s = d->GetCodeStats();
+
+		cs.generated += s.generated;
+		cs.prepared += s.prepared;
+		cs.stall_avoided += s.stall_avoided;
+
+		d->GetSelectors(ds_keys, sp_keys);
+	}
+
+	printf("GSdx: SW JIT cache %08X: %d prepared, %d stalls avoided, %d generated on demand\n", m_crc, cs.prepared, cs.stall_avoided, cs.generated);
+
+	std::sort(ds_keys.begin(), ds_keys.end());
+	ds_keys.erase(std::unique(ds_keys.begin(), ds_keys.end()), ds_keys.end());
+	std::sort(sp_keys.begin(), sp_keys.end());
+	sp_keys.erase(std::unique(sp_keys.begin(), sp_keys.end()), sp_keys.end());
+
+	if(ds_keys.size() == m_jit_ds.size() && sp_keys.size() == m_jit_sp.size())
+		return; // nothing new
+
+	if(FILE* fp = fopen(GetCodeCachePath(m_crc).c_str(), "wb"))
+	{
+		uint32 header[4] = {s_jit_cache_magic, s_jit_cache_version, (uint32)ds_keys.size(), (uint32)sp_keys.size()};
+
+		fwrite(header, sizeof(header), 1, fp);
+		fwrite(ds_keys.data(), sizeof(uint64), ds_keys.size(), fp);
+		fwrite(sp_keys.data(), sizeof(uint64), sp_keys.size(), fp);
+
+		fclose(fp);
+	}
+}
+
 void GSRendererSW::Reset()
 {
 	Sync(-1);
@@ -614,14 +767,14 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 
 	if(sd->global.sel.fwrite)
 	{
-		m_tc->InvalidatePages(sd->m_fb_pages, sd->m_fpsm);
+		m_mem.InvalidatePages(sd->m_fb_pages, sd->m_fpsm);
 
 		m_mem.m_clut.Invalidate(m_context->FRAME.Block());
 	}
 
 	if(sd->global.sel.zwrite)
 	{
-		m_tc->InvalidatePages(sd->m_zb_pages, sd->m_zpsm);
+		m_mem.InvalidatePages(sd->m_zb_pages, sd->m_zpsm);
 	}
 }
 
@@ -686,7 +839,7 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 		}
 	}
 
-	m_tc->InvalidatePages(m_tmp_pages, off->psm); // if texture update runs on a thread and Sync(5) happens then this must come later
+	// GSState bumped the versions of the pages, the texture cache picks them up on its next update
 }
 
 void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut)
@@ -79,6 +79,18 @@ protected:
 	std::atomic<uint16> m_tex_pages[512];
 	uint32 m_tmp_pages[512 + 1];
 
+	// JIT selectors recorded per game, generated ahead of time on m_jit_thread
+	bool m_jit_cache;
+	std::thread m_jit_thread;
+	std::atomic<bool> m_jit_exit;
+	std::vector<uint64> m_jit_ds;
+	std::vector<uint64> m_jit_sp;
+
+	std::string GetCodeCachePath(uint32 crc);
+	void LoadCodeCache();
+	void SaveCodeCache();
+	void StopCodeCache();
+
 	void Reset();
 	void VSync(int field);
 	void ResetDevice();
@@ -104,4 +116,6 @@ public:
 
 	GSRendererSW(int threads);
 	virtual ~GSRendererSW();
+
+	void SetGameCRC(uint32 crc, int options);
 };
@@ -68,45 +68,11 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 
 	m_textures.insert(t);
 
-	for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
-	{
-		const uint32 page = *p;
-		t->m_erase_it[page] = m_map[page].InsertFront(t);
-	}
+	t->m_erase_it = m.InsertFront(t);
 
 	return t;
 }
 
-void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
-{
-	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
-	{
-		const uint32 page = *p;
-		
-		for(Texture* t : m_map[page])
-		{
-			if(GSUtil::HasSharedBits(psm, t->m_sharedbits))
-			{
-				uint32* RESTRICT valid = t->m_valid;
-
-				if(t->m_repeating)
-				{
-					for(const GSVector2i& j : t->m_p2t[page])
-					{
-						valid[j.x] &= j.y;
-					}
-				}
-				else
-				{
-					valid[page] = 0;
-				}
-
-				t->m_complete = false;
-			}
-		}
-	}
-}
-
 void GSTextureCacheSW::RemoveAll()
 {
 	for(auto i : m_textures) delete i;
@@ -129,11 +95,7 @@ void GSTextureCacheSW::IncAge()
 		{
 			i = m_textures.erase(i);
 
-			for(const uint32* p = t->m_pages.n; *p != GSOffset::EOP; p++)
-			{
-				const uint32 page = *p;
-				m_map[page].EraseIndex(t->m_erase_it[page]);
-			}
+			m_map[t->m_TEX0.TBP0 >> 5].EraseIndex(t->m_erase_it);
 
 			delete t;
 		}
@@ -164,13 +126,28 @@ GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0&
 
 	memset(m_valid, 0, sizeof(m_valid));
 
-	m_sharedbits = GSUtil::HasSharedBitsPtr(m_TEX0.PSM);
+	GSLocalMemory& mem = m_state->m_mem;
 
-	m_offset = m_state->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
+	m_offset = mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
 
 	m_pages.n = m_offset->GetPages(GSVector4i(0, 0, 1 << TEX0.TW, 1 << TEX0.TH));
 	memcpy(m_pages.bm, m_offset->GetPagesAsBits(TEX0), sizeof(m_pages.bm));
 
+	// Nothing is valid yet, only the writes coming after this point matter
+
+	int pages = 0;
+
+	while(m_pages.n[pages] != GSOffset::EOP) pages++;
+
+	m_page_version = new uint32[std::max(pages, 1)];
+
+	m_version = mem.GetVersion();
+
+	for(int i = 0; i < pages; i++)
+	{
+		m_page_version[i] = mem.GetPageVersion(m_pages.n[i], m_TEX0.PSM);
+	}
+
 	m_repeating = m_TEX0.IsRepeating(); // repeating mode always works, it is just slightly slower
 
 	if(m_repeating)
@@ -182,6 +159,7 @@ GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0&
 GSTextureCacheSW::Texture::~Texture()
 {
 	delete [] m_pages.n;
+	delete [] m_page_version;
 
 	if(m_buff)
 	{
@@ -189,8 +167,50 @@ GSTextureCacheSW::Texture::~Texture()
 	}
 }
 
+void GSTextureCacheSW::Texture::Invalidate()
+{
+	GSLocalMemory& mem = m_state->m_mem;
+
+	// Read it first, a write racing with the loop will be caught by the next check
+	m_version = mem.GetVersion();
+
+	uint32* RESTRICT valid = m_valid;
+
+	for(int i = 0; m_pages.n[i] != GSOffset::EOP; i++)
+	{
+		const uint32 page = m_pages.n[i];
+		const uint32 version = mem.GetPageVersion(page, m_TEX0.PSM);
+
+		if(m_page_version[i] == version)
+		{
+			continue;
+		}
+
+		m_page_version[i] = version;
+
+		if(m_repeating)
+		{
+			for(const GSVector2i& j : m_p2t[page])
+			{
+				valid[j.x] &= j.y;
+			}
+		}
+		else
+		{
+			valid[page] = 0;
+		}
+
+		m_complete = false;
+	}
+}
+
 bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 {
+	if(m_version != m_state->m_mem.GetVersion())
+	{
+		Invalidate();
+	}
+
 	if(m_complete)
 	{
 		return true;
@@ -41,9 +41,10 @@ public:
 		bool m_repeating;
 		std::vector<GSVector2i>* m_p2t;
 		uint32 m_valid[MAX_PAGES];
-		std::array<uint16, MAX_PAGES> m_erase_it;
+		uint16 m_erase_it;
 		struct {uint32 bm[16]; const uint32* n;} m_pages;
-		const uint32* RESTRICT m_sharedbits;
+		uint32* m_page_version; // GSLocalMemory page versions m_valid is up to date with, same order as m_pages.n
+		uint32 m_version;
 
 		// m_valid
 		// fast mode: each uint32 bits map to the 32 blocks of that page
@@ -52,6 +53,7 @@ public:
 		Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
 		virtual ~Texture();
 
+		void Invalidate();
 		bool Update(const GSVector4i& r);
 		bool Save(const std::string& fn, bool dds = false) const;
 	};
@@ -67,8 +69,6 @@ public:
 
 	Texture* Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint32 tw0 = 0);
 
-	void InvalidatePages(const uint32* pages, uint32 psm);
-
 	void RemoveAll();
 	void IncAge();
 };
@@ -273,6 +273,7 @@ void populate_hw_table(GtkWidget* hw_table)
 	GtkWidget* hack_enable_check = CreateCheckBox("Enable User Hacks", "UserHacks");
 	GtkWidget* paltex_check   = CreateCheckBox("Allow 8 bits textures", "paltex");
 	GtkWidget* large_fb_check = CreateCheckBox("Large Framebuffer", "large_framebuffer");
+	GtkWidget* dedupe_check   = CreateCheckBox("Share Identical Textures", "texture_dedupe");
 
 	GtkWidget* fsaa_label     = left_label("Internal Resolution:");
 	GtkWidget* fsaa_combo_box = CreateComboBoxFromVector(theApp.m_gs_upscale_multiplier, "upscale_multiplier");
@@ -294,6 +295,7 @@ void populate_hw_table(GtkWidget* hw_table)
 
 	// Some helper string
 	gtk_widget_set_tooltip_text(hack_enable_check, "Enable the HW hack option panel");
+	gtk_widget_set_tooltip_text(dedupe_check, "Hash uploaded textures and reuse the GPU copy when a game uploads the same data again");
 	AddTooltip(paltex_check, IDC_PALTEX);
 	AddTooltip(large_fb_check, IDC_LARGE_FB);
 	AddTooltip(crc_label, crc_combo_box, IDC_CRC_LEVEL);
@@ -306,6 +308,7 @@ void populate_hw_table(GtkWidget* hw_table)
 	s_table_line = 0;
 	InsertWidgetInTable(hw_table , hack_enable_check);
 	InsertWidgetInTable(hw_table , paltex_check   , large_fb_check);
+	InsertWidgetInTable(hw_table , dedupe_check);
 	InsertWidgetInTable(hw_table , fsaa_label     , fsaa_combo_box);
 	InsertWidgetInTable(hw_table , af_label       , af_combo_box);
 	InsertWidgetInTable(hw_table , mipmap_label   , mipmap_combo_box);
@@ -341,6 +344,7 @@ void populate_sw_table(GtkWidget* sw_table)
 	GtkWidget* aa_check           = CreateCheckBox("Edge Anti-aliasing (Del)", "aa1");
 	GtkWidget* mipmap_check       = CreateCheckBox("Mipmapping", "mipmap");
 	GtkWidget* autoflush_sw_check = CreateCheckBox("Auto Flush", "autoflush_sw");
+	GtkWidget* binning_check      = CreateCheckBox("Tile Binning", "extrathreads_binning");
 
 	AddTooltip(aa_check, IDC_AA1);
 	AddTooltip(mipmap_check, IDC_MIPMAP_SW);
@@ -350,7 +354,7 @@ void populate_sw_table(GtkWidget* sw_table)
 	s_table_line = 0;
 	InsertWidgetInTable(sw_table , threads_label , threads_spin);
 	InsertWidgetInTable(sw_table , autoflush_sw_check , aa_check);
-	InsertWidgetInTable(sw_table , mipmap_check);
+	InsertWidgetInTable(sw_table , mipmap_check , binning_check);
 }
 
 void populate_shader_table(GtkWidget* shader_table)
@@ -516,6 +520,8 @@ void populate_main_table(GtkWidget* main_table)
 	GtkWidget* interlace_combo_box = CreateComboBoxFromVector(theApp.m_gs_interlace, "interlace");
 	GtkWidget* filter_label        = left_label("Texture Filtering:");
 	GtkWidget* filter_combo_box    = CreateComboBoxFromVector(theApp.m_gs_bifilter, "filter");
+	GtkWidget* swizzle_label       = left_label("Transfer threads:");
+	GtkWidget* swizzle_spin        = CreateSpinButton(0, 32, "swizzle_threads");
 
 	AddTooltip(filter_label, filter_combo_box, IDC_FILTER);
 
@@ -523,6 +529,7 @@ void populate_main_table(GtkWidget* main_table)
 	InsertWidgetInTable(main_table, render_label, render_combo_box);
 	InsertWidgetInTable(main_table, interlace_label, interlace_combo_box);
 	InsertWidgetInTable(main_table, filter_label, filter_combo_box);
+	InsertWidgetInTable(main_table, swizzle_label, swizzle_spin);
 }
 
 void populate_debug_table(GtkWidget* debug_table)
@@ -552,6 +559,8 @@ void populate_debug_table(GtkWidget* debug_table)
 void populate_record_table(GtkWidget* record_table)
 {
 	GtkWidget* capture_check = CreateCheckBox("Enable Recording (with F12)", "capture_enabled");
+	GtkWidget* format_label  = left_label("Format:");
+	GtkWidget* format_combo  = CreateComboBoxFromVector(theApp.m_gs_capture_format, "capture_format");
 	GtkWidget* resxy_label   = left_label("Resolution:");
 	GtkWidget* resx_spin     = CreateSpinButton(256, 8192, "CaptureWidth");
 	GtkWidget* resy_spin     = CreateSpinButton(256, 8192, "CaptureHeight");
@@ -563,6 +572,7 @@ void populate_record_table(GtkWidget* record_table)
 	GtkWidget* png_level     = CreateSpinButton(1, 9, "png_compression_level");
 
 	InsertWidgetInTable(record_table , capture_check);
+	InsertWidgetInTable(record_table , format_label  , format_combo);
 	InsertWidgetInTable(record_table , resxy_label   , resx_spin      , resy_spin);
 	InsertWidgetInTable(record_table , threads_label , threads_spin);
 	InsertWidgetInTable(record_table , png_label     , png_level);
@@ -0,0 +1,50 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "stdafx.h"
+#include "GSWndNull.h"
+
+GSWndNull::GSWndNull()
+	: m_w(640)
+	, m_h(480)
+{
+}
+
+bool GSWndNull::Create(const std::string& title, int w, int h)
+{
+	m_w = std::max<int>(w, 1);
+	m_h = std::max<int>(h, 1);
+
+	return true;
+}
+
+bool GSWndNull::Attach(void* handle, bool managed)
+{
+	m_managed = managed;
+
+	return true;
+}
+
+GSVector4i GSWndNull::GetClientRect()
+{
+	return GSVector4i(0, 0, m_w, m_h);
+}
@@ -0,0 +1,51 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#pragma once
+
+#include "GSWnd.h"
+
+// Window-less backend used by the headless replayer. It never touches the
+// display server, the client rect is only used to size the backbuffer.
+
+class GSWndNull final : public GSWnd
+{
+	int m_w;
+	int m_h;
+
+public:
+	GSWndNull();
+	virtual ~GSWndNull() {};
+
+	bool Create(const std::string& title, int w, int h);
+	bool Attach(void* handle, bool managed = true);
+	void Detach() {}
+
+	void* GetDisplay() {return NULL;}
+	void* GetHandle() {return NULL;}
+	GSVector4i GetClientRect();
+	bool SetWindowText(const char* title) {return false;}
+
+	void Show() {}
+	void Hide() {}
+	void HideFrame() {}
+};
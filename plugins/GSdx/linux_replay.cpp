@@ -18,10 +18,14 @@
  *
  */
 
+#include "stdafx.h"
+#include "GS.h"
 #include <dlfcn.h>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <vector>
 
 static void* handle;
 
@@ -31,6 +35,17 @@ void help()
 	fprintf(stderr, "ARG1 GSdx plugin\n");
 	fprintf(stderr, "ARG2 .gs file\n");
 	fprintf(stderr, "ARG3 Ini directory\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Headless benchmark (no display required)\n");
+	fprintf(stderr, "--bench [--renderer null|sw] [--passes N] [--report file.json|file.csv] ARG1 ARG2 [ARG3]\n");
+	fprintf(stderr, "  ARG1 can be a comma separated list of plugins (e.g. the SSE2, SSE4 and AVX2\n");
+	fprintf(stderr, "  builds) to compare them on the same dump, reports get the plugin index appended\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Transfer benchmark (swizzle/unswizzle speed of each format)\n");
+	fprintf(stderr, "--bench-transfer [--threads N] [--report file.json] ARG1\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Self test (checks which don't need a display or a GPU)\n");
+	fprintf(stderr, "--selftest ARG1\n");
 	if (handle) {
 		dlclose(handle);
 	}
@@ -46,10 +61,180 @@ char* read_env(const char* var) {
 	return v;
 }
 
-int main ( int argc, char *argv[] )
+static int bench(int argc, char *argv[])
+{
+	GSRendererType renderer = GSRendererType::OGL_SW;
+	int passes = 1;
+	const char* report = "-";
+
+	int i = 0;
+	for (; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+		if (i + 1 >= argc)
+			help();
+
+		if (strcmp(argv[i], "--renderer") == 0) {
+			const char* r = argv[++i];
+			if (strcmp(r, "null") == 0)
+				renderer = GSRendererType::Null;
+			else if (strcmp(r, "sw") == 0)
+				renderer = GSRendererType::OGL_SW;
+			else
+				renderer = static_cast<GSRendererType>(atoi(r));
+		} else if (strcmp(argv[i], "--passes") == 0) {
+			passes = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--report") == 0) {
+			report = argv[++i];
+		} else {
+			help();
+		}
+	}
+
+	if (argc - i < 2) help();
+
+	std::vector<std::string> plugins;
+	std::string list(argv[i]);
+	for (size_t pos = 0; pos <= list.size();) {
+		size_t end = list.find(',', pos);
+		if (end == std::string::npos)
+			end = list.size();
+		if (end > pos)
+			plugins.push_back(list.substr(pos, end - pos));
+		pos = end + 1;
+	}
+
+	int ret = 0;
+
+	for (size_t n = 0; n < plugins.size(); n++) {
+		const char* plugin = plugins[n].c_str();
+
+		handle = dlopen(plugin, RTLD_LAZY|RTLD_LOCAL);
+		if (handle == NULL) {
+			fprintf(stderr, "Failed to dlopen plugin %s\n", plugin);
+			help();
+		}
+
+		__attribute__((stdcall)) void (*GSsetSettingsDir_ptr)(const char*);
+		__attribute__((stdcall)) int (*GSReplayHeadless_ptr)(char*, int, int, const char*);
+
+		GSsetSettingsDir_ptr = reinterpret_cast<decltype(GSsetSettingsDir_ptr)>(dlsym(handle, "GSsetSettingsDir"));
+		GSReplayHeadless_ptr = reinterpret_cast<decltype(GSReplayHeadless_ptr)>(dlsym(handle, "GSReplayHeadless"));
+
+		if (GSReplayHeadless_ptr == NULL) {
+			fprintf(stderr, "Plugin %s doesn't support headless replay\n", plugin);
+			help();
+		}
+
+		if (argc - i > 2)
+			GSsetSettingsDir_ptr(argv[i + 2]);
+		else if (getenv("GSDUMP_CONF"))
+			GSsetSettingsDir_ptr(getenv("GSDUMP_CONF"));
+
+		// report.json -> report.0.json, report.1.json...
+		std::string out(report);
+		if (plugins.size() > 1 && out != "-") {
+			size_t dot = out.find_last_of('.');
+			size_t slash = out.find_last_of('/');
+			if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+				dot = out.size();
+			out.insert(dot, "." + std::to_string(n));
+		}
+
+		fprintf(stderr, "%s:\n", plugin);
+
+		if (GSReplayHeadless_ptr(argv[i + 1], static_cast<int>(renderer), passes, out.c_str()) != 0)
+			ret = 1;
+
+		dlclose(handle);
+		handle = NULL;
+	}
+
+	return ret;
+}
+
+static int bench_transfer(int argc, char *argv[])
+{
+	int threads = 2;
+	const char* report = "-";
+
+	int i = 0;
+	for (; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+		if (i + 1 >= argc)
+			help();
+
+		if (strcmp(argv[i], "--threads") == 0) {
+			threads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--report") == 0) {
+			report = argv[++i];
+		} else {
+			help();
+		}
+	}
+
+	if (argc - i < 1) help();
+
+	handle = dlopen(argv[i], RTLD_LAZY|RTLD_LOCAL);
+	if (handle == NULL) {
+		fprintf(stderr, "Failed to dlopen plugin %s\n", argv[i]);
+		help();
+	}
+
+	__attribute__((stdcall)) int (*GSBenchmarkTransfer_ptr)(int, const char*);
+
+	GSBenchmarkTransfer_ptr = reinterpret_cast<decltype(GSBenchmarkTransfer_ptr)>(dlsym(handle, "GSBenchmarkTransfer"));
+
+	if (GSBenchmarkTransfer_ptr == NULL) {
+		fprintf(stderr, "Plugin %s doesn't support the transfer benchmark\n", argv[i]);
+		help();
+	}
+
+	int ret = GSBenchmarkTransfer_ptr(threads, report) != 0 ? 1 : 0;
+
+	dlclose(handle);
+	handle = NULL;
+
+	return ret;
+}
+
+static int selftest(int argc, char *argv[])
 {
 	if (argc < 1) help();
 
+	handle = dlopen(argv[0], RTLD_LAZY|RTLD_LOCAL);
+	if (handle == NULL) {
+		fprintf(stderr, "Failed to dlopen plugin %s\n", argv[0]);
+		help();
+	}
+
+	__attribute__((stdcall)) int (*GSSelfTest_ptr)();
+
+	GSSelfTest_ptr = reinterpret_cast<decltype(GSSelfTest_ptr)>(dlsym(handle, "GSSelfTest"));
+
+	if (GSSelfTest_ptr == NULL) {
+		fprintf(stderr, "Plugin %s doesn't support the self test\n", argv[0]);
+		help();
+	}
+
+	int ret = GSSelfTest_ptr() != 0 ? 1 : 0;
+
+	dlclose(handle);
+	handle = NULL;
+
+	return ret;
+}
+
+int main ( int argc, char *argv[] )
+{
+	if (argc < 2) help();
+
+	if (strcmp(argv[1], "--bench") == 0)
+		return bench(argc - 2, argv + 2);
+
+	if (strcmp(argv[1], "--bench-transfer") == 0)
+		return bench_transfer(argc - 2, argv + 2);
+
+	if (strcmp(argv[1], "--selftest") == 0)
+		return selftest(argc - 2, argv + 2);
+
 	char* plugin;
 	char* gs;
 	if (argc > 2) {
@@ -111,6 +111,8 @@ typedef int64 sint64;
 #include <set>
 #include <queue>
 #include <algorithm>
+#include <numeric>
+#include <chrono>
 #include <thread>
 #include <atomic>
 #include <mutex>
@@ -19,6 +19,9 @@
 #include <limits>
 #include <queue>
 #include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#endif
 
 const u32 sectors_per_read = 16;
 
@@ -165,6 +168,9 @@ void cdvdThread()
     u8 buffer[2352 * sectors_per_read];
     u32 prefetches_left = 0;
 
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), "CDVD reader");
+#endif
     printf(" * CDVD: IO thread started...\n");
     std::unique_lock<std::mutex> guard(s_notify_lock);
 
@@ -213,6 +213,7 @@ static __forceinline s32 GetNextDataBuffered(V_Core &thiscore, uint voiceidx)
                     g_counter_cache_misses++;
             }
 
+            MixStageTimer timer(MixStage_Decode);
             XA_decode_block(vc.SBuffer, memptr, vc.Prev1, vc.Prev2);
         }
     }
@@ -255,10 +256,10 @@ static __forceinline void GetNextDataDummy(V_Core &thiscore, uint voiceidx)
 /////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////
 
+static u16 lfsr = 0xC0FEu;
+
 static s32 __forceinline GetNoiseValues()
 {
-    static u16 lfsr = 0xC0FEu;
-
     u16 bit = lfsr ^ (lfsr << 3) ^ (lfsr << 4) ^ (lfsr << 5);
     lfsr = (lfsr << 1) | (bit >> 15);
 
@@ -329,39 +330,126 @@ static __forceinline void CalculateADSR(V_Core &thiscore, uint voiceidx)
     pxAssume(vc.ADSR.Value >= 0); // ADSR should never be negative...
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                     //
+
+// Voices are mixed in two steps.  First the per-voice work that can't be vectorized
+// (volume slides, pitch, ADPCM decoding, ADSR and IRQs) is done voice by voice, in order,
+// since voices modulate the pitch of the next one and IRQs have to be raised in order.
+// Its results are copied into VoiceLanes, a structure-of-arrays copy of the voice state.
+// Then the interpolation and the envelope and volume multiplies are done from there, for
+// 8 voices at a time (two SSE2 registers).  The integer math is the same as the scalar
+// version lane by lane, so the output is bit-identical.
+
+static const uint VoicesPerGroup = 8;
+
+struct VoiceLanes
+{
+    // Interpolation input: the last four samples (PV4 is the oldest) and sample position
+    __aligned16 s32 PV4[V_Core::NumVoices];
+    __aligned16 s32 PV3[V_Core::NumVoices];
+    __aligned16 s32 PV2[V_Core::NumVoices];
+    __aligned16 s32 PV1[V_Core::NumVoices];
+    __aligned16 s32 SP[V_Core::NumVoices];
+
+    // Noise voices aren't interpolated, NoiseMask selects NoiseValue for them instead.
+    __aligned16 s32 NoiseMask[V_Core::NumVoices];
+    __aligned16 s32 NoiseValue[V_Core::NumVoices];
+
+    __aligned16 s32 Envelope[V_Core::NumVoices]; // ADSR value, 0 for voices that are off
+    __aligned16 s32 VolumeL[V_Core::NumVoices];
+    __aligned16 s32 VolumeR[V_Core::NumVoices];
+
+    // VoiceGates, sign extended
+    __aligned16 s32 DryL[V_Core::NumVoices];
+    __aligned16 s32 DryR[V_Core::NumVoices];
+    __aligned16 s32 WetL[V_Core::NumVoices];
+    __aligned16 s32 WetR[V_Core::NumVoices];
+};
+
+static_assert(V_Core::NumVoices % VoicesPerGroup == 0, "Voices must fill whole groups");
+
+static VoiceLanes voice_lanes[2];
+
+static __forceinline __m128i LoadLanes(const s32 *src)
+{
+    return _mm_load_si128((const __m128i *)src);
+}
+
+// MulShr32 on four lanes.  SSE2 only has an unsigned 32x32 bit multiply, so the high half
+// of the product is corrected for negative inputs.
+static __forceinline __m128i MulShr32(__m128i a, __m128i b)
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    const __m128i hi = _mm_unpacklo_epi32(
+        _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 3, 1)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 3, 1)));
+
+    const __m128i fix = _mm_add_epi32(
+        _mm_and_si128(_mm_srai_epi32(a, 31), b),
+        _mm_and_si128(_mm_srai_epi32(b, 31), a));
+
+    return _mm_sub_epi32(hi, fix);
+}
+
+// (x * mu) >> shift
+template <int shift>
+static __forceinline __m128i MulMu(__m128i x, __m128i mu)
+{
+    return _mm_srai_epi32(MulLo32(x, mu), shift);
+}
+
 /*
    Tension: 65535 is high, 32768 is normal, 0 is low
+   Only the default tension (16384) is used: (x * 16384) >> 16
 */
-template <s32 i_tension>
-__forceinline static s32 HermiteInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
+static __forceinline __m128i HermiteTension(__m128i x)
+{
+    return _mm_srai_epi32(_mm_slli_epi32(x, 14), 16);
+}
+
+static __forceinline __m128i HermiteInterpolate(
+    __m128i y0, // 16.0
+    __m128i y1, // 16.0
+    __m128i y2, // 16.0
+    __m128i y3, // 16.0
+    __m128i mu  //  0.12
     )
 {
-    s32 m00 = ((y1 - y0) * i_tension) >> 16; // 16.0
-    s32 m01 = ((y2 - y1) * i_tension) >> 16; // 16.0
-    s32 m0 = m00 + m01;
+    const __m128i m00 = HermiteTension(_mm_sub_epi32(y1, y0)); // 16.0
+    const __m128i m01 = HermiteTension(_mm_sub_epi32(y2, y1)); // 16.0
+    const __m128i m0 = _mm_add_epi32(m00, m01);
+
+    const __m128i m10 = m01;                                   // 16.0
+    const __m128i m11 = HermiteTension(_mm_sub_epi32(y3, y2)); // 16.0
+    const __m128i m1 = _mm_add_epi32(m10, m11);
 
-    s32 m10 = ((y2 - y1) * i_tension) >> 16; // 16.0
-    s32 m11 = ((y3 - y2) * i_tension) >> 16; // 16.0
-    s32 m1 = m10 + m11;
+    const __m128i y1x2 = _mm_slli_epi32(y1, 1);
+    const __m128i y2x2 = _mm_slli_epi32(y2, 1);
 
-    s32 val = ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12;       // 16.0
-    val = ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12; // 16.0
-    val = ((val + m0) * mu) >> 11;                            // 16.0
+    // ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12
+    __m128i val = MulMu<12>(_mm_sub_epi32(_mm_add_epi32(_mm_add_epi32(y1x2, m0), m1), y2x2), mu);
 
-    return (val + (y1 << 1));
+    // ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12
+    val = _mm_sub_epi32(val, _mm_add_epi32(y1x2, y1));
+    val = _mm_sub_epi32(val, _mm_add_epi32(_mm_slli_epi32(m0, 1), m1));
+    val = MulMu<12>(_mm_add_epi32(val, _mm_add_epi32(y2x2, y2)), mu);
+
+    // ((val + m0) * mu) >> 11
+    val = MulMu<11>(_mm_add_epi32(val, m0), mu);
+
+    return _mm_add_epi32(val, y1x2);
 }
 
-__forceinline static s32 CatmullRomInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
+static __forceinline __m128i CatmullRomInterpolate(
+    __m128i y0, // 16.0
+    __m128i y1, // 16.0
+    __m128i y2, // 16.0
+    __m128i y3, // 16.0
+    __m128i mu  //  0.12
     )
 {
     //q(t) = 0.5 *(    	(2 * P1) +
@@ -369,74 +457,92 @@ __forceinline static s32 CatmullRomInterpolate(
     //	(2*P0 - 5*P1 + 4*P2 - P3) * t2 +
     //	(-P0 + 3*P1- 3*P2 + P3) * t3)
 
-    s32 a3 = (-y0 + 3 * y1 - 3 * y2 + y3);
-    s32 a2 = (2 * y0 - 5 * y1 + 4 * y2 - y3);
-    s32 a1 = (-y0 + y2);
-    s32 a0 = (2 * y1);
+    const __m128i d12 = _mm_sub_epi32(y1, y2);
+
+    // -y0 + 3 * y1 - 3 * y2 + y3
+    const __m128i a3 = _mm_add_epi32(_mm_sub_epi32(y3, y0), _mm_add_epi32(_mm_slli_epi32(d12, 1), d12));
+    // 2 * y0 - 5 * y1 + 4 * y2 - y3
+    const __m128i a2 = _mm_sub_epi32(
+        _mm_sub_epi32(_mm_add_epi32(_mm_slli_epi32(y0, 1), _mm_slli_epi32(y2, 2)), _mm_add_epi32(_mm_slli_epi32(y1, 2), y1)), y3);
+    const __m128i a1 = _mm_sub_epi32(y2, y0);
+    const __m128i a0 = _mm_slli_epi32(y1, 1);
 
-    s32 val = ((a3)*mu) >> 12;
-    val = ((a2 + val) * mu) >> 12;
-    val = ((a1 + val) * mu) >> 12;
+    __m128i val = MulMu<12>(a3, mu);
+    val = MulMu<12>(_mm_add_epi32(a2, val), mu);
+    val = MulMu<12>(_mm_add_epi32(a1, val), mu);
 
-    return (a0 + val);
+    return _mm_add_epi32(a0, val);
 }
 
-__forceinline static s32 CubicInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
+static __forceinline __m128i CubicInterpolate(
+    __m128i y0, // 16.0
+    __m128i y1, // 16.0
+    __m128i y2, // 16.0
+    __m128i y3, // 16.0
+    __m128i mu  //  0.12
     )
 {
-    const s32 a0 = y3 - y2 - y0 + y1;
-    const s32 a1 = y0 - y1 - a0;
-    const s32 a2 = y2 - y0;
+    const __m128i a0 = _mm_add_epi32(_mm_sub_epi32(_mm_sub_epi32(y3, y2), y0), y1);
+    const __m128i a1 = _mm_sub_epi32(_mm_sub_epi32(y0, y1), a0);
+    const __m128i a2 = _mm_sub_epi32(y2, y0);
 
-    s32 val = ((a0)*mu) >> 12;
-    val = ((val + a1) * mu) >> 12;
-    val = ((val + a2) * mu) >> 11;
+    __m128i val = MulMu<12>(a0, mu);
+    val = MulMu<12>(_mm_add_epi32(val, a1), mu);
+    val = MulMu<11>(_mm_add_epi32(val, a2), mu);
 
-    return (val + (y1 << 1));
+    return _mm_add_epi32(val, _mm_slli_epi32(y1, 1));
 }
 
-// Returns a 16 bit result in Value.
-// Uses standard template-style optimization techniques to statically generate five different
-// versions of this function (one for each type of interpolation).
+// Returns 16 bit results for the four voices starting at voiceidx.
+// The interpolation type is a template parameter so that each mixer is built for a single
+// one (see Mix).
 template <int InterpType>
-static __forceinline s32 GetVoiceValues(V_Core &thiscore, uint voiceidx)
+static __forceinline __m128i InterpolateVoices(const VoiceLanes &lanes, uint voiceidx)
 {
-    V_Voice &vc(thiscore.Voices[voiceidx]);
+    const __m128i pv1 = LoadLanes(lanes.PV1 + voiceidx);
+    const __m128i sp = LoadLanes(lanes.SP + voiceidx);
 
-    while (vc.SP > 0) {
-        if (InterpType >= 2) {
-            vc.PV4 = vc.PV3;
-            vc.PV3 = vc.PV2;
-        }
-        vc.PV2 = vc.PV1;
-        vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
-        vc.SP -= 4096;
-    }
+    if (InterpType == 0)
+        return _mm_slli_epi32(pv1, 1);
 
-    const s32 mu = vc.SP + 4096;
+    const __m128i pv2 = LoadLanes(lanes.PV2 + voiceidx);
 
-    switch (InterpType) {
-        case 0:
-            return vc.PV1 << 1;
-        case 1:
-            return (vc.PV1 << 1) - (((vc.PV2 - vc.PV1) * vc.SP) >> 11);
+    if (InterpType == 1)
+        return _mm_sub_epi32(_mm_slli_epi32(pv1, 1), MulMu<11>(_mm_sub_epi32(pv2, pv1), sp));
+
+    const __m128i pv3 = LoadLanes(lanes.PV3 + voiceidx);
+    const __m128i pv4 = LoadLanes(lanes.PV4 + voiceidx);
+    const __m128i mu = _mm_add_epi32(sp, _mm_set1_epi32(4096));
 
+    switch (InterpType) {
         case 2:
-            return CubicInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+            return CubicInterpolate(pv4, pv3, pv2, pv1, mu);
         case 3:
-            return HermiteInterpolate<16384>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+            return HermiteInterpolate(pv4, pv3, pv2, pv1, mu);
         case 4:
-            return CatmullRomInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
+            return CatmullRomInterpolate(pv4, pv3, pv2, pv1, mu);
 
             jNO_DEFAULT;
     }
 
-    return 0; // technically unreachable!
+    return _mm_setzero_si128(); // technically unreachable!
+}
+
+// Reads the samples the voice has moved past, for the interpolation.
+template <int InterpType>
+static __forceinline void FetchVoiceSamples(V_Core &thiscore, uint voiceidx)
+{
+    V_Voice &vc(thiscore.Voices[voiceidx]);
+
+    while (vc.SP > 0) {
+        if (InterpType >= 2) {
+            vc.PV4 = vc.PV3;
+            vc.PV3 = vc.PV2;
+        }
+        vc.PV2 = vc.PV1;
+        vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
+        vc.SP -= 4096;
+    }
 }
 
 // Noise values need to be mixed without going through interpolation, since it
@@ -485,7 +591,10 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 }
 
 
-static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
+// Scalar part of the voice mixing, fills the voice's lanes.  The envelope has already
+// been updated (see MixCoreVoices), active tells whether the voice was on before that.
+template <int InterpType>
+static __forceinline void StepVoice(VoiceLanes &lanes, uint coreidx, uint voiceidx, bool active)
 {
     V_Core &thiscore(Cores[coreidx]);
     V_Voice &vc(thiscore.Voices[voiceidx]);
@@ -504,47 +613,25 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
     // have to run through all the motions of updating the voice regardless of it's
     // audible status.  Otherwise IRQs might not trigger and emulation might fail.
 
-    if (vc.ADSR.Phase > 0) {
+    if (active) {
         UpdatePitch(coreidx, voiceidx);
 
-        s32 Value = 0;
-
         if (vc.Noise)
-            Value = GetNoiseValues(thiscore, voiceidx);
-        else {
-            // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
-            // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
-
-            switch (Interpolation) {
-                case 0:
-                    Value = GetVoiceValues<0>(thiscore, voiceidx);
-                    break;
-                case 1:
-                    Value = GetVoiceValues<1>(thiscore, voiceidx);
-                    break;
-                case 2:
-                    Value = GetVoiceValues<2>(thiscore, voiceidx);
-                    break;
-                case 3:
-                    Value = GetVoiceValues<3>(thiscore, voiceidx);
-                    break;
-                case 4:
-                    Value = GetVoiceValues<4>(thiscore, voiceidx);
-                    break;
-
-                    jNO_DEFAULT;
-            }
-        }
+            lanes.NoiseValue[voiceidx] = GetNoiseValues(thiscore, voiceidx);
+        else
+            FetchVoiceSamples<InterpType>(thiscore, voiceidx);
 
-        // Update and Apply ADSR  (applies to normal and noise sources)
+        lanes.NoiseMask[voiceidx] = vc.Noise ? -1 : 0;
+
+        // ADSR applies to normal and noise sources.  A voice stopped by its end point
+        // while fetching has its envelope zeroed, as if the ADSR was updated after that.
         //
         // Note!  It's very important that ADSR stay as accurate as possible.  By the way
         // it is used, various sound effects can end prematurely if we truncate more than
         // one or two bits.  Best result comes from no truncation at all, which is why we
-        // use a full 64-bit multiply/result here.
+        // use a full 64-bit multiply/result when it's applied.
 
-        CalculateADSR(thiscore, voiceidx);
-        Value = MulShr32(Value, vc.ADSR.Value);
+        lanes.Envelope[voiceidx] = vc.ADSR.Value;
 
         // Store Value for eventual modulation later
         // Pseudonym's Crest calculation idea. Actually calculates a crest, unlike the old code which was just peak.
@@ -565,8 +652,6 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
             spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, vc.OutX);
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, vc.OutX);
-
-        return ApplyVolume(StereoOut32(Value, Value), vc.Volume);
     } else {
         // Continue processing voice, even if it's "off". Or else we miss interrupts! (Fatal Frame engine died because of this.)
         if (NEVER_SKIP_VOICES || (*GetMemPtr(vc.NextA & 0xFFFF8) >> 8 & 3) != 3 || vc.LoopStartA != (vc.NextA & ~7)    // not in a tight loop
@@ -585,26 +670,93 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, 0);
 
-        return StereoOut32(0, 0);
+        // Silences the voice in the vector part.
+        lanes.Envelope[voiceidx] = 0;
     }
+
+    lanes.PV4[voiceidx] = vc.PV4;
+    lanes.PV3[voiceidx] = vc.PV3;
+    lanes.PV2[voiceidx] = vc.PV2;
+    lanes.PV1[voiceidx] = vc.PV1;
+    lanes.SP[voiceidx] = vc.SP;
+
+    lanes.VolumeL[voiceidx] = vc.Volume.Left.Value;
+    lanes.VolumeR[voiceidx] = vc.Volume.Right.Value;
+
+    const V_VoiceGates &gates(thiscore.VoiceGates[voiceidx]);
+    lanes.DryL[voiceidx] = gates.DryL;
+    lanes.DryR[voiceidx] = gates.DryR;
+    lanes.WetL[voiceidx] = gates.WetL;
+    lanes.WetR[voiceidx] = gates.WetR;
 }
 
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
+template <int InterpType>
 static __forceinline void MixCoreVoices(VoiceMixSet &dest, const uint coreidx)
 {
     V_Core &thiscore(Cores[coreidx]);
+    VoiceLanes &lanes(voice_lanes[coreidx]);
+
+    // The envelopes only depend on their own voice, so they're all updated first.  The
+    // voices that were on before the update are still processed as such.
+    u32 active = 0;
+    {
+        MixStageTimer timer(MixStage_ADSR);
+
+        for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx) {
+            if (thiscore.Voices[voiceidx].ADSR.Phase > 0) {
+                active |= 1 << voiceidx;
+                CalculateADSR(thiscore, voiceidx);
+            }
+        }
+    }
+
+    MixStageTimer timer(MixStage_Voices);
 
-    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx) {
-        StereoOut32 VVal(MixVoice(coreidx, voiceidx));
+    for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+        StepVoice<InterpType>(lanes, coreidx, voiceidx, (active >> voiceidx) & 1);
 
-        // Note: Results from MixVoice are ranged at 16 bits.
+    __m128i dryL = _mm_setzero_si128();
+    __m128i dryR = _mm_setzero_si128();
+    __m128i wetL = _mm_setzero_si128();
+    __m128i wetR = _mm_setzero_si128();
 
-        dest.Dry.Left += VVal.Left & thiscore.VoiceGates[voiceidx].DryL;
-        dest.Dry.Right += VVal.Right & thiscore.VoiceGates[voiceidx].DryR;
-        dest.Wet.Left += VVal.Left & thiscore.VoiceGates[voiceidx].WetL;
-        dest.Wet.Right += VVal.Right & thiscore.VoiceGates[voiceidx].WetR;
+    for (uint group = 0; group < V_Core::NumVoices; group += VoicesPerGroup) {
+        for (uint voiceidx = group; voiceidx < group + VoicesPerGroup; voiceidx += 4) {
+            const __m128i noise = LoadLanes(lanes.NoiseMask + voiceidx);
+
+            __m128i value = InterpolateVoices<InterpType>(lanes, voiceidx);
+            value = _mm_or_si128(_mm_andnot_si128(noise, value), _mm_and_si128(noise, LoadLanes(lanes.NoiseValue + voiceidx)));
+
+            // Apply ADSR, then the volume (see ApplyVolume).
+            value = MulShr32(value, LoadLanes(lanes.Envelope + voiceidx));
+            value = _mm_slli_epi32(value, 1);
+
+            const __m128i left = MulShr32(value, LoadLanes(lanes.VolumeL + voiceidx));
+            const __m128i right = MulShr32(value, LoadLanes(lanes.VolumeR + voiceidx));
+
+            // Note: voice results are ranged at 16 bits.
+
+            dryL = _mm_add_epi32(dryL, _mm_and_si128(left, LoadLanes(lanes.DryL + voiceidx)));
+            dryR = _mm_add_epi32(dryR, _mm_and_si128(right, LoadLanes(lanes.DryR + voiceidx)));
+            wetL = _mm_add_epi32(wetL, _mm_and_si128(left, LoadLanes(lanes.WetL + voiceidx)));
+            wetR = _mm_add_epi32(wetR, _mm_and_si128(right, LoadLanes(lanes.WetR + voiceidx)));
+        }
     }
+
+    dest.Dry.Left += HorizontalSum(dryL);
+    dest.Dry.Right += HorizontalSum(dryR);
+    dest.Wet.Left += HorizontalSum(wetL);
+    dest.Wet.Right += HorizontalSum(wetR);
+}
+
+// Mixes the voices of both cores, with the interpolation picked at compile time.
+template <int InterpType>
+static __forceinline void MixVoices(VoiceMixSet (&dest)[2])
+{
+    MixCoreVoices<InterpType>(dest[0], 0);
+    MixCoreVoices<InterpType>(dest[1], 1);
 }
 
 StereoOut32 V_Core::Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, const StereoOut32 &Ext)
@@ -662,6 +814,8 @@ StereoOut32 V_Core::Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, c
     //
     // On the other hand, updating the buffer is cheap and easy, so might as well. ;)
 
+    MixStageTimer timer(MixStage_Reverb);
+
     Reverb_AdvanceBuffer(); // Updates the reverb work area as well, if needed.
 
     // ToDo:
@@ -697,9 +851,11 @@ StereoOut32 V_Core::Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, c
 // Taken from http://nenolod.net/projects/upse/
 #define OVERALL_SCALE (0.87f)
 
+static FrequencyResponseFilter FRF;
+static StereoOut32 DealiasOld;
+
 StereoOut32 Apply_Frequency_Response_Filter(StereoOut32 &SoundStream)
 {
-    static FrequencyResponseFilter FRF = FrequencyResponseFilter();
 
     s32 in, out;
     s32 l, r;
@@ -752,18 +908,16 @@ StereoOut32 Apply_Frequency_Response_Filter(StereoOut32 &SoundStream)
 
 StereoOut32 Apply_Dealias_Filter(StereoOut32 &SoundStream)
 {
-    static StereoOut32 Old = StereoOut32::Empty;
-
     s32 l, r;
 
     l = SoundStream.Left;
     r = SoundStream.Right;
 
-    l += (l - Old.Left);
-    r += (r - Old.Right);
+    l += (l - DealiasOld.Left);
+    r += (r - DealiasOld.Right);
 
-    Old.Left = SoundStream.Left;
-    Old.Right = SoundStream.Right;
+    DealiasOld.Left = SoundStream.Left;
+    DealiasOld.Right = SoundStream.Right;
 
     SoundStream.Left = l;
     SoundStream.Right = r;
@@ -774,6 +928,17 @@ StereoOut32 Apply_Dealias_Filter(StereoOut32 &SoundStream)
 // used to throttle the output rate of cache stat reports
 static int p_cachestat_counter = 0;
 
+bool MixProfiling = false;
+u64 MixStageTicks[MixStage_Count];
+
+// Noise generator and output filters, the only mixer state which isn't part of the cores.
+void MixResetState()
+{
+    lfsr = 0xC0FEu;
+    FRF = FrequencyResponseFilter();
+    DealiasOld = StereoOut32::Empty;
+}
+
 // Gcc does not want to inline it when lto is enabled because some functions growth too much.
 // The function is big enought to see any speed impact. -- Gregory
 #ifndef __POSIX__
@@ -799,8 +964,28 @@ __forceinline
 
     // Todo: Replace me with memzero initializer!
     VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty}; // mixed voice data for each core.
-    MixCoreVoices(VoiceData[0], 0);
-    MixCoreVoices(VoiceData[1], 1);
+
+    // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
+    // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
+    switch (Interpolation) {
+        case 0:
+            MixVoices<0>(VoiceData);
+            break;
+        case 1:
+            MixVoices<1>(VoiceData);
+            break;
+        case 2:
+            MixVoices<2>(VoiceData);
+            break;
+        case 3:
+            MixVoices<3>(VoiceData);
+            break;
+        case 4:
+            MixVoices<4>(VoiceData);
+            break;
+
+            jNO_DEFAULT;
+    }
 
     StereoOut32 Ext(Cores[0].Mix(VoiceData[0], InputData[0], StereoOut32::Empty));
 
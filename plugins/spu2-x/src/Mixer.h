@@ -133,3 +133,63 @@ extern void Mix();
 extern s32 clamp_mix(s32 x, u8 bitshift = 0);
 
 extern StereoOut32 clamp_mix(const StereoOut32 &sample, u8 bitshift = 0);
+
+// SSE2 helpers shared by the voice mixer and the reverb.
+
+// Low 32 bits of a 32x32 bit multiply (SSE4.1's pmulld, but the plugin only needs SSE2).
+static __forceinline __m128i MulLo32(__m128i a, __m128i b)
+{
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    return _mm_unpacklo_epi32(
+        _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static __forceinline s32 HorizontalSum(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+// Resets the mixer state that isn't part of the cores (noise generator, output filters).
+extern void MixResetState();
+
+// --------------------------------------------------------------------------------------
+//  Mixer profiling
+// --------------------------------------------------------------------------------------
+// Time spent in each stage of the mixer, in TSC ticks.  Only collected while MixProfiling
+// is set, by the headless replay benchmark (see Spu2replay.cpp).
+
+enum MixStage {
+    MixStage_Decode,      // ADPCM decoding (cache misses only, part of MixStage_Voices)
+    MixStage_ADSR,        // envelope updates
+    MixStage_Voices,      // the rest of the voice mixing: pitch, fetch, interpolation, volume
+    MixStage_Reverb,      // reverb buffer and effects
+    MixStage_TimeStretch, // timestretcher
+    MixStage_Count
+};
+
+extern bool MixProfiling;
+extern u64 MixStageTicks[MixStage_Count];
+
+class MixStageTimer
+{
+    const MixStage m_stage;
+    const u64 m_start;
+
+public:
+    __forceinline MixStageTimer(MixStage stage)
+        : m_stage(stage)
+        , m_start(MixProfiling ? __rdtsc() : 0)
+    {
+    }
+
+    __forceinline ~MixStageTimer()
+    {
+        if (MixProfiling)
+            MixStageTicks[m_stage] += __rdtsc() - m_start;
+    }
+};
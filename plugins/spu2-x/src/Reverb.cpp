@@ -17,20 +17,73 @@
 
 #include "Global.h"
 
-__forceinline s32 V_Core::RevbGetIndexer(s32 offset)
+// --------------------------------------------------------------------------------------
+//  Reverb taps
+// --------------------------------------------------------------------------------------
+// The buffer addresses DoReverb works with, for the left (even cycles) and right (odd
+// cycles) halves of the network.  They're copies of RevBuffers, laid out so that the
+// addresses can be advanced and wrapped four at a time and the samples read from them
+// land in the lanes the filter math wants:
+//
+//   SameSrc, DiffSrc, SamePrv, DiffPrv    IIR stage (the first two lanes are used)
+//   Comb1,   Comb2,   Comb3,   Comb4      comb filters
+//   SameDst, DiffDst, Apf1Dst, Apf2Dst    writes, in the order they're done
+//   Apf1Src, Apf2Src, (Apf1Src, Apf2Src)  all-pass filters (padded with duplicates)
+//
+// Kept out of V_Core so that the savestate layout doesn't change.  Rebuilt by
+// UpdateReverbTaps whenever RevBuffers changes (and after a savestate is loaded).
+
+enum ReverbTap {
+    Tap_SameSrc,
+    Tap_DiffSrc,
+    Tap_SamePrv,
+    Tap_DiffPrv,
+    Tap_Comb1,
+    Tap_Comb2,
+    Tap_Comb3,
+    Tap_Comb4,
+    Tap_SameDst,
+    Tap_DiffDst,
+    Tap_Apf1Dst,
+    Tap_Apf2Dst,
+    Tap_Apf1Src,
+    Tap_Apf2Src,
+    Tap_Count = 16
+};
+
+struct ReverbTaps
 {
-    u32 pos = ReverbX + offset;
+    __aligned16 s32 addr[2][Tap_Count];
+};
 
-    // Fast and simple single step wrapping, made possible by the preparation of the
-    // effects buffer addresses.
+static ReverbTaps reverb_taps[2];
 
-    if (pos > EffectsEndA) {
-        pos -= EffectsEndA + 1;
-        pos += EffectsStartA;
+void V_Core::UpdateReverbTaps()
+{
+    for (int r = 0; r < 2; r++) {
+        const bool R = r != 0;
+        s32 *taps = reverb_taps[Index].addr[r];
+
+        taps[Tap_SameSrc] = R ? RevBuffers.SAME_R_SRC : RevBuffers.SAME_L_SRC;
+        taps[Tap_DiffSrc] = R ? RevBuffers.DIFF_L_SRC : RevBuffers.DIFF_R_SRC;
+        taps[Tap_SamePrv] = R ? RevBuffers.SAME_R_PRV : RevBuffers.SAME_L_PRV;
+        taps[Tap_DiffPrv] = R ? RevBuffers.DIFF_R_PRV : RevBuffers.DIFF_L_PRV;
+
+        taps[Tap_Comb1] = R ? RevBuffers.COMB1_R_SRC : RevBuffers.COMB1_L_SRC;
+        taps[Tap_Comb2] = R ? RevBuffers.COMB2_R_SRC : RevBuffers.COMB2_L_SRC;
+        taps[Tap_Comb3] = R ? RevBuffers.COMB3_R_SRC : RevBuffers.COMB3_L_SRC;
+        taps[Tap_Comb4] = R ? RevBuffers.COMB4_R_SRC : RevBuffers.COMB4_L_SRC;
+
+        taps[Tap_SameDst] = R ? RevBuffers.SAME_R_DST : RevBuffers.SAME_L_DST;
+        taps[Tap_DiffDst] = R ? RevBuffers.DIFF_R_DST : RevBuffers.DIFF_L_DST;
+        taps[Tap_Apf1Dst] = R ? RevBuffers.APF1_R_DST : RevBuffers.APF1_L_DST;
+        taps[Tap_Apf2Dst] = R ? RevBuffers.APF2_R_DST : RevBuffers.APF2_L_DST;
+
+        taps[Tap_Apf1Src] = R ? RevBuffers.APF1_R_SRC : RevBuffers.APF1_L_SRC;
+        taps[Tap_Apf2Src] = R ? RevBuffers.APF2_R_SRC : RevBuffers.APF2_L_SRC;
+        taps[Tap_Apf2Src + 1] = taps[Tap_Apf1Src];
+        taps[Tap_Apf2Src + 2] = taps[Tap_Apf2Src];
     }
-
-    assert(pos >= EffectsStartA && pos <= EffectsEndA);
-    return pos;
 }
 
 void V_Core::Reverb_AdvanceBuffer()
@@ -56,24 +109,25 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
     bool R = Cycles & 1;
 
     // Calculate the read/write addresses we'll be needing for this session of reverb.
+    // Fast and simple single step wrapping, made possible by the preparation of the
+    // effects buffer addresses.  (all of them are well below 2^31, so the signed compare
+    // is fine)
 
-    const u32 same_src = RevbGetIndexer(R ? RevBuffers.SAME_R_SRC : RevBuffers.SAME_L_SRC);
-    const u32 same_dst = RevbGetIndexer(R ? RevBuffers.SAME_R_DST : RevBuffers.SAME_L_DST);
-    const u32 same_prv = RevbGetIndexer(R ? RevBuffers.SAME_R_PRV : RevBuffers.SAME_L_PRV);
+    const __m128i *taps = (const __m128i *)reverb_taps[Index].addr[R];
 
-    const u32 diff_src = RevbGetIndexer(R ? RevBuffers.DIFF_L_SRC : RevBuffers.DIFF_R_SRC);
-    const u32 diff_dst = RevbGetIndexer(R ? RevBuffers.DIFF_R_DST : RevBuffers.DIFF_L_DST);
-    const u32 diff_prv = RevbGetIndexer(R ? RevBuffers.DIFF_R_PRV : RevBuffers.DIFF_L_PRV);
+    const __m128i pos = _mm_set1_epi32(ReverbX);
+    const __m128i end = _mm_set1_epi32(EffectsEndA);
+    const __m128i wrap = _mm_set1_epi32(EffectsEndA + 1 - EffectsStartA);
 
-    const u32 comb1_src = RevbGetIndexer(R ? RevBuffers.COMB1_R_SRC : RevBuffers.COMB1_L_SRC);
-    const u32 comb2_src = RevbGetIndexer(R ? RevBuffers.COMB2_R_SRC : RevBuffers.COMB2_L_SRC);
-    const u32 comb3_src = RevbGetIndexer(R ? RevBuffers.COMB3_R_SRC : RevBuffers.COMB3_L_SRC);
-    const u32 comb4_src = RevbGetIndexer(R ? RevBuffers.COMB4_R_SRC : RevBuffers.COMB4_L_SRC);
+    __m128i addr[4];
+    for (int i = 0; i < 4; i++) {
+        const __m128i a = _mm_add_epi32(_mm_load_si128(taps + i), pos);
+        addr[i] = _mm_sub_epi32(a, _mm_and_si128(_mm_cmpgt_epi32(a, end), wrap));
+    }
 
-    const u32 apf1_src = RevbGetIndexer(R ? RevBuffers.APF1_R_SRC : RevBuffers.APF1_L_SRC);
-    const u32 apf1_dst = RevbGetIndexer(R ? RevBuffers.APF1_R_DST : RevBuffers.APF1_L_DST);
-    const u32 apf2_src = RevbGetIndexer(R ? RevBuffers.APF2_R_SRC : RevBuffers.APF2_L_SRC);
-    const u32 apf2_dst = RevbGetIndexer(R ? RevBuffers.APF2_R_DST : RevBuffers.APF2_L_DST);
+    __aligned16 s32 tap[Tap_Count];
+    for (int i = 0; i < 4; i++)
+        _mm_store_si128((__m128i *)tap + i, addr[i]);
 
     // -----------------------------------------
     //          Optimized IRQ Testing !
@@ -86,15 +140,12 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
 
     for (int i = 0; i < 2; i++) {
         if (Cores[i].IRQEnable && ((Cores[i].IRQA >= EffectsStartA) && (Cores[i].IRQA <= EffectsEndA))) {
-            if ((Cores[i].IRQA == same_src) || (Cores[i].IRQA == diff_src) ||
-                (Cores[i].IRQA == same_dst) || (Cores[i].IRQA == diff_dst) ||
-                (Cores[i].IRQA == same_prv) || (Cores[i].IRQA == diff_prv) ||
-
-                (Cores[i].IRQA == comb1_src) || (Cores[i].IRQA == comb2_src) ||
-                (Cores[i].IRQA == comb3_src) || (Cores[i].IRQA == comb4_src) ||
+            const __m128i irqa = _mm_set1_epi32(Cores[i].IRQA);
+            const __m128i hit = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(addr[0], irqa), _mm_cmpeq_epi32(addr[1], irqa)),
+                _mm_or_si128(_mm_cmpeq_epi32(addr[2], irqa), _mm_cmpeq_epi32(addr[3], irqa)));
 
-                (Cores[i].IRQA == apf1_dst) || (Cores[i].IRQA == apf1_src) ||
-                (Cores[i].IRQA == apf2_dst) || (Cores[i].IRQA == apf2_src)) {
+            if (_mm_movemask_epi8(hit)) {
                 //printf("Core %d IRQ Called (Reverb). IRQA = %x\n",i,addr);
                 SetIrqCall(i);
             }
@@ -103,28 +154,49 @@ StereoOut32 V_Core::DoReverb(const StereoOut32 &Input)
 
     // Reverb algorithm pretty much directly ripped from http://drhell.web.fc2.com/ps1/
     // minus the 35 step FIR which just seems to break things.
-
-    s32 in, same, diff, apf1, apf2, out;
+    //
+    // The IIR and comb stages are done on four lanes.  Buffer samples and volumes both fit
+    // 16 bits, so pmaddwd (with the volume's upper half zeroed) gives the exact products;
+    // the IIR input doesn't, so it goes through MulLo32 (the low 32 bits, as the scalar
+    // multiply would give).  The all-pass chain is serial and stays scalar.
 
 #define MUL(x, y) ((x) * (y) >> 15)
-    in = MUL(R ? Revb.IN_COEF_R : Revb.IN_COEF_L, R ? Input.Right : Input.Left);
+#define GATHER(a, b, c, d) _mm_setr_epi32(_spu2mem[tap[a]], _spu2mem[tap[b]], _spu2mem[tap[c]], _spu2mem[tap[d]])
+
+    const __m128i iir_src = GATHER(Tap_SameSrc, Tap_DiffSrc, Tap_SamePrv, Tap_DiffPrv);
+    const __m128i comb_src = GATHER(Tap_Comb1, Tap_Comb2, Tap_Comb3, Tap_Comb4);
+    const s32 apf1_src = _spu2mem[tap[Tap_Apf1Src]];
+    const s32 apf2_src = _spu2mem[tap[Tap_Apf2Src]];
+
+#undef GATHER
 
-    same = MUL(Revb.IIR_VOL, in + MUL(Revb.WALL_VOL, _spu2mem[same_src]) - _spu2mem[same_prv]) + _spu2mem[same_prv];
-    diff = MUL(Revb.IIR_VOL, in + MUL(Revb.WALL_VOL, _spu2mem[diff_src]) - _spu2mem[diff_prv]) + _spu2mem[diff_prv];
+    const s32 in = MUL(R ? Revb.IN_COEF_R : Revb.IN_COEF_L, R ? Input.Right : Input.Left);
 
-    out = MUL(Revb.COMB1_VOL, _spu2mem[comb1_src]) + MUL(Revb.COMB2_VOL, _spu2mem[comb2_src]) + MUL(Revb.COMB3_VOL, _spu2mem[comb3_src]) + MUL(Revb.COMB4_VOL, _spu2mem[comb4_src]);
+    // same, diff (lanes 0 and 1)
+    const __m128i prv = _mm_shuffle_epi32(iir_src, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m128i wall = _mm_srai_epi32(_mm_madd_epi16(iir_src, _mm_set1_epi32((u16)Revb.WALL_VOL)), 15);
+    const __m128i iir_in = _mm_sub_epi32(_mm_add_epi32(_mm_set1_epi32(in), wall), prv);
+    const __m128i iir = _mm_add_epi32(_mm_srai_epi32(MulLo32(_mm_set1_epi32(Revb.IIR_VOL), iir_in), 15), prv);
 
-    apf1 = out - MUL(Revb.APF1_VOL, _spu2mem[apf1_src]);
-    out = _spu2mem[apf1_src] + MUL(Revb.APF1_VOL, apf1);
-    apf2 = out - MUL(Revb.APF2_VOL, _spu2mem[apf2_src]);
-    out = _spu2mem[apf2_src] + MUL(Revb.APF2_VOL, apf2);
+    const __m128i comb_vol = _mm_setr_epi32((u16)Revb.COMB1_VOL, (u16)Revb.COMB2_VOL, (u16)Revb.COMB3_VOL, (u16)Revb.COMB4_VOL);
+    s32 out = HorizontalSum(_mm_srai_epi32(_mm_madd_epi16(comb_src, comb_vol), 15));
+
+    const s32 apf1 = out - MUL(Revb.APF1_VOL, apf1_src);
+    out = apf1_src + MUL(Revb.APF1_VOL, apf1);
+    const s32 apf2 = out - MUL(Revb.APF2_VOL, apf2_src);
+    out = apf2_src + MUL(Revb.APF2_VOL, apf2);
+
+#undef MUL
 
     // According to no$psx the effects always run but don't always write back, see check in V_Core::Mix
     if (FxEnable) {
-        _spu2mem[same_dst] = clamp_mix(same);
-        _spu2mem[diff_dst] = clamp_mix(diff);
-        _spu2mem[apf1_dst] = clamp_mix(apf1);
-        _spu2mem[apf2_dst] = clamp_mix(apf2);
+        // Saturating pack, same as clamp_mix: same, diff, apf1, apf2
+        const __m128i result = _mm_packs_epi32(_mm_unpacklo_epi64(iir, _mm_setr_epi32(apf1, apf2, 0, 0)), _mm_setzero_si128());
+
+        _spu2mem[tap[Tap_SameDst]] = (s16)_mm_extract_epi16(result, 0);
+        _spu2mem[tap[Tap_DiffDst]] = (s16)_mm_extract_epi16(result, 1);
+        _spu2mem[tap[Tap_Apf1Dst]] = (s16)_mm_extract_epi16(result, 2);
+        _spu2mem[tap[Tap_Apf2Dst]] = (s16)_mm_extract_epi16(result, 3);
     }
 
     (R ? LastEffect.Right : LastEffect.Left) = -clamp_mix(out);
@@ -16,6 +16,8 @@
  */
 
 #include "Global.h"
+#include "Spu2replay.h"
+#include "Utilities/Threading.h"
 
 
 StereoOut32 StereoOut32::Empty(0, 0);
@@ -421,6 +423,21 @@ void SndBuffer::ClearContents()
     SndBuffer::ssFreeze = 256; //Delays sound output for about 1 second.
 }
 
+// Null output of the headless replay benchmark: the output is checksummed, and still goes
+// through the timestretcher so that its cost is measured as well.
+void SndBuffer::_BenchWrite(const StereoOut32 &Sample)
+{
+    s2r_bench_output(Sample);
+
+    sndTempBuffer[sndTempProgress++] = Sample;
+    if (sndTempProgress < SndOutPacketSize)
+        return;
+    sndTempProgress = 0;
+
+    MixStageTimer timer(MixStage_TimeStretch);
+    timeStretchBench();
+}
+
 void SndBuffer::Write(const StereoOut32 &Sample)
 {
     // Log final output to wavefile.
@@ -429,8 +446,11 @@ void SndBuffer::Write(const StereoOut32 &Sample)
     if (WavRecordEnabled)
         RecordWrite(Sample.DownSample());
 
-    if (mods[OutputModule] == &NullOut) // null output doesn't need buffering or stretching! :p
+    if (mods[OutputModule] == &NullOut) { // null output doesn't need buffering or stretching! :p
+        if (MixProfiling)
+            _BenchWrite(Sample);
         return;
+    }
 
     sndTempBuffer[sndTempProgress++] = Sample;
 
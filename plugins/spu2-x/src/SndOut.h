@@ -596,6 +596,7 @@ private:
     static void soundtouchClearContents();
     static void soundtouchCleanup();
     static void timeStretchWrite();
+    static void timeStretchBench();
     static void timeStretchUnderrun();
     static s32 timeStretchOverrun();
 
@@ -615,6 +616,8 @@ private:
 
     static int _GetApproximateDataInBuffer();
 
+    static void _BenchWrite(const StereoOut32 &Sample);
+
 public:
     static void UpdateTempoChangeAsyncMixing();
     static void Init();
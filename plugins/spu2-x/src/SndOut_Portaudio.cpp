@@ -19,6 +19,7 @@
 
 #define _WIN32_DCOM
 #include "Dialogs.h"
+#include "Utilities/Threading.h"
 
 #include "portaudio.h"
 
@@ -108,6 +109,7 @@ private:
 
 public:
     SampleReader *ActualPaCallback;
+    bool ThreadNamed;
 
     Portaudio()
     {
@@ -117,6 +119,7 @@ public:
         started = false;
         stream = NULL;
         ActualPaCallback = NULL;
+        ThreadNamed = false;
         m_ApiId = -1;
         m_SuggestedLatencyMS = 20;
         actualUsedChannels = 0;
@@ -290,6 +293,8 @@ public:
             return -1;
         }
 
+        ThreadNamed = false;
+
         err = Pa_StartStream(stream);
         if (err != paNoError) {
             fprintf(stderr, "* SPU2-X: PortAudio error: %s\n", Pa_GetErrorText(err));
@@ -673,6 +678,13 @@ int PaCallback(const void *inputBuffer, void *outputBuffer,
                PaStreamCallbackFlags statusFlags,
                void *userData)
 {
+    // The callback runs on the stream's own thread, started by Pa_StartStream. Name it for
+    // debuggers and the emulator's thread placement.
+    if (!PA.ThreadNamed) {
+        Threading::SetNameOfCurrentThread("SPU2 output");
+        PA.ThreadNamed = true;
+    }
+
     return PA.ActualPaCallback->ReadSamples(inputBuffer, outputBuffer, framesPerBuffer, timeInfo, statusFlags, userData);
 }
 
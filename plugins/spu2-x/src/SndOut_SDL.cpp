@@ -19,6 +19,7 @@
 #include "Global.h"
 #include "SndOut.h"
 #include "Dialogs.h"
+#include "Utilities/Threading.h"
 
 #include <memory>
 
@@ -45,10 +46,19 @@ Uint16 samples = desiredSamples;
 
 std::unique_ptr<StereoOut_SDL[]> buffer;
 
+bool thread_named = false;
+
 void callback_fillBuffer(void *userdata, Uint8 *stream, int len)
 {
     Uint16 sdl_samples = samples;
 
+    // The callback runs on SDL's own audio thread, started by SDL_OpenAudio. Name it for
+    // debuggers and the emulator's thread placement.
+    if (!thread_named) {
+        Threading::SetNameOfCurrentThread("SPU2 output");
+        thread_named = true;
+    }
+
 #if SDL_MAJOR_VERSION >= 2
     memset(stream, 0, len);
     // As of SDL 2.0.4 the buffer is too small to contains all samples
@@ -100,6 +110,8 @@ struct SDLAudioMod : public SndOutModule
         }
 #endif
 
+        thread_named = false;
+
         if (SDL_OpenAudio(&spec, NULL) < 0) {
             std::cerr << "SPU2-X: SDL audio error: " << SDL_GetError() << std::endl;
             return -1;
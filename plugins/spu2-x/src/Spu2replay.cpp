@@ -19,6 +19,9 @@
 #include "Global.h"
 #include "PS2E-spu2.h"
 
+#include <chrono>
+#include <vector>
+
 #ifdef _MSC_VER
 #include "Windows.h"
 #endif
@@ -113,6 +116,239 @@ double HighResScale;
 
 bool Running = false;
 
+void dummy1()
+{
+}
+
+void dummy4()
+{
+    SPU2interruptDMA4();
+}
+
+void dummy7()
+{
+    SPU2interruptDMA7();
+}
+
+///////////////////////////////////////////////////////////////
+// headless replay benchmark
+//
+// Replays a log as fast as possible through the null output, for each interpolation
+// mode, and reports the mixing speed, the time spent in each stage of the mixer and a
+// checksum of the output.  The output only depends on the log and the interpolation
+// mode (the settings which change it are forced to their defaults), so the checksum
+// can be compared between builds to check that mixer optimizations are exact.
+//
+// The log is replayed with the IOP clock jumping from one event to the next: that
+// changes how the mixing is split between SPU2async calls, but not what's mixed.
+
+static const char *const InterpolationNames[] = {"Nearest", "Linear", "Cubic", "Hermite", "Catmull-Rom"};
+
+static u64 bench_hash;
+static u64 bench_samples;
+
+void s2r_bench_output(const StereoOut32 &sample)
+{
+    // FNV-1a
+    bench_hash ^= (u32)sample.Left;
+    bench_hash *= 0x100000001b3ULL;
+    bench_hash ^= (u32)sample.Right;
+    bench_hash *= 0x100000001b3ULL;
+
+    bench_samples++;
+}
+
+struct s2r_bench_result
+{
+    u64 hash;
+    u64 samples;
+    u32 events;
+    double seconds;
+    u64 ticks;
+    u64 stage_ticks[MixStage_Count];
+};
+
+// Returns false if the log is broken, the result is still valid up to that point.
+static bool s2r_bench_pass(const std::vector<u8> &log, int interpolation, s2r_bench_result &result)
+{
+    bool ok = true;
+
+    replay_mode = true;
+
+    SPU2init();
+
+    Interpolation = interpolation;
+    EffectsDisabled = false;
+    postprocess_filter_dealias = false;
+    FinalVolume = 1.0f;
+    SynchMode = 0;
+    OutputModule = FindOutputModuleById(L"nullout");
+
+    u32 clock = 0;
+
+    SPU2irqCallback(dummy1, dummy4, dummy7);
+    SPU2setClockPtr(&clock);
+    SPU2open(NULL);
+    MixResetState();
+
+    memset(MixStageTicks, 0, sizeof(MixStageTicks));
+    bench_hash = 0xcbf29ce484222325ULL;
+    bench_samples = 0;
+    result.events = 0;
+
+    MixProfiling = true;
+    const auto start = std::chrono::steady_clock::now();
+    const u64 start_ticks = __rdtsc();
+
+    u32 ticks;
+    memcpy(&ticks, log.data(), 4);
+
+    size_t pos = 4;
+    while (pos + 8 <= log.size()) {
+        u32 ccycle, sval;
+        memcpy(&ccycle, &log[pos], 4);
+        memcpy(&sval, &log[pos + 4], 4);
+        pos += 8;
+
+        const u32 evid = sval >> 29;
+        sval &= 0x1FFFFFFF;
+
+        // Mix up to the event, in steps short enough for TimeUpdate's sanity check.
+        if ((s32)(ccycle - ticks) > 0) {
+            u64 delta = (u64)(ccycle - ticks) * 768;
+            while (delta > 0) {
+                const u32 step = (u32)std::min<u64>(delta, 768 * 1024);
+                clock += step;
+                delta -= step;
+                SPU2async(0);
+            }
+            ticks = ccycle;
+        }
+
+        if (evid == 0) {
+            SPU2read(sval);
+        } else if (evid == 1 && pos + 2 <= log.size()) {
+            u16 tval;
+            memcpy(&tval, &log[pos], 2);
+            pos += 2;
+            SPU2write(sval, tval);
+        } else if ((evid == 2 || evid == 3) && sval <= ArraySize(dmabuffer) && pos + sval * 2 <= log.size()) {
+            memcpy(dmabuffer, &log[pos], sval * 2);
+            pos += sval * 2;
+            if (evid == 2)
+                SPU2writeDMA4Mem(dmabuffer, sval);
+            else
+                SPU2writeDMA7Mem(dmabuffer, sval);
+        } else {
+            ok = false;
+            break;
+        }
+
+        result.events++;
+    }
+
+    result.ticks = __rdtsc() - start_ticks;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    MixProfiling = false;
+
+    result.hash = bench_hash;
+    result.samples = bench_samples;
+    memcpy(result.stage_ticks, MixStageTicks, sizeof(MixStageTicks));
+
+    SPU2close();
+    SPU2shutdown();
+    SPU2setClockPtr(NULL);
+
+    replay_mode = false;
+    return ok;
+}
+
+// interpolation: the mode to bench, or -1 for all of them.
+EXPORT_C_(s32)
+SPU2replayHeadless(const char *filename, int interpolation, int passes)
+{
+    std::vector<u8> log;
+    {
+        FILE *file = fopen(filename, "rb");
+        if (!file) {
+            fprintf(stderr, "SPU2 bench: can't open '%s'\n", filename);
+            return -1;
+        }
+
+        fseek(file, 0, SEEK_END);
+        log.resize(ftell(file));
+        fseek(file, 0, SEEK_SET);
+
+        const bool read = log.size() >= 4 && fread(log.data(), 1, log.size(), file) == log.size();
+        fclose(file);
+
+        if (!read) {
+            fprintf(stderr, "SPU2 bench: can't read '%s'\n", filename);
+            return -1;
+        }
+    }
+
+    if (interpolation >= (int)ArraySize(InterpolationNames)) {
+        fprintf(stderr, "SPU2 bench: unknown interpolation mode %d\n", interpolation);
+        return -1;
+    }
+
+    passes = std::max(passes, 1);
+
+    const int first = interpolation < 0 ? 0 : interpolation;
+    const int last = interpolation < 0 ? (int)ArraySize(InterpolationNames) - 1 : interpolation;
+
+    s32 ret = 0;
+
+    for (int mode = first; mode <= last; mode++) {
+        s2r_bench_result result, total;
+        memset(&total, 0, sizeof(total));
+        bool deterministic = true;
+
+        for (int pass = 0; pass < passes; pass++) {
+            if (!s2r_bench_pass(log, mode, result)) {
+                if (pass == 0 && mode == first)
+                    fprintf(stderr, "SPU2 bench: '%s' is truncated or broken after %u events\n", filename, result.events);
+                ret = -1;
+            }
+
+            if (pass == 0)
+                total.hash = result.hash;
+            deterministic &= result.hash == total.hash;
+
+            total.samples += result.samples;
+            total.seconds += result.seconds;
+            total.ticks += result.ticks;
+            for (int i = 0; i < MixStage_Count; i++)
+                total.stage_ticks[i] += result.stage_ticks[i];
+        }
+
+        if (mode == first)
+            fprintf(stderr, "SPU2 bench: %u events, %.1f s of audio\n", result.events, result.samples / 48000.0);
+
+        // TSC ticks to ms per pass
+        const double scale = total.ticks ? total.seconds * 1000.0 / total.ticks / passes : 0;
+        const double decode = total.stage_ticks[MixStage_Decode] * scale;
+        const double adsr = total.stage_ticks[MixStage_ADSR] * scale;
+        const double voices = total.stage_ticks[MixStage_Voices] * scale - decode;
+        const double reverb = total.stage_ticks[MixStage_Reverb] * scale;
+        const double stretch = total.stage_ticks[MixStage_TimeStretch] * scale;
+        const double pass = total.seconds * 1000.0 / passes;
+
+        fprintf(stderr, "SPU2 bench: %-11s %9.1f ms/pass %10.0f samples/s (%5.1fx realtime)  output %016llx%s\n",
+                InterpolationNames[mode], pass, total.seconds > 0 ? total.samples / total.seconds : 0,
+                total.seconds > 0 ? total.samples / 48000.0 / total.seconds : 0,
+                (unsigned long long)total.hash, deterministic ? "" : " (differs between passes!)");
+        fprintf(stderr, "            decode %.1f ms, adsr %.1f ms, voices %.1f ms, reverb %.1f ms, timestretch %.1f ms, other %.1f ms\n",
+                decode, adsr, voices, reverb, stretch, pass - decode - adsr - voices - reverb - stretch);
+
+        if (!deterministic)
+            ret = -1;
+    }
+
+    return ret;
+}
+
 #ifdef _MSC_VER
 
 int conprintf(const char *fmt, ...)
@@ -143,20 +379,6 @@ int conprintf(const char *fmt, ...)
 #endif
 }
 
-void dummy1()
-{
-}
-
-void dummy4()
-{
-    SPU2interruptDMA4();
-}
-
-void dummy7()
-{
-    SPU2interruptDMA7();
-}
-
 u64 HighResFrequency()
 {
     u64 freq;
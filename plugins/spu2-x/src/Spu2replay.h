@@ -29,3 +29,6 @@ void s2r_writedma7(u32 ticks, u16 *data, u32 len);
 void s2r_close();
 
 extern bool replay_mode;
+
+// headless replay benchmark
+void s2r_bench_output(const StereoOut32 &sample);
@@ -494,6 +494,20 @@ void SndBuffer::timeStretchWrite()
 #endif
 }
 
+// Same work as timeStretchWrite at a constant tempo, with the output thrown away.
+void SndBuffer::timeStretchBench()
+{
+    CvtPacketToFloat(sndTempBuffer);
+
+    pSoundTouch->putSamples((float *)sndTempBuffer, SndOutPacketSize);
+
+    int tempProgress;
+    while (tempProgress = pSoundTouch->receiveSamples((float *)sndTempBuffer, SndOutPacketSize),
+           tempProgress != 0) {
+        CvtPacketToInt(sndTempBuffer, tempProgress);
+    }
+}
+
 void SndBuffer::soundtouchInit()
 {
     pSoundTouch = new soundtouch::SoundTouch();
@@ -467,6 +467,7 @@ struct V_Core
 
     void Init(int index);
     void UpdateEffectsBufferSize();
+    void UpdateReverbTaps();
     void AnalyzeReverbPreset();
 
     s32 EffectsBufferIndexer(s32 offset) const;
@@ -481,7 +482,6 @@ struct V_Core
     StereoOut32 Mix(const VoiceMixSet &inVoices, const StereoOut32 &Input, const StereoOut32 &Ext);
     void Reverb_AdvanceBuffer();
     StereoOut32 DoReverb(const StereoOut32 &Input);
-    s32 RevbGetIndexer(s32 offset);
 
     StereoOut32 ReadInput();
     StereoOut32 ReadInput_HiFi();
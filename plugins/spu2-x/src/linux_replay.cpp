@@ -0,0 +1,88 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headless benchmark of the mixer: replays a .s2r register log (recorded by a build
+// with S2R_ENABLE) through the null output, see SPU2replayHeadless.
+
+#include <dlfcn.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+static void *handle;
+
+void help()
+{
+    fprintf(stderr, "SPU2-X register log benchmark\n");
+    fprintf(stderr, "[--interpolation N] [--passes N] ARG1 ARG2 [ARG3]\n");
+    fprintf(stderr, "ARG1 SPU2-X plugin\n");
+    fprintf(stderr, "ARG2 .s2r file\n");
+    fprintf(stderr, "ARG3 Ini directory\n");
+    fprintf(stderr, "  --interpolation 0-4 benches a single mode, all of them by default\n");
+    if (handle) {
+        dlclose(handle);
+    }
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    int interpolation = -1;
+    int passes = 1;
+
+    int i = 1;
+    for (; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+        if (i + 1 >= argc)
+            help();
+
+        if (strcmp(argv[i], "--interpolation") == 0) {
+            interpolation = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--passes") == 0) {
+            passes = atoi(argv[++i]);
+        } else {
+            help();
+        }
+    }
+
+    if (argc - i < 2)
+        help();
+
+    handle = dlopen(argv[i], RTLD_LAZY | RTLD_LOCAL);
+    if (handle == NULL) {
+        fprintf(stderr, "Failed to dlopen plugin %s (%s)\n", argv[i], dlerror());
+        help();
+    }
+
+    __attribute__((stdcall)) void (*SPU2setSettingsDir_ptr)(const char *);
+    __attribute__((stdcall)) int (*SPU2replayHeadless_ptr)(const char *, int, int);
+
+    SPU2setSettingsDir_ptr = reinterpret_cast<decltype(SPU2setSettingsDir_ptr)>(dlsym(handle, "SPU2setSettingsDir"));
+    SPU2replayHeadless_ptr = reinterpret_cast<decltype(SPU2replayHeadless_ptr)>(dlsym(handle, "SPU2replayHeadless"));
+
+    if (SPU2replayHeadless_ptr == NULL) {
+        fprintf(stderr, "Plugin %s doesn't support headless replay\n", argv[i]);
+        help();
+    }
+
+    if (argc - i > 2 && SPU2setSettingsDir_ptr)
+        SPU2setSettingsDir_ptr(argv[i + 2]);
+
+    int ret = SPU2replayHeadless_ptr(argv[i + 1], interpolation, passes) != 0 ? 1 : 0;
+
+    dlclose(handle);
+    handle = NULL;
+
+    return ret;
+}
@@ -129,6 +129,9 @@ s32 __fastcall Savestate::ThawIt(DataBlock &spud)
                 const int cacheIdx = Cores[c].Voices[v].NextA / pcm_WordsPerBlock;
                 Cores[c].Voices[v].SBuffer = pcm_cache_data[cacheIdx].Sampledata;
             }
+
+            // The reverb taps aren't part of the savestate, rebuild them from RevBuffers.
+            Cores[c].UpdateReverbTaps();
         }
 
         // HACKFIX!! DMAPtr can be invalid after a savestate load, so force it to NULL and
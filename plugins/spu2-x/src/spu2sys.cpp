@@ -322,6 +322,8 @@ void V_Core::UpdateEffectsBufferSize()
     RevBuffers.APF1_R_SRC = EffectsBufferIndexer(Revb.APF1_R_DST - Revb.APF1_SIZE);
     RevBuffers.APF2_L_SRC = EffectsBufferIndexer(Revb.APF2_L_DST - Revb.APF2_SIZE);
     RevBuffers.APF2_R_SRC = EffectsBufferIndexer(Revb.APF2_R_DST - Revb.APF2_SIZE);
+
+    UpdateReverbTaps();
 }
 
 void V_Voice::QueueStart()